@@ -0,0 +1,361 @@
+#include "Archive.hpp"
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * 64-bit file positioning, long is 32 bits on Windows.
+*/
+static int seekTo(FILE* pFile, std::uint64_t offset, int origin = SEEK_SET)
+{
+#ifdef _WIN32
+    return _fseeki64(pFile, (long long)offset, origin);
+#else
+    return fseeko(pFile, (off_t)offset, origin);
+#endif
+}
+
+static std::uint64_t tellPosition(FILE* pFile)
+{
+#ifdef _WIN32
+    return _ftelli64(pFile);
+#else
+    return ftello(pFile);
+#endif
+}
+
+/**
+ * Writes buffered data of @param pFile through to the disk.
+*/
+static int syncFile(FILE* pFile)
+{
+    if(fflush(pFile)) {
+        return -1;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(pFile));
+#else
+    return fsync(fileno(pFile));
+#endif
+}
+
+/**
+ *
+ * Archive writer
+*/
+ArchiveWriter::ArchiveWriter() {}
+
+ArchiveWriter::~ArchiveWriter()
+{
+    close();
+}
+
+/**
+ * Opens archive @param fileName for appending. New archive is created if the file does not exist. Incomplete
+ * record at the end of an archive that was not closed is cut off, all complete frames are kept.
+*/
+STATUS_t ArchiveWriter::open(const char* fileName)
+{
+    RETURN_ON_FAILURE(close())
+    m_index.clear();
+
+    m_pFile = fopen(fileName, "r+b");
+    if(m_pFile) {
+        STATUS_t status = ArchiveReader::readIndex(m_pFile, m_index, m_end);
+        if(!status && seekTo(m_pFile, 0, SEEK_END)) {
+            status = BASE_ARCHIVE_INVALID;
+        }
+        if(!status && tellPosition(m_pFile) != m_end) {
+            fclose(m_pFile);
+            std::error_code error;
+            std::filesystem::resize_file(fileName, m_end, error);
+            m_pFile = error ? nullptr : fopen(fileName, "r+b");
+            status  = m_pFile ? BASE_SUCCESS : BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        if(status && m_pFile) {
+            fclose(m_pFile);
+            m_pFile = nullptr;
+        }
+        return status;
+    }
+
+    m_pFile = fopen(fileName, "w+b");
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    std::uint8_t header[OMLS_ARCHIVE_HEADER_SIZE] = {};
+    std::uint32_t version                         = OMLS_ARCHIVE_VERSION;
+    memcpy(header, OMLS_ARCHIVE_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE);
+    memcpy(header + OMLS_ARCHIVE_MAGIC_SIZE, &version, sizeof(version));
+    if(fwrite(header, 1, sizeof(header), m_pFile) != sizeof(header)) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    m_end = OMLS_ARCHIVE_HEADER_SIZE;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Writes @param record followed by @param size bytes of @param data at the end of the archive.
+*/
+STATUS_t ArchiveWriter::writeRecord(const archiveRecord_t& record, const void* data, std::size_t size)
+{
+    if(seekTo(m_pFile, m_end) || fwrite(&record, sizeof(record), 1, m_pFile) != 1
+       || fwrite(data, 1, size, m_pFile) != size) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    m_end += sizeof(record) + size;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Appends compressed frame @param data of @param size bytes as @param frameId. Timestamp and image info
+ * for the index are taken from the frame header.
+*/
+STATUS_t ArchiveWriter::append(std::uint64_t frameId, const std::uint8_t* data, std::size_t size)
+{
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    headerData_t header;
+    RETURN_ON_FAILURE(Reader::getHeader(data, size, header))
+
+    archiveRecord_t record{};
+    memcpy(record.magic, OMLS_ARCHIVE_FRAME_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE);
+    record.size           = size;
+    archiveEntry_t& entry = record.entry;
+    entry.frameId         = frameId;
+    entry.timestamp       = header.timestamp;
+    entry.offset          = m_end + sizeof(record);
+    entry.size            = size;
+    entry.width           = header.width;
+    entry.height          = header.height;
+    entry.flags           = header.flags;
+    entry.headerSize      = header.headerSize;
+    entry.bpp             = header.bpp;
+    entry.lossyBits       = header.lossyBits;
+    RETURN_ON_FAILURE(writeRecord(record, data, size))
+    if(fflush(m_pFile)) {   // frame survives a crash of the writer
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    m_index.push_back(entry);
+    return BASE_SUCCESS;
+}
+
+/**
+ * Writes index and trailer after the last frame, syncs and closes the file.
+*/
+STATUS_t ArchiveWriter::close()
+{
+    if(!m_pFile) {
+        return BASE_SUCCESS;
+    }
+    archiveRecord_t record{};
+    memcpy(record.magic, OMLS_ARCHIVE_INDEX_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE);
+    record.size = m_index.size() * sizeof(archiveEntry_t) + sizeof(archiveTrailer_t);
+
+    archiveTrailer_t trailer;
+    trailer.indexOffset = m_end + sizeof(record);
+    trailer.entryCount  = m_index.size();
+    memcpy(trailer.magic, OMLS_ARCHIVE_TRAILER_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE);
+
+    STATUS_t status = writeRecord(record, m_index.data(), m_index.size() * sizeof(archiveEntry_t));
+    if(status || fwrite(&trailer, sizeof(trailer), 1, m_pFile) != 1 || syncFile(m_pFile)) {
+        status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    if(fclose(m_pFile)) {
+        status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    m_pFile = nullptr;
+    return status;
+}
+
+std::size_t ArchiveWriter::getFrameCount() const
+{
+    return m_index.size();
+}
+
+/**
+ *
+ * Archive reader
+*/
+ArchiveReader::ArchiveReader() {}
+
+ArchiveReader::~ArchiveReader()
+{
+    close();
+}
+
+/**
+ * Opens archive @param fileName and reads its index.
+*/
+STATUS_t ArchiveReader::open(const char* fileName)
+{
+    close();
+    m_pFile = fopen(fileName, "rb");
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    std::uint64_t end;
+    STATUS_t status = readIndex(m_pFile, m_index, end);
+    if(status) {
+        close();
+        return status;
+    }
+
+    m_byFrameId.reserve(m_index.size());
+    m_byTimestamp.reserve(m_index.size());
+    for(std::size_t i = 0; i < m_index.size(); i++) {
+        m_byFrameId[m_index[i].frameId]     = i;   // frame appended last wins, e.g. after recompression
+        m_byTimestamp[m_index[i].timestamp] = i;
+    }
+    return BASE_SUCCESS;
+}
+
+void ArchiveReader::close()
+{
+    if(m_pFile) {
+        fclose(m_pFile);
+        m_pFile = nullptr;
+    }
+    m_index.clear();
+    m_byFrameId.clear();
+    m_byTimestamp.clear();
+}
+
+std::size_t ArchiveReader::getFrameCount() const
+{
+    return m_index.size();
+}
+
+const archiveEntry_t& ArchiveReader::getEntry(std::size_t index) const
+{
+    return m_index[index];
+}
+
+STATUS_t ArchiveReader::findFrameId(std::uint64_t frameId, std::size_t& index) const
+{
+    auto it = m_byFrameId.find(frameId);
+    if(it == m_byFrameId.end()) {
+        return BASE_FRAME_NOT_FOUND;
+    }
+    index = it->second;
+    return BASE_SUCCESS;
+}
+
+STATUS_t ArchiveReader::findTimestamp(std::uint64_t timestamp, std::size_t& index) const
+{
+    auto it = m_byTimestamp.find(timestamp);
+    if(it == m_byTimestamp.end()) {
+        return BASE_FRAME_NOT_FOUND;
+    }
+    index = it->second;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Reads frame at @param index of the index into @param data, which is resized to the frame size.
+*/
+STATUS_t ArchiveReader::readFrame(std::size_t index, std::vector<std::uint8_t>& data)
+{
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    if(index >= m_index.size()) {
+        return BASE_FRAME_NOT_FOUND;
+    }
+    const archiveEntry_t& entry = m_index[index];
+    data.resize(entry.size);
+    if(seekTo(m_pFile, entry.offset) || fread(data.data(), 1, entry.size, m_pFile) != entry.size) {
+        return BASE_ARCHIVE_INVALID;
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Validates header of archive @param pFile and reads its @param index from the trailer. If the archive does
+ * not end with a valid trailer, the index is rebuilt with scanRecords. @param end is where the next record goes.
+*/
+STATUS_t ArchiveReader::readIndex(FILE* pFile, std::vector<archiveEntry_t>& index, std::uint64_t& end)
+{
+    std::uint8_t header[OMLS_ARCHIVE_HEADER_SIZE];
+    std::uint32_t version;
+    if(seekTo(pFile, 0) || fread(header, 1, sizeof(header), pFile) != sizeof(header)
+       || memcmp(header, OMLS_ARCHIVE_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE) != 0) {
+        return BASE_ARCHIVE_INVALID;
+    }
+    memcpy(&version, header + OMLS_ARCHIVE_MAGIC_SIZE, sizeof(version));
+    if(version != OMLS_ARCHIVE_VERSION) {
+        return BASE_ARCHIVE_INVALID;
+    }
+
+    archiveTrailer_t trailer;
+    archiveRecord_t record;
+    if(seekTo(pFile, 0, SEEK_END)) {
+        return BASE_ARCHIVE_INVALID;
+    }
+    const std::uint64_t fileSize = tellPosition(pFile);
+    if(fileSize < OMLS_ARCHIVE_HEADER_SIZE + sizeof(record) + sizeof(trailer)
+       || seekTo(pFile, fileSize - sizeof(trailer)) || fread(&trailer, sizeof(trailer), 1, pFile) != 1
+       || memcmp(trailer.magic, OMLS_ARCHIVE_TRAILER_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE) != 0) {
+        return scanRecords(pFile, index, end);
+    }
+    if(trailer.indexOffset < OMLS_ARCHIVE_HEADER_SIZE + sizeof(record)
+       || trailer.indexOffset > fileSize - sizeof(trailer)
+       || trailer.entryCount > (fileSize - sizeof(trailer) - trailer.indexOffset) / sizeof(archiveEntry_t)
+       || trailer.indexOffset + trailer.entryCount * sizeof(archiveEntry_t) + sizeof(trailer) != fileSize
+       || seekTo(pFile, trailer.indexOffset - sizeof(record)) || fread(&record, sizeof(record), 1, pFile) != 1
+       || memcmp(record.magic, OMLS_ARCHIVE_INDEX_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE) != 0) {
+        return scanRecords(pFile, index, end);
+    }
+
+    index.resize(trailer.entryCount);
+    if(fread(index.data(), sizeof(archiveEntry_t), index.size(), pFile) != index.size()) {
+        return BASE_ARCHIVE_INVALID;
+    }
+    for(const archiveEntry_t& entry : index) {
+        if(entry.offset < OMLS_ARCHIVE_HEADER_SIZE + sizeof(record) || entry.offset > trailer.indexOffset
+           || entry.size > trailer.indexOffset - entry.offset) {
+            return BASE_ARCHIVE_INVALID;
+        }
+    }
+    end = fileSize;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Rebuilds @param index of archive @param pFile from its frame records, walking from the first record to the
+ * first incomplete or unknown one, where @param end is set. Used when the archive was not closed.
+*/
+STATUS_t ArchiveReader::scanRecords(FILE* pFile, std::vector<archiveEntry_t>& index, std::uint64_t& end)
+{
+    if(seekTo(pFile, 0, SEEK_END)) {
+        return BASE_ARCHIVE_INVALID;
+    }
+    const std::uint64_t fileSize = tellPosition(pFile);
+
+    index.clear();
+    std::uint64_t offset = OMLS_ARCHIVE_HEADER_SIZE;
+    archiveRecord_t record;
+    while(offset + sizeof(record) <= fileSize) {
+        if(seekTo(pFile, offset) || fread(&record, sizeof(record), 1, pFile) != 1
+           || record.size > fileSize - offset - sizeof(record)) {
+            break;
+        }
+        if(memcmp(record.magic, OMLS_ARCHIVE_FRAME_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE) == 0) {
+            if(record.entry.offset != offset + sizeof(record) || record.entry.size != record.size) {
+                break;
+            }
+            index.push_back(record.entry);
+        } else if(memcmp(record.magic, OMLS_ARCHIVE_INDEX_MAGIC, OMLS_ARCHIVE_MAGIC_SIZE) != 0) {
+            break;
+        }
+        offset += sizeof(record) + record.size;
+    }
+    end = offset;
+    return BASE_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+/*
+* Archive of many compressed frames in one file, instead of one file per frame. All fields little-endian.
+* address : content
+*       0 : magic "\x89OMLSARC"
+*       8 : version (u32)
+*      12 : reserved (u32)
+*      16 : records, each archiveRecord_t followed by its size bytes:
+*           frame (magic "\x89OMLSFRM"): complete compressed stream (header and bitstream) as written by the encoder
+*           index (magic "\x89OMLSIDX"): one archiveEntry_t per frame in the order they were appended, then
+*           archiveTrailer_t (offset of the first entry, entry count, magic "\x89OMLSEND")
+*
+* The file is only ever appended to. close() writes an index of all frames after the last frame, so the index
+* of the previous session is left in place and stays valid until the new one is complete. A file that does not
+* end with a trailer (writer did not close, e.g. crash) is still read: the index is rebuilt from the frame
+* records, and an incomplete last record is dropped when the archive is opened for appending.
+*/
+
+#define OMLS_ARCHIVE_MAGIC "\x89OMLSARC"
+#define OMLS_ARCHIVE_FRAME_MAGIC "\x89OMLSFRM"
+#define OMLS_ARCHIVE_INDEX_MAGIC "\x89OMLSIDX"
+#define OMLS_ARCHIVE_TRAILER_MAGIC "\x89OMLSEND"
+#define OMLS_ARCHIVE_MAGIC_SIZE 8
+#define OMLS_ARCHIVE_VERSION 1
+#define OMLS_ARCHIVE_HEADER_SIZE 16
+
+/*
+* Index entry of one frame.
+*/
+struct archiveEntry_t {
+    std::uint64_t frameId;
+    std::uint64_t timestamp;   // from frame header
+    std::uint64_t offset;   // of the frame from the start of the archive
+    std::uint64_t size;   // bytes
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t flags;   // OMLS_FLAG_*
+    std::uint16_t headerSize;
+    std::uint8_t bpp;
+    std::uint8_t lossyBits;
+};
+static_assert(sizeof(archiveEntry_t) == 48, "archiveEntry_t must match the archive layout");
+
+/*
+* Header of every record. Frame records repeat their index entry, so frames can be found without the index.
+*/
+struct archiveRecord_t {
+    std::uint8_t magic[OMLS_ARCHIVE_MAGIC_SIZE];
+    std::uint64_t size;   // bytes following the record header
+    archiveEntry_t entry;   // frame records only, zero for index records
+};
+static_assert(sizeof(archiveRecord_t) == 64, "archiveRecord_t must match the archive layout");
+
+struct archiveTrailer_t {
+    std::uint64_t indexOffset;
+    std::uint64_t entryCount;
+    std::uint8_t magic[OMLS_ARCHIVE_MAGIC_SIZE];
+};
+static_assert(sizeof(archiveTrailer_t) == 24, "archiveTrailer_t must match the archive layout");
+
+/*
+* Appends compressed frames to an archive. Creates it, or continues an existing one. Every frame is flushed
+* to the file when appended, close() writes the index and syncs the file to disk.
+*/
+class ArchiveWriter
+{
+  private:
+    FILE* m_pFile = nullptr;
+    std::uint64_t m_end = 0;   // where next record goes
+    std::vector<archiveEntry_t> m_index;
+
+    STATUS_t writeRecord(const archiveRecord_t& record, const void* data, std::size_t size);
+
+  public:
+    ArchiveWriter();
+    ArchiveWriter(const ArchiveWriter&)            = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+    ~ArchiveWriter();
+
+    STATUS_t open(const char* fileName);
+    STATUS_t append(std::uint64_t frameId, const std::uint8_t* data, std::size_t size);
+    STATUS_t close();
+    std::size_t getFrameCount() const;
+};
+
+/*
+* Random access to frames of an archive. Index is read once, frames are found by position, frame id or
+* timestamp in constant time and read with a single seek.
+*/
+class ArchiveReader
+{
+  private:
+    FILE* m_pFile = nullptr;
+    std::vector<archiveEntry_t> m_index;
+    std::unordered_map<std::uint64_t, std::size_t> m_byFrameId;
+    std::unordered_map<std::uint64_t, std::size_t> m_byTimestamp;
+
+  public:
+    ArchiveReader();
+    ArchiveReader(const ArchiveReader&)            = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+    ~ArchiveReader();
+
+    STATUS_t open(const char* fileName);
+    void close();
+    std::size_t getFrameCount() const;
+    const archiveEntry_t& getEntry(std::size_t index) const;
+    STATUS_t findFrameId(std::uint64_t frameId, std::size_t& index) const;
+    STATUS_t findTimestamp(std::uint64_t timestamp, std::size_t& index) const;
+    STATUS_t readFrame(std::size_t index, std::vector<std::uint8_t>& data);
+
+    static STATUS_t readIndex(FILE* pFile, std::vector<archiveEntry_t>& index, std::uint64_t& end);
+    static STATUS_t scanRecords(FILE* pFile, std::vector<archiveEntry_t>& index, std::uint64_t& end);
+};
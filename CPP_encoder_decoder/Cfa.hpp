@@ -0,0 +1,128 @@
+#pragma once
+
+#include "globalDefines.hpp"
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+
+/*
+* CFA pattern of the sensor, named by its 2x2 quad read row by row: GBRG is Gb B / R Gr, the order the codec was
+* written for. Coding always works on (Gb, B, R, Gr) quads, the pattern only tells where in the quad each of them
+* sits. Stored in header flags (OMLS_FLAG_CFA_MASK), GBRG is 0 so streams written before it read as GBRG.
+*/
+enum class cfaPattern : std::uint8_t
+{
+    gbrg = 0,
+    rggb = 1,
+    bggr = 2,
+    grbg = 3
+};
+
+/*
+* Quad positions (0 upper left, 1 upper right, 2 lower left, 3 lower right) of Gb, B, R and Gr in pattern P.
+* Gb is the green sharing its row with blue. Everything resolves at compile time, so a loop instantiated for
+* a pattern moves samples exactly as the GBRG one does, only with other constant offsets.
+*/
+template<cfaPattern P>
+struct cfaQuad {
+    static constexpr cfaPattern pattern = P;
+
+    static constexpr std::size_t gb =
+       P == cfaPattern::gbrg ? 0 : (P == cfaPattern::rggb ? 2 : (P == cfaPattern::bggr ? 1 : 3));
+    static constexpr std::size_t b  = gb ^ 1;
+    static constexpr std::size_t r  = gb ^ 2;
+    static constexpr std::size_t gr = gb ^ 3;
+
+    /**
+     * Channel (0 Gb, 1 B, 2 R, 3 Gr) at quad position @param position.
+    */
+    static constexpr std::size_t channelAt(std::size_t position)
+    {
+        return position ^ gb;
+    }
+
+    /**
+     * Reads quad whose upper left sample is @param upper[0] and lower left @param lower[0].
+    */
+    template<typename T, typename U>
+    static inline void gather(const T* upper, const T* lower, U& sGb, U& sB, U& sR, U& sGr)
+    {
+        sGb = at(upper, lower, gb);
+        sB  = at(upper, lower, b);
+        sR  = at(upper, lower, r);
+        sGr = at(upper, lower, gr);
+    }
+
+    /**
+     * Writes quad whose upper left sample is @param upper[0] and lower left @param lower[0].
+    */
+    template<typename T, typename U>
+    static inline void scatter(T* upper, T* lower, U sGb, U sB, U sR, U sGr)
+    {
+        at(upper, lower, gb) = (T)sGb;
+        at(upper, lower, b)  = (T)sB;
+        at(upper, lower, r)  = (T)sR;
+        at(upper, lower, gr) = (T)sGr;
+    }
+
+  private:
+    template<typename T>
+    static inline T& at(T* upper, T* lower, std::size_t position)
+    {
+        return position < 2 ? upper[position] : lower[position - 2];
+    }
+};
+
+/**
+ * Calls @param f with cfaQuad of @param pattern, f is instantiated once for every pattern.
+*/
+template<typename F>
+inline decltype(auto) withCfaQuad(cfaPattern pattern, F&& f)
+{
+    switch(pattern) {
+        case cfaPattern::rggb:
+            return f(cfaQuad<cfaPattern::rggb>{});
+        case cfaPattern::bggr:
+            return f(cfaQuad<cfaPattern::bggr>{});
+        case cfaPattern::grbg:
+            return f(cfaQuad<cfaPattern::grbg>{});
+        default:
+            return f(cfaQuad<cfaPattern::gbrg>{});
+    }
+}
+
+inline cfaPattern cfaPatternFromFlags(std::uint32_t flags)
+{
+    return (cfaPattern)((flags & OMLS_FLAG_CFA_MASK) >> OMLS_FLAG_CFA_SHIFT);
+}
+
+inline std::uint32_t cfaPatternFlags(cfaPattern pattern)
+{
+    return ((std::uint32_t)pattern << OMLS_FLAG_CFA_SHIFT) & OMLS_FLAG_CFA_MASK;
+}
+
+/**
+ * Parses pattern name (GBRG, RGGB, BGGR or GRBG, any case) of @param name to @param pattern.
+ * Returns false for unknown names.
+*/
+inline bool parseCfaPattern(const char* name, cfaPattern& pattern)
+{
+    static const char* names[] = {"gbrg", "rggb", "bggr", "grbg"};
+    for(std::uint8_t i = 0; i < 4; i++) {
+        std::size_t c = 0;
+        while(c < 4 && std::tolower((unsigned char)name[c]) == names[i][c]) {
+            c++;
+        }
+        if(c == 4 && name[4] == '\0') {
+            pattern = (cfaPattern)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline const char* cfaPatternName(cfaPattern pattern)
+{
+    static const char* names[] = {"GBRG", "RGGB", "BGGR", "GRBG"};
+    return names[(std::uint8_t)pattern & 3];
+}
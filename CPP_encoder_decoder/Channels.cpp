@@ -1,226 +1,238 @@
 #include "Channels.hpp"
 #include <iostream>
+#include <new>
+#include <stdexcept>
 
 /**
- * 
- * SIGNED quad channel
+ *
+ * Plane arena
 */
-sQuadChannelCS::sQuadChannelCS(){};
-sQuadChannelCS::sQuadChannelCS(std::size_t length)
-   : Y(length)
-   , Cd(length)
-   , Cm(length)
-   , Co(length){};
+PlaneArena::PlaneArena(){};
+PlaneArena::PlaneArena(std::size_t capacity)
+   : m_pData(allocateAligned(capacity))
+   , m_capacity(capacity){};
 
-/**
- * Get span (*data, size) of Channel member
-*/
-std::span<std::int16_t> sQuadChannelCS::getChannel(Channel channel)
+void PlaneArena::AlignedDelete::operator()(std::byte* ptr) const
 {
-    switch(channel) {
-        case Channel::Y:
-            return {Y.data(), Y.size()};
-        case Channel::Cd:
-            return {Cd.data(), Cd.size()};
-        case Channel::Cm:
-            return {Cm.data(), Cm.size()};
-        case Channel::Co:
-            return {Co.data(), Co.size()};
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
-    }
+    PlaneArena::freeAligned(ptr);
 };
 
 /**
- * Returns span (*data, size) of Channel member
+ * Returns PLANE_ALIGNMENT aligned, uninitialized memory of @param bytes. Throws std::bad_alloc when arena is exhausted.
 */
-std::span<std::int16_t> sQuadChannelCS::getChannel(std::size_t chIdx)
+void* PlaneArena::allocate(std::size_t bytes)
 {
-    switch(chIdx) {
-        case 0:
-            return {Y.data(), Y.size()};
-        case 1:
-            return {Cd.data(), Cd.size()};
-        case 2:
-            return {Cm.data(), Cm.size()};
-        case 3:
-            return {Co.data(), Co.size()};
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
+    std::size_t aligned = (bytes + PLANE_ALIGNMENT - 1) & ~(std::size_t)(PLANE_ALIGNMENT - 1);
+    if(aligned > m_capacity - m_used) {
+        throw std::bad_alloc();
     }
+    void* ptr = m_pData.get() + m_used;
+    m_used += aligned;
+    return ptr;
 };
 
 /**
- * Get span (*data, size) of SIGNED Channel member as View only.
+ * Releases all allocations at once. Containers using the arena must not be used afterwards.
 */
-std::span<std::int16_t const> sQuadChannelCS::getChannelView(Channel channel) const
+void PlaneArena::reset()
 {
-    switch(channel) {
-        case Channel::Y:
-            return {Y.data(), Y.size()};
-        case Channel::Cd:
-            return {Cd.data(), Cd.size()};
-        case Channel::Cm:
-            return {Cm.data(), Cm.size()};
-        case Channel::Co:
-            return {Co.data(), Co.size()};
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
-    }
+    m_used = 0;
+};
+
+std::size_t PlaneArena::getCapacity() const
+{
+    return m_capacity;
+};
+
+std::size_t PlaneArena::getUsed() const
+{
+    return m_used;
+};
+
+std::byte* PlaneArena::allocateAligned(std::size_t bytes)
+{
+    return static_cast<std::byte*>(::operator new(bytes, std::align_val_t{PLANE_ALIGNMENT}));
+};
+
+void PlaneArena::freeAligned(std::byte* ptr)
+{
+    ::operator delete(ptr, std::align_val_t{PLANE_ALIGNMENT});
 };
 
 /**
- * Get *data of UNSIGNED Channel member as View only.
+ *
+ * Quad channel
 */
-const std::int16_t* sQuadChannelCS::getChannelDataConst(Channel channel) const
+template<typename T>
+QuadChannelCS<T>::QuadChannelCS(){};
+
+/**
+ * 4 planes of @param length elements, zero initialized.
+*/
+template<typename T>
+QuadChannelCS<T>::QuadChannelCS(std::size_t length, PlaneArena* pArena)
+   : QuadChannelCS(length, 1, pArena){};
+
+/**
+ * 4 planes of @param width x @param height elements, zero initialized. Taken from @param pArena if not nullptr,
+ * otherwise from a single owned allocation.
+*/
+template<typename T>
+QuadChannelCS<T>::QuadChannelCS(std::size_t width, std::size_t height, PlaneArena* pArena)
+   : m_rowStride(width)
 {
-    switch(channel) {
-        case Channel::Y:
-            return Y.data();
-        case Channel::Cd:
-            return Cd.data();
-        case Channel::Cm:
-            return Cm.data();
-        case Channel::Co:
-            return Co.data();
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return NULL;
+    const std::size_t length = width * height;
+    if(length == 0) {
+        return;
+    }
+
+    const std::size_t planeStride = getPlaneStride(length);
+    const std::size_t bytes       = getBytesRequired(width, height);
+
+    std::byte* pBlock;
+    if(pArena) {
+        pBlock = static_cast<std::byte*>(pArena->allocate(bytes));
+    } else {
+        m_pBlock = PlaneArena::allocateAligned(bytes);
+        pBlock   = m_pBlock;
     }
+    T* pData = new(pBlock) T[4 * planeStride]();
+
+    Y  = {pData + 0 * planeStride, length};
+    Cd = {pData + 1 * planeStride, length};
+    Cm = {pData + 2 * planeStride, length};
+    Co = {pData + 3 * planeStride, length};
 };
+
 /**
- * Get *data of UNSIGNED Channel member as View only.
+ * Planes do not move in memory, so spans stay valid when ownership of the block is transferred.
 */
-const std::int16_t* sQuadChannelCS::getChannelDataConst(std::size_t chIdx) const
+template<typename T>
+QuadChannelCS<T>::QuadChannelCS(QuadChannelCS&& other) noexcept
+   : Y(other.Y)
+   , Cd(other.Cd)
+   , Cm(other.Cm)
+   , Co(other.Co)
+   , m_pBlock(other.m_pBlock)
+   , m_rowStride(other.m_rowStride)
 {
-    switch(chIdx) {
-        case 0:
-            return Y.data();
-        case 1:
-            return Cd.data();
-        case 2:
-            return Cm.data();
-        case 3:
-            return Co.data();
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return NULL;
-    }
+    other.Y        = {};
+    other.Cd       = {};
+    other.Cm       = {};
+    other.Co       = {};
+    other.m_pBlock = nullptr;
 };
 
-const std::size_t sQuadChannelCS::getChannelSizeConst(Channel channel) const
+template<typename T>
+QuadChannelCS<T>& QuadChannelCS<T>::operator=(QuadChannelCS&& other) noexcept
 {
-    switch(channel) {
-        case Channel::Y:
-            return Y.size();
-        case Channel::Cd:
-            return Cd.size();
-        case Channel::Cm:
-            return Cm.size();
-        case Channel::Co:
-            return Co.size();
-        default:
-            throw std::runtime_error("getChannelSize(): Invalid member requested.");
-            return 0;
+    if(this != &other) {
+        PlaneArena::freeAligned(m_pBlock);
+        Y              = other.Y;
+        Cd             = other.Cd;
+        Cm             = other.Cm;
+        Co             = other.Co;
+        m_pBlock       = other.m_pBlock;
+        m_rowStride    = other.m_rowStride;
+        other.Y        = {};
+        other.Cd       = {};
+        other.Cm       = {};
+        other.Co       = {};
+        other.m_pBlock = nullptr;
     }
-}
+    return *this;
+};
+
+template<typename T>
+QuadChannelCS<T>::~QuadChannelCS()
+{
+    PlaneArena::freeAligned(m_pBlock);
+};
 
 /**
- * 
- * UNSIGNED quad channel
+ * Elements between starts of consecutive planes: @param length rounded up to PLANE_ALIGNMENT.
 */
-uQuadChannelCS::uQuadChannelCS(std::size_t length)
-   : Y(length)
-   , Cd(length)
-   , Cm(length)
-   , Co(length){};
+template<typename T>
+std::size_t QuadChannelCS<T>::getPlaneStride(std::size_t length)
+{
+    constexpr std::size_t alignElements = PLANE_ALIGNMENT / sizeof(T);
+    return (length + alignElements - 1) / alignElements * alignElements;
+};
 
 /**
- * Returns span (*data, size) of Channel member
+ * Bytes taken from arena by one container of @param width x @param height.
 */
-std::span<std::uint16_t> uQuadChannelCS::getChannel(Channel channel)
+template<typename T>
+std::size_t QuadChannelCS<T>::getBytesRequired(std::size_t width, std::size_t height)
 {
-    switch(channel) {
-        case Channel::Y:
-            return {Y.data(), Y.size()};
-        case Channel::Cd:
-            return {Cd.data(), Cd.size()};
-        case Channel::Cm:
-            return {Cm.data(), Cm.size()};
-        case Channel::Co:
-            return {Co.data(), Co.size()};
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
-    }
+    return 4 * getPlaneStride(width * height) * sizeof(T);
+};
+
+/**
+ * Get span (*data, size) of Channel member
+*/
+template<typename T>
+std::span<T> QuadChannelCS<T>::getChannel(Channel channel)
+{
+    return getChannel((std::size_t)channel);
 };
 
 /**
  * Returns span (*data, size) of Channel member
 */
-std::span<std::uint16_t> uQuadChannelCS::getChannel(std::size_t chIdx)
+template<typename T>
+std::span<T> QuadChannelCS<T>::getChannel(std::size_t chIdx)
 {
     switch(chIdx) {
         case 0:
-            return {Y.data(), Y.size()};
+            return Y;
         case 1:
-            return {Cd.data(), Cd.size()};
+            return Cd;
         case 2:
-            return {Cm.data(), Cm.size()};
+            return Cm;
         case 3:
-            return {Co.data(), Co.size()};
+            return Co;
         default:
             throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
+            return Co;   // dummy return
     }
 };
 
 /**
- * Returns span (*data, size) of Channel member as View only.
+ * Get span (*data, size) of Channel member as View only.
 */
-std::span<std::uint16_t const> uQuadChannelCS::getChannelView(Channel channel) const
+template<typename T>
+std::span<T const> QuadChannelCS<T>::getChannelView(Channel channel) const
 {
     switch(channel) {
         case Channel::Y:
-            return {Y.data(), Y.size()};
+            return Y;
         case Channel::Cd:
-            return {Cd.data(), Cd.size()};
+            return Cd;
         case Channel::Cm:
-            return {Cm.data(), Cm.size()};
+            return Cm;
         case Channel::Co:
-            return {Co.data(), Co.size()};
+            return Co;
         default:
             throw std::runtime_error("getChannel(): Invalid member requested.");
-            return {Co.data(), Co.size()};   // dummy return
+            return Co;   // dummy return
     }
 };
 
 /**
- * Get pointer to Channel member data as View only.
+ * Get *data of Channel member as View only.
 */
-const std::uint16_t* uQuadChannelCS::getChannelDataConst(Channel channel) const
+template<typename T>
+const T* QuadChannelCS<T>::getChannelDataConst(Channel channel) const
 {
-    switch(channel) {
-        case Channel::Y:
-            return Y.data();
-        case Channel::Cd:
-            return Cd.data();
-        case Channel::Cm:
-            return Cm.data();
-        case Channel::Co:
-            return Co.data();
-        default:
-            throw std::runtime_error("getChannel(): Invalid member requested.");
-            return NULL;
-    }
+    return getChannelView(channel).data();
 };
+
 /**
- * Get pointer to Channel member data as View only.
+ * Get *data of Channel member as View only.
 */
-const std::uint16_t* uQuadChannelCS::getChannelDataConst(std::size_t chIdx) const
+template<typename T>
+const T* QuadChannelCS<T>::getChannelDataConst(std::size_t chIdx) const
 {
     switch(chIdx) {
         case 0:
@@ -237,19 +249,26 @@ const std::uint16_t* uQuadChannelCS::getChannelDataConst(std::size_t chIdx) cons
     }
 };
 
-const std::size_t uQuadChannelCS::getChannelSizeConst(Channel channel) const
+template<typename T>
+const std::size_t QuadChannelCS<T>::getChannelSizeConst(Channel channel) const
 {
-    switch(channel) {
-        case Channel::Y:
-            return Y.size();
-        case Channel::Cd:
-            return Cd.size();
-        case Channel::Cm:
-            return Cm.size();
-        case Channel::Co:
-            return Co.size();
-        default:
-            throw std::runtime_error("getChannelSize(): Invalid member requested.");
-            return 0;
-    }
-}
\ No newline at end of file
+    return getChannelView(channel).size();
+}
+
+/**
+ * Returns span of @param row of channel @param chIdx.
+*/
+template<typename T>
+std::span<T> QuadChannelCS<T>::getRow(std::size_t chIdx, std::size_t row)
+{
+    return getChannel(chIdx).subspan(row * m_rowStride, m_rowStride);
+};
+
+template<typename T>
+std::size_t QuadChannelCS<T>::getRowStride() const
+{
+    return m_rowStride;
+};
+
+template struct QuadChannelCS<std::int16_t>;
+template struct QuadChannelCS<std::uint16_t>;
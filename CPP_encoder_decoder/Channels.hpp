@@ -1,41 +1,46 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
-#include <vector>
+
+#define PLANE_ALIGNMENT 64 /* Byte alignment of each channel plane, one cache line / AVX-512 register */
 
 /**
- * Quad channel color space signed.
+ * Bump allocator over a single PLANE_ALIGNMENT aligned block. Memory is handed out in aligned pieces and
+ * released all at once by reset() or destruction. Lets several quad channel containers share one allocation.
 */
-struct sQuadChannelCS {
-    // maybe make it more general, eg. ch1, ch2 instead of Y, Cd,..
-    enum class Channel
-    {
-        Y,
-        Cd,
-        Cm,
-        Co
+class PlaneArena
+{
+  private:
+    struct AlignedDelete {
+        void operator()(std::byte* ptr) const;
     };
+    std::unique_ptr<std::byte[], AlignedDelete> m_pData;
+    std::size_t m_capacity = 0;
+    std::size_t m_used     = 0;
 
-    std::vector<std::int16_t> Y;
-    std::vector<std::int16_t> Cd;
-    std::vector<std::int16_t> Cm;
-    std::vector<std::int16_t> Co;
-
-    explicit sQuadChannelCS();
-    explicit sQuadChannelCS(std::size_t length);
-    std::span<std::int16_t> getChannel(Channel channel);
-    std::span<std::int16_t> getChannel(std::size_t chIdx);
-    std::span<std::int16_t const> getChannelView(Channel channel) const;
-    const std::int16_t* getChannelDataConst(Channel channel) const;
-    const std::int16_t* getChannelDataConst(std::size_t chIdx) const;
-    const std::size_t getChannelSizeConst(Channel channel) const;
+  public:
+    PlaneArena();
+    explicit PlaneArena(std::size_t capacity);
+
+    void* allocate(std::size_t bytes);
+    void reset();
+    std::size_t getCapacity() const;
+    std::size_t getUsed() const;
+
+    static std::byte* allocateAligned(std::size_t bytes);
+    static void freeAligned(std::byte* ptr);
 };
 
 /**
- * Quad channel color space unsigned.
+ * Quad channel color space. All 4 planes (Y, Cd, Cm, Co) live in one contiguous block, each plane starting at
+ * PLANE_ALIGNMENT. The block is owned by the container, or taken from caller supplied PlaneArena which must
+ * outlive it. Planes are exposed as spans; rows are packed, getRowStride() elements apart.
 */
-struct uQuadChannelCS {
+template<typename T>
+struct QuadChannelCS {
     // maybe make it more general, eg. ch1, ch2 instead of Y, Cd,..
     enum class Channel
     {
@@ -45,16 +50,43 @@ struct uQuadChannelCS {
         Co
     };
 
-    std::vector<std::uint16_t> Y;
-    std::vector<std::uint16_t> Cd;
-    std::vector<std::uint16_t> Cm;
-    std::vector<std::uint16_t> Co;
-
-    explicit uQuadChannelCS(std::size_t length);
-    std::span<std::uint16_t> getChannel(Channel channel);
-    std::span<std::uint16_t> getChannel(std::size_t chIdx);
-    std::span<std::uint16_t const> getChannelView(Channel channel) const;
-    const std::uint16_t* getChannelDataConst(Channel channel) const;
-    const std::uint16_t* getChannelDataConst(std::size_t chIdx) const;
+    std::span<T> Y;
+    std::span<T> Cd;
+    std::span<T> Cm;
+    std::span<T> Co;
+
+    explicit QuadChannelCS();
+    explicit QuadChannelCS(std::size_t length, PlaneArena* pArena = nullptr);
+    explicit QuadChannelCS(std::size_t width, std::size_t height, PlaneArena* pArena = nullptr);
+    QuadChannelCS(QuadChannelCS&& other) noexcept;
+    QuadChannelCS& operator=(QuadChannelCS&& other) noexcept;
+    QuadChannelCS(const QuadChannelCS&)            = delete;
+    QuadChannelCS& operator=(const QuadChannelCS&) = delete;
+    ~QuadChannelCS();
+
+    static std::size_t getPlaneStride(std::size_t length);
+    static std::size_t getBytesRequired(std::size_t width, std::size_t height);
+
+    std::span<T> getChannel(Channel channel);
+    std::span<T> getChannel(std::size_t chIdx);
+    std::span<T const> getChannelView(Channel channel) const;
+    const T* getChannelDataConst(Channel channel) const;
+    const T* getChannelDataConst(std::size_t chIdx) const;
     const std::size_t getChannelSizeConst(Channel channel) const;
-};
\ No newline at end of file
+    std::span<T> getRow(std::size_t chIdx, std::size_t row);
+    std::size_t getRowStride() const;
+
+  private:
+    std::byte* m_pBlock     = nullptr;   // owned block, nullptr when empty or taken from arena
+    std::size_t m_rowStride = 0;
+};
+
+/**
+ * Quad channel color space signed.
+*/
+using sQuadChannelCS = QuadChannelCS<std::int16_t>;
+
+/**
+ * Quad channel color space unsigned.
+*/
+using uQuadChannelCS = QuadChannelCS<std::uint16_t>;
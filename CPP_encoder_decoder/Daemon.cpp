@@ -0,0 +1,546 @@
+#include "Daemon.hpp"
+#include "Archive.hpp"
+#include "Encoder.hpp"
+#include "FrameRing.hpp"
+#include "Image.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define DAEMON_POLL_MS 100 /* Longest wait of a blocked thread before it checks for stop */
+
+static std::uint64_t nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+       .count();
+}
+
+struct Daemon::camera_t {
+    cameraConfig_t config;
+    std::string filePrefix;   // of encoder dumps
+    cameraCounters_t counters;
+    FrameQueue queue;
+
+    explicit camera_t(const cameraConfig_t& cameraConfig)
+       : config(cameraConfig)
+       , filePrefix(cameraConfig.name + "_")
+       , queue(cameraConfig.queueDepth ? cameraConfig.queueDepth : 1)
+    {
+    }
+};
+
+#ifndef _WIN32
+/**
+ * Reads exactly @param size bytes. False on end of input, error or @param stop.
+*/
+static bool readExact(int fd, void* data, std::size_t size, const std::atomic<bool>& stop)
+{
+    std::uint8_t* pDst = static_cast<std::uint8_t*>(data);
+    while(size) {
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, DAEMON_POLL_MS);
+        if(stop) {
+            return false;
+        }
+        if(ready <= 0) {
+            continue;
+        }
+        ssize_t bytes = read(fd, pDst, size);
+        if(bytes <= 0) {
+            return false;
+        }
+        pDst += bytes;
+        size -= bytes;
+    }
+    return true;
+}
+
+/**
+ * Reads and discards input until its writer closes it or @param stop.
+*/
+static void drainStream(int fd, const std::atomic<bool>& stop)
+{
+    std::uint8_t discard[4096];
+    while(!stop) {
+        pollfd pfd{fd, POLLIN, 0};
+        if(poll(&pfd, 1, DAEMON_POLL_MS) <= 0) {
+            continue;
+        }
+        if(read(fd, discard, sizeof(discard)) <= 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * Queues frames of a pipe or socket until it ends. Payload of a dropped frame is still read, to stay in sync.
+*/
+static void readStream(
+   int fd,
+   const cameraConfig_t& config,
+   FrameQueue& queue,
+   cameraCounters_t& counters,
+   const std::atomic<bool>& stop)
+{
+    std::vector<std::uint8_t> discard;
+    frameSlot_t slot;
+    while(readExact(fd, &slot, sizeof(slot), stop)) {
+        if(!isValidRawSlot(slot, config.maxFrameBytes)) {
+            std::cerr << "Camera " << config.name << ": invalid frame descriptor, input closed." << std::endl;
+            counters.framesIn++;
+            counters.framesDropped++;
+            return;
+        }
+        counters.framesIn++;
+        int index = queue.acquire(config.policy, stop, counters.framesDropped);
+        std::uint8_t* pPayload;
+        if(index >= 0) {
+            queuedFrame_t& frame = queue.frame(index);
+            frame.slot           = slot;
+            frame.payload.resize(slot.size);
+            pPayload = frame.payload.data();
+        } else {
+            discard.resize(slot.size);
+            pPayload = discard.data();
+        }
+        if(!readExact(fd, pPayload, slot.size, stop)) {
+            if(index >= 0) {
+                queue.release(index);
+            }
+            return;
+        }
+        if(index >= 0) {
+            queue.frame(index).arrival = nowMicros();
+            queue.publish(index);
+        }
+    }
+}
+#endif
+
+Daemon::Daemon() {}
+
+Daemon::~Daemon() {}
+
+/**
+ * Reads camera configuration @param fileName, one camera per line:
+ * name input output [cpu=N] [queue=N] [policy=block|drop-oldest|drop-newest] [frame_bytes=N] [slots=N]
+ * [lossy=N] [unary=N] [lsb=0|1]
+ * Empty lines and lines starting with # are skipped.
+*/
+STATUS_t Daemon::parseConfig(const char* fileName, std::vector<cameraConfig_t>& cameras)
+{
+    std::ifstream rf(fileName);
+    if(!rf) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    std::string line;
+    for(std::size_t lineNumber = 1; std::getline(rf, line); lineNumber++) {
+        std::istringstream tokens(line);
+        cameraConfig_t config;
+        if(!(tokens >> config.name) || config.name[0] == '#') {
+            continue;
+        }
+        if(!(tokens >> config.input >> config.output)) {
+            std::cerr << fileName << ":" << lineNumber << ": camera needs name, input and output." << std::endl;
+            return BASE_ERROR;
+        }
+        std::string option;
+        while(tokens >> option) {
+            std::size_t split = option.find('=');
+            std::string key   = option.substr(0, split);
+            std::string value = split == std::string::npos ? "" : option.substr(split + 1);
+            try {
+                if(key == "cpu") {
+                    config.cpu = std::stoi(value);
+                } else if(key == "queue") {
+                    config.queueDepth = std::stoul(value);
+                } else if(key == "frame_bytes") {
+                    config.maxFrameBytes = std::stoull(value);
+                } else if(key == "slots") {
+                    config.outputSlots = std::stoul(value);
+                } else if(key == "lossy") {
+                    config.lossyBits = std::stoul(value);
+                } else if(key == "unary") {
+                    config.unaryMaxWidth = std::stoul(value);
+                } else if(key == "lsb") {
+                    config.lsbFirst = std::stoi(value) != 0;
+                } else if(key == "policy" && value == "block") {
+                    config.policy = dropPolicy::block;
+                } else if(key == "policy" && value == "drop-oldest") {
+                    config.policy = dropPolicy::dropOldest;
+                } else if(key == "policy" && value == "drop-newest") {
+                    config.policy = dropPolicy::dropNewest;
+                } else {
+                    throw std::invalid_argument(option);
+                }
+            } catch(const std::exception&) {
+                std::cerr << fileName << ":" << lineNumber << ": invalid option " << option << std::endl;
+                return BASE_ERROR;
+            }
+        }
+        cameras.push_back(config);
+    }
+    return BASE_SUCCESS;
+}
+
+void Daemon::addCamera(const cameraConfig_t& config)
+{
+    m_cameras.push_back(std::make_unique<camera_t>(config));
+}
+
+/**
+ * Input thread of a camera: queues frames until its input ends or the daemon stops.
+*/
+void Daemon::reader(camera_t* pCamera)
+{
+    const cameraConfig_t& config = pCamera->config;
+    cameraCounters_t& counters   = pCamera->counters;
+    FrameQueue& queue            = pCamera->queue;
+    const std::size_t split      = config.input.find(':');
+    const std::string kind       = config.input.substr(0, split);
+    const std::string location   = split == std::string::npos ? "" : config.input.substr(split + 1);
+
+    if(kind == "ring") {
+        // Producer may start later, wait for its ring
+        FrameRing ring;
+        while(!m_stop && ring.open(location.c_str()) != BASE_SUCCESS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DAEMON_POLL_MS));
+        }
+        while(!m_stop) {
+            const frameSlot_t* pSlot = ring.beginRead();
+            if(!pSlot) {
+                if(ring.isFinished()) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            counters.framesIn++;
+            if(!isValidRawSlot(*pSlot, config.maxFrameBytes)) {
+                std::cerr << "Camera " << config.name << ": invalid frame " << pSlot->frameId << ", dropped."
+                          << std::endl;
+                counters.framesDropped++;
+                ring.endRead();
+                continue;
+            }
+            // With block policy the slot stays in the ring meanwhile
+            int index = queue.acquire(config.policy, m_stop, counters.framesDropped);
+            if(index >= 0) {
+                queuedFrame_t& frame = queue.frame(index);
+                frame.slot           = *pSlot;
+                frame.payload.assign(pSlot->payload(), pSlot->payload() + pSlot->size);
+                frame.arrival = nowMicros();
+                queue.publish(index);
+            }
+            ring.endRead();
+        }
+#ifndef _WIN32
+    } else if(kind == "pipe") {
+        // As with sockets, the next producer may open the pipe after the previous one closed it. Reopened at end
+        // of input, which is reported forever once the last writer closed the pipe.
+        while(!m_stop) {
+            int fd = open(location.c_str(), O_RDONLY | O_NONBLOCK);   // does not wait for a writer
+            if(fd < 0) {
+                std::cerr << "Camera " << config.name << ": cannot open pipe " << location << std::endl;
+                break;
+            }
+            readStream(fd, config, queue, counters, m_stop);
+            drainStream(fd, m_stop);   // rest of a stream with an invalid descriptor
+            close(fd);
+        }
+    } else if(kind == "unix") {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, location.c_str(), sizeof(address.sun_path) - 1);
+        unlink(location.c_str());
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) || listen(listener, 1)) {
+            std::cerr << "Camera " << config.name << ": cannot listen on " << location << std::endl;
+        } else {
+            // One producer at a time, the next one may connect after it disconnects
+            while(!m_stop) {
+                pollfd pfd{listener, POLLIN, 0};
+                if(poll(&pfd, 1, DAEMON_POLL_MS) <= 0) {
+                    continue;
+                }
+                int connection = accept(listener, nullptr, nullptr);
+                if(connection >= 0) {
+                    readStream(connection, config, queue, counters, m_stop);
+                    close(connection);
+                }
+            }
+            unlink(location.c_str());
+        }
+        if(listener >= 0) {
+            close(listener);
+        }
+#endif
+    } else {
+        std::cerr << "Camera " << config.name << ": unsupported input " << config.input << std::endl;
+    }
+    queue.close();
+}
+
+/**
+ * Encoder thread of a camera: encodes queued frames to its output until the queue is closed and drained.
+*/
+void Daemon::worker(camera_t* pCamera)
+{
+    const cameraConfig_t& config = pCamera->config;
+    cameraCounters_t& counters   = pCamera->counters;
+    FrameQueue& queue            = pCamera->queue;
+    const std::size_t split      = config.output.find(':');
+    const std::string kind       = config.output.substr(0, split);
+    const std::string location   = split == std::string::npos ? "" : config.output.substr(split + 1);
+
+    if(config.cpu >= 0) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+        if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+            std::cerr << "Camera " << config.name << ": cannot pin worker to CPU " << config.cpu << std::endl;
+        }
+#endif
+    }
+
+    FrameRing ring;
+    ArchiveWriter archive;
+    STATUS_t status = BASE_ERROR;
+    if(kind == "ring") {
+        status = ring.create(location.c_str(), config.outputSlots, config.maxFrameBytes + OMLS_HEADER_V2_SIZE + 4096);
+    } else if(kind == "archive") {
+        status = archive.open(location.c_str());
+    }
+    if(status) {
+        DecoderBase::handleReturnValue(status);
+        std::cerr << "Camera " << config.name << ": cannot open output " << config.output << ", frames dropped."
+                  << std::endl;
+    }
+
+    std::ostringstream frameStream;
+    for(int index = queue.pop(); index >= 0; index = queue.pop()) {
+        queuedFrame_t& frame = queue.frame(index);
+        if(status) {
+            counters.framesDropped++;
+            queue.release(index);
+            continue;
+        }
+
+        BayerView view;
+        view.data   = reinterpret_cast<const std::uint16_t*>(frame.payload.data());
+        view.pitch  = frame.slot.pitch;
+        view.width  = frame.slot.width;
+        view.height = frame.slot.height;
+
+        auto encode = [&](std::ostream* pOut) {
+            Encoder enc{
+               view,
+               m_folder,
+               frame.slot.frameId % 100,
+               32,
+               8,
+               config.lossyBits,
+               config.unaryMaxWidth,
+               frame.slot.bpp,
+               24,
+               pCamera->filePrefix.c_str()};
+            enc.setOutputStream(pOut);
+            enc.setBitOrderLSBFirst(config.lsbFirst);
+            enc.setTimestamp(frame.slot.timestamp / 1000);   // slot timestamps are in us
+            enc.setDumpVerification(false);
+            enc.setVerbose(false);   // cameras encode concurrently
+            enc.encodeUsingMethod(
+               config.unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                               : Encoder::method::parallel_limited);
+            return enc.getFileSize();
+        };
+
+        bool written         = false;
+        std::size_t fileSize = 0;
+        try {
+            if(kind == "ring") {
+                frameSlot_t* pSlot;
+                while(!(pSlot = ring.beginWrite()) && !m_stop) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));   // output consumer is behind
+                }
+                if(pSlot) {
+                    FrameSlotBuffer slotBuffer(pSlot, ring.getSlotSize());
+                    std::ostream slotStream(&slotBuffer);
+                    fileSize = encode(&slotStream);
+                    if(slotStream) {
+                        pSlot->size      = slotBuffer.size();
+                        pSlot->frameId   = frame.slot.frameId;
+                        pSlot->timestamp = frame.slot.timestamp;
+                        pSlot->width     = frame.slot.width;
+                        pSlot->height    = frame.slot.height;
+                        pSlot->pitch     = 0;
+                        pSlot->bpp       = frame.slot.bpp;
+                        ring.endWrite();
+                        written = true;
+                    }
+                }
+            } else {
+                frameStream.str("");
+                fileSize  = encode(&frameStream);
+                auto data = frameStream.view();
+                written   = archive.append(frame.slot.frameId, (const std::uint8_t*)data.data(), data.size())
+                          == BASE_SUCCESS;
+            }
+        } catch(const std::exception& e) {
+            std::cerr << "Camera " << config.name << ": " << e.what() << std::endl;
+        }
+
+        if(written) {
+            const std::uint64_t latency = nowMicros() - frame.arrival;
+            std::size_t bucket          = 0;
+            while(bucket + 1 < DAEMON_LATENCY_BUCKETS && latency >= (1ULL << bucket)) {
+                bucket++;
+            }
+            counters.framesEncoded++;
+            counters.bytesIn += (std::uint64_t)view.width * view.height * (frame.slot.bpp > 8 ? 2 : 1);
+            counters.bytesOut += fileSize;
+            counters.latencySum += latency;
+            counters.latencyHistogram[bucket]++;
+            std::uint64_t max = counters.latencyMax;
+            while(latency > max && !counters.latencyMax.compare_exchange_weak(max, latency)) {
+            }
+        } else {
+            std::cerr << "Camera " << config.name << ": frame " << frame.slot.frameId << " not written, dropped."
+                      << std::endl;
+            counters.framesDropped++;
+        }
+        queue.release(index);
+    }
+
+    if(kind == "ring" && status == BASE_SUCCESS) {
+        ring.finish();
+    }
+    DecoderBase::handleReturnValue(archive.close());
+}
+
+/**
+ * Serves report() to each client connecting to Unix socket @param socketPath.
+*/
+void Daemon::statsServer(const char* socketPath)
+{
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    unlink(socketPath);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) || listen(listener, 4)) {
+        std::cerr << "Cannot serve statistics on " << socketPath << std::endl;
+        if(listener >= 0) {
+            close(listener);
+        }
+        return;
+    }
+    while(!m_stop) {
+        pollfd pfd{listener, POLLIN, 0};
+        if(poll(&pfd, 1, DAEMON_POLL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(listener, nullptr, nullptr);
+        if(client < 0) {
+            continue;
+        }
+        std::string text = report();
+        for(std::size_t sent = 0; sent < text.size();) {
+            ssize_t bytes = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if(bytes <= 0) {
+                break;
+            }
+            sent += bytes;
+        }
+        close(client);
+    }
+    close(listener);
+    unlink(socketPath);
+#else
+    std::cerr << "Statistics socket is not supported on this platform: " << socketPath << std::endl;
+#endif
+}
+
+/**
+ * Runs all cameras until their inputs end or stop() is called, queued frames are still encoded.
+ * Counters are served on @param statsSocket if not nullptr, encoder dumps go to @param folder.
+*/
+STATUS_t Daemon::run(const char* statsSocket, const char* folder)
+{
+    m_folder = folder;
+    m_start  = nowMicros();
+
+    std::vector<std::thread> threads;
+    for(auto& pCamera : m_cameras) {
+        threads.emplace_back(&Daemon::reader, this, pCamera.get());
+        threads.emplace_back(&Daemon::worker, this, pCamera.get());
+    }
+    std::thread stats;
+    if(statsSocket) {
+        stats = std::thread(&Daemon::statsServer, this, statsSocket);
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    m_stop = true;
+    if(stats.joinable()) {
+        stats.join();
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Async signal safe.
+*/
+void Daemon::stop()
+{
+    m_stop = true;
+}
+
+/**
+ * One line of key=value counters per camera. Latency is from frame arrival to compressed frame written,
+ * p99 is the upper bound of its power of two histogram bucket.
+*/
+std::string Daemon::report() const
+{
+    const double seconds = (nowMicros() - m_start) / 1e6;
+    std::ostringstream text;
+    for(const auto& pCamera : m_cameras) {
+        const cameraCounters_t& counters = pCamera->counters;
+        const std::uint64_t encoded      = counters.framesEncoded;
+
+        std::uint64_t total = 0;
+        for(const auto& bucket : counters.latencyHistogram) {
+            total += bucket;
+        }
+        std::uint64_t p99 = 0, cumulative = 0;
+        for(std::size_t bucket = 0; bucket < DAEMON_LATENCY_BUCKETS && total; bucket++) {
+            cumulative += counters.latencyHistogram[bucket];
+            if(cumulative * 100 >= total * 99) {
+                p99 = 1ULL << bucket;
+                break;
+            }
+        }
+
+        text << "camera=" << pCamera->config.name << " in=" << counters.framesIn << " encoded=" << encoded
+             << " dropped=" << counters.framesDropped << " queued=" << pCamera->queue.size()
+             << " bytes_in=" << counters.bytesIn << " bytes_out=" << counters.bytesOut
+             << " fps=" << (seconds > 0 ? encoded / seconds : 0)
+             << " latency_mean_us=" << (encoded ? counters.latencySum / encoded : 0) << " latency_p99_us=" << p99
+             << " latency_max_us=" << counters.latencyMax << "\n";
+    }
+    return text.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include "FrameQueue.hpp"
+#include "globalDefines.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define DAEMON_LATENCY_BUCKETS 32 /* Latency histogram buckets, bucket b counts latencies below 2^b us */
+
+/*
+* One camera pipeline. Input and output are given as "<kind>:<location>":
+* input ring:<name> (raw FrameRing), pipe:<path> (named pipe) or unix:<path> (Unix socket the daemon listens on),
+* output ring:<name> (compressed FrameRing, created) or archive:<path> (Archive, appended).
+* Pipes and sockets carry frames as a frameSlot_t descriptor followed by its payload, the same as raw ring slots.
+*/
+struct cameraConfig_t {
+    std::string name;
+    std::string input;
+    std::string output;
+    int cpu                     = -1;   // worker thread pinned to this CPU, -1 = not pinned
+    std::size_t queueDepth      = 4;   // frames buffered between input and worker
+    dropPolicy policy           = dropPolicy::block;
+    std::uint64_t maxFrameBytes = 1 << 26;   // largest raw payload accepted
+    std::uint32_t outputSlots   = 8;   // slots of a compressed output ring
+    std::size_t lossyBits       = 0;
+    std::size_t unaryMaxWidth   = C_MAX_UNARY_LENGTH;
+    bool lsbFirst               = false;
+};
+
+/*
+* Counters of one camera, updated by its threads and read by the stats socket.
+*/
+struct cameraCounters_t {
+    std::atomic<std::uint64_t> framesIn{0};
+    std::atomic<std::uint64_t> framesEncoded{0};
+    std::atomic<std::uint64_t> framesDropped{0};
+    std::atomic<std::uint64_t> bytesIn{0};
+    std::atomic<std::uint64_t> bytesOut{0};
+    std::atomic<std::uint64_t> latencySum{0};   // us from arrival to compressed frame written
+    std::atomic<std::uint64_t> latencyMax{0};
+    std::atomic<std::uint64_t> latencyHistogram[DAEMON_LATENCY_BUCKETS] = {};
+};
+
+/*
+* Long running compression of several cameras. Each camera has an input thread filling a bounded queue and an
+* encoder worker thread with its own Encoder, so cameras run in parallel. Counters are served as text lines on
+* a local Unix socket. Runs until all inputs have ended or stop() is called. Pipe and socket inputs and the stats
+* socket need POSIX, ring inputs work everywhere.
+*/
+class Daemon
+{
+  private:
+    struct camera_t;
+    std::vector<std::unique_ptr<camera_t>> m_cameras;
+    std::atomic<bool> m_stop{false};
+    std::uint64_t m_start = 0;
+    const char* m_folder  = ".";
+
+    void reader(camera_t* pCamera);
+    void worker(camera_t* pCamera);
+    void statsServer(const char* socketPath);
+
+  public:
+    Daemon();
+    Daemon(const Daemon&)            = delete;
+    Daemon& operator=(const Daemon&) = delete;
+    ~Daemon();
+
+    static STATUS_t parseConfig(const char* fileName, std::vector<cameraConfig_t>& cameras);
+    void addCamera(const cameraConfig_t& config);
+    STATUS_t run(const char* statsSocket, const char* folder);
+    void stop();
+    std::string report() const;
+};
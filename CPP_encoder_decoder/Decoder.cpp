@@ -51,15 +51,68 @@ Decoder::Decoder(const char* fileName, std::uint32_t A_init, std::uint32_t N_thr
     std::cout << "\n\nImported: " << fileName << std::endl;
 };
 
+/**
+ * Decoder of compressed image already in memory. Data is copied into guard padded buffer.
+*/
+Decoder::Decoder(const std::uint8_t* data, std::size_t dataSize, std::uint32_t A_init, std::uint32_t N_threshold)
+   : m_N_threshold(N_threshold)
+   , m_A_init(A_init)
+{
+    Decoder::importBitstream(data, dataSize);
+};
+
 /**
  * This one cannot be used for decoding data with channels that are encoded in parallel.
+ * Channels follow one another in a single bitstream, so the start of Cd, Cm and Co is found by parsing the
+ * preceding channels once without storing them. All 4 channels are then decoded row by row straight to BayerCFA,
+ * keeping one row of YCCC. Y, Cd and Cm are therefore parsed twice, which costs about half again the decoding
+ * time of a single parse. setKeepIntermediate parses once, but keeps all planes of the frame.
 */
 void Decoder::decodeSequentially(std::size_t lossyBits)
 {
     std::cout << "\nSequential decoding: " << unsigned(m_width) << " x " << unsigned(m_height) << std::endl;
-    decodeBitstreamAll(m_N_threshold, m_A_init);
-    toFullAll();
-    toBayerGB(lossyBits);
+    m_pixelAmount = m_width * m_height;
+
+    if(m_keepIntermediate) {
+        decodeBitstreamAll(m_N_threshold, m_A_init);
+        toFullAll();
+        toBayerGB(lossyBits);
+        return;
+    }
+
+    std::vector<std::int16_t> YCCC_row(4 * m_width);   // current row of Y, Cd, Cm and Co
+    Reader reader{m_pFileData.get()->data(), m_fileDataSize};
+    reader.loadFirstByte();
+
+    Reader readers[] = {reader, reader, reader, reader};
+    for(std::size_t ch = 1; ch < 4; ch++) {   // skip over previous channel
+        std::uint32_t A      = m_A_init;
+        std::uint32_t N      = N_START;
+        std::int16_t pixelUp = 0;
+        for(std::size_t row = 0; row < m_height; row++) {
+            if(DecoderBase::decodeChannelRow(
+                  reader, row, m_width, m_N_threshold, A, N, pixelUp, YCCC_row.data())) {
+                handleReturnValue(BASE_ERROR_ALL_BYTES_ALREADY_READ);
+                throw std::runtime_error("Sequential decoding unsuccessful.");
+            }
+        }
+        readers[ch] = reader;
+    }
+
+    std::vector<std::uint16_t> bayerGB(4 * m_pixelAmount);
+    m_width_bayer  = 2 * m_width;
+    m_height_bayer = 2 * m_height;
+
+    BayerSink<std::uint16_t, cfaPattern::gbrg> sink{bayerGB.data(), m_width, lossyBits};
+    STATUS_t status = DecoderBase::decodeChannelsInterleaved(
+       readers, m_width_bayer, m_height_bayer, m_N_threshold, m_A_init, YCCC_row.data(), sink, m_height);
+    if(status) {
+        handleReturnValue(status);
+        throw std::runtime_error("Sequential decoding unsuccessful.");
+    }
+
+    m_pBayer_16bit = std::make_unique<std::vector<std::uint16_t>>(std::forward<std::vector<std::uint16_t>>(bayerGB));
+    m_pBayer_8bit.reset();
 }
 
 /**
@@ -76,16 +129,7 @@ headerData_t Decoder::decodeParallel()
 
     auto data = m_pFileData.get();
 
-    auto status = Reader::getTimestampAndCompressionInfoFromHeader(   //
-       data->data(),
-       headerData.timestamp,
-       headerData.roi,
-       headerData.width,
-       headerData.height,
-       headerData.unaryMaxWidth,
-       headerData.bpp,
-       headerData.lossyBits,
-       headerData.reserved);
+    auto status = Reader::getHeader(data->data(), m_fileDataSize, headerData);
 
     m_width  = headerData.width / 2;
     m_height = headerData.height / 2;
@@ -94,22 +138,32 @@ headerData_t Decoder::decodeParallel()
         throw std::runtime_error("Error while reading header.");
     }
 
+    if(headerData.flags & OMLS_FLAG_CHANNEL_PLANAR) {
+        decodePlanar(headerData);
+        return headerData;
+    }
+
     std::cout << "\nUsing CPU: Parallel decoding image size W x H : " << unsigned(headerData.width) << " x "
               << unsigned(headerData.height) << std::endl;
 
+    const bool lsbFirst = headerData.flags & OMLS_FLAG_LSB_FIRST;
+
     if(headerData.bpp == 8) {
         std::vector<std::uint8_t> out_buffer(headerData.width * headerData.height);
 
-        status = DecoderBase::decodeBitstreamParallel_actual<std::uint8_t>(
+        auto decode = lsbFirst ? DecoderBase::decodeBitstreamParallel_actual<std::uint8_t, ReaderLSB>
+                               : DecoderBase::decodeBitstreamParallel_actual<std::uint8_t, Reader>;
+        status      = decode(
            headerData.width,
            headerData.height,
            headerData.lossyBits,
            headerData.unaryMaxWidth,
            headerData.bpp,
-           data->data() + 24,
-           data->size() - 24,
+           data->data() + headerData.headerSize,
+           m_fileDataSize - headerData.headerSize,
            out_buffer.data(),
-           out_buffer.size());
+           out_buffer.size(),
+           cfaPatternFromFlags(headerData.flags));
         if(status) {
             handleReturnValue(status);
             // printf("Error while decoding bitstream, error code: %d.\n", status);
@@ -122,16 +176,19 @@ headerData_t Decoder::decodeParallel()
 
     } else {
         std::vector<std::uint16_t> out_buffer(headerData.width * headerData.height);
-        status = DecoderBase::decodeBitstreamParallel_actual<std::uint16_t>(
+        auto decode = lsbFirst ? DecoderBase::decodeBitstreamParallel_actual<std::uint16_t, ReaderLSB>
+                               : DecoderBase::decodeBitstreamParallel_actual<std::uint16_t, Reader>;
+        status      = decode(
            headerData.width,
            headerData.height,
            headerData.lossyBits,
            headerData.unaryMaxWidth,
            headerData.bpp,
-           data->data() + 24,
-           data->size() - 24,
+           data->data() + headerData.headerSize,
+           m_fileDataSize - headerData.headerSize,
            out_buffer.data(),
-           out_buffer.size());
+           out_buffer.size(),
+           cfaPatternFromFlags(headerData.flags));
         if(status) {
             handleReturnValue(status);
             // printf("Error while decoding bitstream, error code: %d.\n", status);
@@ -160,16 +217,7 @@ headerData_t Decoder::decodeParallelGPU()
 
     auto data = m_pFileData.get();
 
-    auto status = Reader::getTimestampAndCompressionInfoFromHeader(   //
-       data->data(),
-       headerData.timestamp,
-       headerData.roi,
-       headerData.width,
-       headerData.height,
-       headerData.unaryMaxWidth,
-       headerData.bpp,
-       headerData.lossyBits,
-       headerData.reserved);
+    auto status = Reader::getHeader(data->data(), m_fileDataSize, headerData);
 
     m_width  = headerData.width / 2;
     m_height = headerData.height / 2;
@@ -178,20 +226,32 @@ headerData_t Decoder::decodeParallelGPU()
         throw std::runtime_error("Error while reading header.");
     }
 
+    if(headerData.flags & OMLS_FLAG_CHANNEL_PLANAR) {
+        decodePlanar(headerData);   // no GPU implementation of planar format
+        return headerData;
+    }
+    if(cfaPatternFromFlags(headerData.flags) != cfaPattern::gbrg || headerData.bpp > OMLS_YCCC16_MAX_BPP) {
+        return decodeParallel();   // pseudo GPU writes GBRG quads of int16_t YCCC only
+    }
+
     std::cout << "\nUsing GPU: Parallel decoding image size W x H : " << unsigned(headerData.width) << " x "
               << unsigned(headerData.height) << std::endl;
 
+    const bool lsbFirst = headerData.flags & OMLS_FLAG_LSB_FIRST;
+
     if(headerData.bpp == 8) {
         std::vector<std::uint8_t> out_buffer(headerData.width * headerData.height);
 
-        status = DecoderBase::decodeBitstreamParallel_pseudo_gpu(
+        auto decode = lsbFirst ? &DecoderBase::decodeBitstreamParallel_pseudo_gpu<std::uint8_t, ReaderLSB>
+                               : &DecoderBase::decodeBitstreamParallel_pseudo_gpu<std::uint8_t, Reader>;
+        status      = (this->*decode)(
            headerData.width,
            headerData.height,
            headerData.lossyBits,
            headerData.unaryMaxWidth,
            headerData.bpp,
-           data->data() + 24,
-           data->size() - 24,
+           data->data() + headerData.headerSize,
+           m_fileDataSize - headerData.headerSize,
            out_buffer.data(),
            out_buffer.size());
         if(status) {
@@ -199,35 +259,35 @@ headerData_t Decoder::decodeParallelGPU()
             // printf("Error while decoding bitstream, error code: %d.\n", status);
             throw std::runtime_error("Parallel decoding unsuccessful.");
         };
-       
+
         m_pBayer_8bit =
            std::make_unique<std::vector<std::uint8_t>>(std::forward<std::vector<std::uint8_t>>(out_buffer));
         m_pBayer_16bit.reset();
 
     } else {
+        std::vector<std::uint16_t> out_buffer(headerData.width * headerData.height);
 
-        throw std::runtime_error("10 and 12 BPP GPU decoding not yet supported.");
-
-        // std::vector<std::uint16_t> out_buffer(headerData.width * headerData.height);
-        // status = DecoderBase::decodeBitstreamParallel_actual<std::uint16_t>(
-        //    headerData.width,
-        //    headerData.height,
-        //    headerData.lossyBits,
-        //    headerData.unaryMaxWidth,
-        //    headerData.bpp,
-        //    data->data() + 24,
-        //    data->size() - 24,
-        //    out_buffer.data(),
-        //    out_buffer.size());
-        // if(status) {
-        //     handleReturnValue(status);
-        //     // printf("Error while decoding bitstream, error code: %d.\n", status);
-        //     throw std::runtime_error("Parallel decoding unsuccessful.");
-        // };
-
-        // m_pBayer_16bit =
-        //    std::make_unique<std::vector<std::uint16_t>>(std::forward<std::vector<std::uint16_t>>(out_buffer));
-        // m_pBayer_8bit.reset();
+        auto decode = lsbFirst ? &DecoderBase::decodeBitstreamParallel_pseudo_gpu<std::uint16_t, ReaderLSB>
+                               : &DecoderBase::decodeBitstreamParallel_pseudo_gpu<std::uint16_t, Reader>;
+        status      = (this->*decode)(
+           headerData.width,
+           headerData.height,
+           headerData.lossyBits,
+           headerData.unaryMaxWidth,
+           headerData.bpp,
+           data->data() + headerData.headerSize,
+           m_fileDataSize - headerData.headerSize,
+           out_buffer.data(),
+           out_buffer.size());
+        if(status) {
+            handleReturnValue(status);
+            // printf("Error while decoding bitstream, error code: %d.\n", status);
+            throw std::runtime_error("Parallel decoding unsuccessful.");
+        };
+
+        m_pBayer_16bit =
+           std::make_unique<std::vector<std::uint16_t>>(std::forward<std::vector<std::uint16_t>>(out_buffer));
+        m_pBayer_8bit.reset();
     }
 
     return headerData;
@@ -257,33 +317,26 @@ void Decoder::exportBayerImage(const char* fileName, std::uint64_t header, std::
 }
 
 /**
- * Translates image from YCCC to Bayer GreenBlue image (twice as large).
+ * Translates image from YCCC to Bayer image (twice as large) with quads in CFA pattern @param cfa.
 */
-void Decoder::toBayerGB(std::size_t lossyBits)
+void Decoder::toBayerGB(std::size_t lossyBits, cfaPattern cfa)
 {
     std::vector<std::uint16_t> bayerGB(4 * m_pixelAmount);
     m_width_bayer  = 2 * getWidth();
     m_height_bayer = 2 * getHeight();
 
-    for(std::size_t i = 0; i < m_height; i++) {
-        for(std::size_t j = 0; j < m_width; j++) {
-            std::size_t idx   = i * m_width + j;
-            std::size_t idxGB = 2 * i * m_width_bayer + 2 * j;
-            std::size_t idxB  = 2 * i * m_width_bayer + 2 * j + 1;
-            std::size_t idxR  = (2 * i + 1) * m_width_bayer + 2 * j;
-            std::size_t idxGR = (2 * i + 1) * m_width_bayer + 2 * j + 1;
-            DecoderBase::YCCC_to_BayerGB(
-               m_pFull->Y[idx],
-               m_pFull->Cd[idx],
-               m_pFull->Cm[idx],
-               m_pFull->Co[idx],
-               bayerGB[idxGB],
-               bayerGB[idxB],
-               bayerGB[idxR],
-               bayerGB[idxGR],
-               lossyBits);
+    withCfaQuad(cfa, [&](auto quad) {
+        for(std::size_t i = 0; i < m_height; i++) {
+            for(std::size_t j = 0; j < m_width; j++) {
+                std::size_t idx      = i * m_width + j;
+                std::uint16_t* upper = &bayerGB[2 * i * m_width_bayer + 2 * j];
+                std::uint16_t gb, b, r, gr;
+                DecoderBase::YCCC_to_BayerGB(
+                   m_pFull->Y[idx], m_pFull->Cd[idx], m_pFull->Cm[idx], m_pFull->Co[idx], gb, b, r, gr, lossyBits);
+                quad.scatter(upper, upper + m_width_bayer, gb, b, r, gr);
+            }
         }
-    }
+    });
 
 #ifdef TEST_OUT
     // clang-format off
@@ -311,13 +364,21 @@ void Decoder::toBayerGB(std::size_t lossyBits)
 */
 void Decoder::toFullAll()
 {
-    sQuadChannelCS full(m_pixelAmount);
+    if(!m_keepIntermediate) {   // reconstruct in place, dpcm plane becomes full plane
+        for(std::size_t chIdx = 0; chIdx < 4; chIdx++) {
+            auto channel = m_pDpcm->getChannel(chIdx).data();
+            toFull(channel, channel, getHeight(), getWidth());
+        };
+        m_pFull = std::move(m_pDpcm);
+    } else {
+        sQuadChannelCS full(m_width, m_height);
 
-    for(std::size_t chIdx = 0; chIdx < 4; chIdx++) {
-        toFull(m_pDpcm->getChannel(chIdx).data(), full.getChannel(chIdx).data(), getHeight(), getWidth());
-    };
+        for(std::size_t chIdx = 0; chIdx < 4; chIdx++) {
+            toFull(m_pDpcm->getChannel(chIdx).data(), full.getChannel(chIdx).data(), getHeight(), getWidth());
+        };
 
-    m_pFull = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(full));
+        m_pFull = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(full));
+    }
 
 #ifdef TEST_OUT
     // clang-format off
@@ -356,12 +417,15 @@ void Decoder::toFull(const std::int16_t* dpcm, std::int16_t* full, std::size_t h
 */
 void Decoder::decodeBitstreamAll(std::uint32_t N_threshold, std::uint32_t A_init)
 {
-    Reader reader{m_pFileData.get()->data(), m_pFileData.get()->size()};
+    Reader reader{m_pFileData.get()->data(), m_fileDataSize};
+    reader.loadFirstByte();
 
-    sQuadChannelCS quotients(m_pixelAmount);
-    sQuadChannelCS remainders(m_pixelAmount);
-    sQuadChannelCS kValues(m_pixelAmount);
-    sQuadChannelCS dpcm(m_pixelAmount);
+    // Symbol planes are only kept for debugging
+    const std::size_t debugLength = m_keepIntermediate ? m_pixelAmount : 0;
+    sQuadChannelCS quotients(debugLength);
+    sQuadChannelCS remainders(debugLength);
+    sQuadChannelCS kValues(debugLength);
+    sQuadChannelCS dpcm(m_width, m_height);
 
     for(std::size_t chIdx = 0; chIdx < 4; chIdx++) {
         std::size_t pixelCount = Decoder::decodeBitstream(
@@ -369,13 +433,17 @@ void Decoder::decodeBitstreamAll(std::uint32_t N_threshold, std::uint32_t A_init
            N_threshold,
            A_init,
            m_pixelAmount,
-           quotients.getChannel(chIdx).data(),
-           remainders.getChannel(chIdx).data(),
-           kValues.getChannel(chIdx).data(),
+           m_keepIntermediate ? quotients.getChannel(chIdx).data() : nullptr,
+           m_keepIntermediate ? remainders.getChannel(chIdx).data() : nullptr,
+           m_keepIntermediate ? kValues.getChannel(chIdx).data() : nullptr,
            dpcm.getChannel(chIdx).data());
         if(pixelCount != m_pixelAmount) {
             throw std::runtime_error("Number of decoded pixels does not match expected number of pixels!");
         }
+        if(reader.overrun()) {
+            handleReturnValue(BASE_ERROR_ALL_BYTES_ALREADY_READ);
+            throw std::runtime_error("Sequential decoding unsuccessful.");
+        }
     }
 
     // Test 2.2 GolombRice
@@ -408,10 +476,161 @@ void Decoder::decodeBitstreamAll(std::uint32_t N_threshold, std::uint32_t A_init
          << unsigned(remainders.Y[end - 1]) << '\n';   //
 #endif
 
+    if(m_keepIntermediate) {
+        m_pQuotients  = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(quotients));
+        m_pRemainders = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(remainders));
+        m_pkValues    = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(kValues));
+    }
+    m_pDpcm = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(dpcm));
+}
+
+/**
+ * Decodes channel planar data (OMLS_FLAG_CHANNEL_PLANAR). Each channel has its own offset in the header. By default
+ * all 4 channels are decoded row by row straight to BayerCFA keeping one row of YCCC, the same single pass
+ * DecoderSession uses. With setKeepIntermediate each channel is decoded on its own thread and all planes are kept.
+*/
+void Decoder::decodePlanar(const headerData_t& headerData)
+{
+    const std::uint8_t* payload = m_pFileData->data() + headerData.headerSize;
+
+    std::uint64_t offsets[5];
+    if(Reader::getChannelOffsets(m_pFileData->data(), m_fileDataSize, headerData, offsets)) {
+        throw std::runtime_error("Channel offsets in header are missing or invalid.");
+    }
+
+    m_width        = headerData.width / 2;
+    m_height       = headerData.height / 2;
+    m_pixelAmount  = m_width * m_height;
+    m_width_bayer  = 2 * m_width;
+    m_height_bayer = 2 * m_height;
+
+    std::cout << "\nUsing CPU: Planar decoding image size W x H : " << unsigned(headerData.width) << " x "
+              << unsigned(headerData.height) << std::endl;
+
+    const std::uint8_t* channelData[4];
+    std::size_t channelSize[4];
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        channelData[ch] = payload + offsets[ch];
+        channelSize[ch] = offsets[ch + 1] - offsets[ch];
+    }
+
+    if(!m_keepIntermediate) {
+        std::vector<std::int16_t> YCCC_row(4 * m_width);   // current row of Y, Cd, Cm and Co
+        auto toBayer = [&](auto* bayerGB) {
+            using T = std::remove_pointer_t<decltype(bayerGB)>;
+            return withCfaQuad(cfaPatternFromFlags(headerData.flags), [&](auto quad) {
+                BayerSink<T, decltype(quad)::pattern> sink{bayerGB, m_width, headerData.lossyBits};
+                auto decode = (headerData.flags & OMLS_FLAG_LSB_FIRST)
+                                 ? DecoderBase::decodeBitstreamPlanar_sink<ReaderLSB, decltype(sink)>
+                                 : DecoderBase::decodeBitstreamPlanar_sink<Reader, decltype(sink)>;
+                return decode(
+                   m_width_bayer,
+                   m_height_bayer,
+                   m_N_threshold,
+                   m_A_init,
+                   channelData,
+                   channelSize,
+                   YCCC_row.data(),
+                   sink,
+                   m_height);
+            });
+        };
+        STATUS_t status;
+        if(headerData.bpp == 8) {
+            m_pBayer_8bit = std::make_unique<std::vector<std::uint8_t>>(4 * m_pixelAmount);
+            status        = toBayer(m_pBayer_8bit->data());
+            m_pBayer_16bit.reset();
+        } else {
+            m_pBayer_16bit = std::make_unique<std::vector<std::uint16_t>>(4 * m_pixelAmount);
+            status         = toBayer(m_pBayer_16bit->data());
+            m_pBayer_8bit.reset();
+        }
+        if(status) {
+            handleReturnValue(status);
+            throw std::runtime_error("Planar decoding unsuccessful.");
+        }
+        return;
+    }
+
+    sQuadChannelCS quotients(m_pixelAmount);
+    sQuadChannelCS remainders(m_pixelAmount);
+    sQuadChannelCS kValues(m_pixelAmount);
+    sQuadChannelCS dpcm(m_pixelAmount);
+    sQuadChannelCS full(m_width, m_height);
+    STATUS_t status[4] = {BASE_SUCCESS, BASE_SUCCESS, BASE_SUCCESS, BASE_SUCCESS};
+
+    auto decodeChannel = [&](auto reader, std::size_t ch) {
+        reader.loadFirstByte();
+        std::size_t pixelCount = decodeBitstream(
+           reader,
+           m_N_threshold,
+           m_A_init,
+           m_pixelAmount,
+           quotients.getChannel(ch).data(),
+           remainders.getChannel(ch).data(),
+           kValues.getChannel(ch).data(),
+           dpcm.getChannel(ch).data());
+        if(pixelCount != m_pixelAmount || reader.overrun()) {
+            status[ch] = BASE_ERROR_ALL_BYTES_ALREADY_READ;
+            return;
+        }
+        toFull(dpcm.getChannel(ch).data(), full.getChannel(ch).data(), m_height, m_width);
+    };
+
+    std::thread threads[4];
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        if(headerData.flags & OMLS_FLAG_LSB_FIRST) {
+            threads[ch] = std::thread(decodeChannel, ReaderLSB{channelData[ch], channelSize[ch]}, ch);
+        } else {
+            threads[ch] = std::thread(decodeChannel, Reader{channelData[ch], channelSize[ch]}, ch);
+        }
+    }
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        threads[ch].join();
+    }
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        if(status[ch]) {
+            handleReturnValue(status[ch]);
+            throw std::runtime_error("Planar decoding unsuccessful.");
+        }
+    }
+
+    auto toBayer = [&](auto* bayerGB) {
+        withCfaQuad(cfaPatternFromFlags(headerData.flags), [&](auto quad) {
+            using T = std::remove_pointer_t<decltype(bayerGB)>;
+            BayerSink<T, decltype(quad)::pattern> sink{bayerGB, m_width, headerData.lossyBits};
+            for(std::size_t i = 0; i < m_height; i++) {
+                for(std::size_t j = 0; j < m_width; j++) {
+                    std::size_t idx = i * m_width + j;
+                    sink.put(i, j, full.Y[idx], full.Cd[idx], full.Cm[idx], full.Co[idx]);
+                }
+            }
+        });
+    };
+    if(headerData.bpp == 8) {
+        m_pBayer_8bit = std::make_unique<std::vector<std::uint8_t>>(4 * m_pixelAmount);
+        toBayer(m_pBayer_8bit->data());
+        m_pBayer_16bit.reset();
+    } else {
+        m_pBayer_16bit = std::make_unique<std::vector<std::uint16_t>>(4 * m_pixelAmount);
+        toBayer(m_pBayer_16bit->data());
+        m_pBayer_8bit.reset();
+    }
+
     m_pQuotients  = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(quotients));
     m_pRemainders = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(remainders));
     m_pkValues    = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(kValues));
     m_pDpcm       = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(dpcm));
+    m_pFull       = std::make_unique<sQuadChannelCS>(std::forward<sQuadChannelCS>(full));
+}
+
+/**
+ * Keep quotient, remainder, k, dpcm and full planes after decoding (for debugging). By default sequential and
+ * planar decoding go straight to BayerCFA with one row of YCCC as scratch.
+*/
+void Decoder::setKeepIntermediate(bool keep)
+{
+    m_keepIntermediate = keep;
 }
 
 /**
@@ -419,8 +638,9 @@ void Decoder::decodeBitstreamAll(std::uint32_t N_threshold, std::uint32_t A_init
  * continuing from the byte with index <bytesRead>.
  * Returns number of read quotients and remainders.
 */
+template<typename R>
 std::size_t Decoder::decodeBitstream(
-   Reader& reader,
+   R& reader,
    std::uint32_t N_threshold,
    std::uint32_t A_init,
    std::size_t length,
@@ -443,12 +663,14 @@ std::size_t Decoder::decodeBitstream(
         lastBit  = reader.fetchBit();
         posValue = (posValue << 1) | lastBit;
     }
-    dpcm_curr = DecoderBase::fromAbs(posValue);
+    dpcm_curr = (std::int16_t)posValue;   // seed is coded in two's complement
 
-    quotients[0]  = dpcm_curr;
-    remainders[0] = dpcm_curr;
-    kValues[0]    = -1;
-    dpcm[0]       = dpcm_curr;
+    if(quotients) {   // symbols are stored only when requested (debugging)
+        quotients[0]  = dpcm_curr;
+        remainders[0] = dpcm_curr;
+        kValues[0]    = -1;
+    }
+    dpcm[0] = dpcm_curr;
 
     for(idx = 1; idx < length; idx++) {
 
@@ -489,10 +711,12 @@ std::size_t Decoder::decodeBitstream(
         }
         A = A < A_MIN ? A_MIN : A;
 
-        quotients[idx]  = q;
-        remainders[idx] = r;
-        kValues[idx]    = k;
-        dpcm[idx]       = dpcm_curr;
+        if(quotients) {
+            quotients[idx]  = q;
+            remainders[idx] = r;
+            kValues[idx]    = k;
+        }
+        dpcm[idx] = dpcm_curr;
     }
     return idx;
 }
@@ -503,28 +727,26 @@ std::size_t Decoder::decodeBitstream(
 */
 void Decoder::importBitstream(const char* fileName)
 {
-    STATUS_t stat = DecoderBase::importBitstream(fileName, m_pFileData);
+    STATUS_t stat = DecoderBase::importBitstream(fileName, m_pFileData, m_fileDataSize);
     if(stat) {
         char msg[200];
         sprintf(msg, "OMLS Error: %u:Error while importing bitstream: %s", stat, fileName);
         throw std::runtime_error(msg);
         // throw std::runtime_error("Error while importing bitstream");
     };
+};
 
-    // std::ifstream rf(fileName, std::ios::in | std::ios::binary);
-    // if(!rf) {
-    //     char msg[100];
-    //     sprintf(msg, "Cannot open specified file: %s", fileName);
-    //     throw std::runtime_error(msg);
-    // }
-
-    // std::vector<std::uint8_t> inputBytes(
-    //    (std::istreambuf_iterator<char>(rf)),   //
-    //    (std::istreambuf_iterator<char>()));
-
-    // rf.close();
-
-    // m_pFileData = std::make_unique<std::vector<std::uint8_t>>(std::forward<std::vector<std::uint8_t>>(inputBytes));
+/**
+ * Copies bitstream from memory. The pointer to the copy is then assigned to member m_pFileData.
+*/
+void Decoder::importBitstream(const std::uint8_t* data, std::size_t dataSize)
+{
+    STATUS_t stat = DecoderBase::importBitstream(data, dataSize, m_pFileData, m_fileDataSize);
+    if(stat) {
+        char msg[200];
+        sprintf(msg, "OMLS Error: %u:Error while importing bitstream from memory", stat);
+        throw std::runtime_error(msg);
+    };
 };
 
 /** Get width.*/
@@ -8,17 +8,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
-
-struct headerData_t {
-    std::uint64_t timestamp;
-    std::uint64_t roi;
-    std::uint16_t width;
-    std::uint16_t height;
-    std::uint8_t unaryMaxWidth;
-    std::uint8_t bpp;
-    std::uint8_t lossyBits;
-    std::uint8_t reserved;
-};
+#include <thread>
 
 class Decoder : public DecoderBase
 {
@@ -31,8 +21,10 @@ class Decoder : public DecoderBase
     std::uint16_t m_k_min      = 0;
     std::size_t m_N_threshold  = 0;
     std::size_t m_A_init       = 0;
+    bool m_keepIntermediate    = false;
 
-    std::unique_ptr<std::vector<std::uint8_t>> m_pFileData;
+    std::unique_ptr<std::vector<std::uint8_t>> m_pFileData;   // bitstream followed by OMLS_INPUT_GUARD_BYTES
+    std::size_t m_fileDataSize = 0;   // bitstream size without guard bytes
     std::unique_ptr<sQuadChannelCS> m_pQuotients;
     std::unique_ptr<sQuadChannelCS> m_pRemainders;
     std::unique_ptr<sQuadChannelCS> m_pkValues;
@@ -51,12 +43,16 @@ class Decoder : public DecoderBase
        std::uint32_t A_init,
        std::uint32_t N_threshold);
     Decoder(const char* fileName, std::uint32_t A_init, std::uint32_t N_threshold);
+    Decoder(const std::uint8_t* data, std::size_t dataSize, std::uint32_t A_init, std::uint32_t N_threshold);
 
     void decodeSequentially(std::size_t lossyBits);
     headerData_t decodeParallel();
     headerData_t decodeParallelGPU();
+    void decodePlanar(const headerData_t& headerData);
+    void setKeepIntermediate(bool keep);
+    template<typename R = Reader>
     std::size_t decodeBitstream(
-       Reader& reader,
+       R& reader,
        std::uint32_t N_threshold,
        std::uint32_t A_init,
        std::size_t length,
@@ -67,7 +63,7 @@ class Decoder : public DecoderBase
 
     void exportBayerImage(const char* fileName, std::uint64_t addHeader, std::uint64_t roi, std::uint64_t timestamp);
     void exportBayerImage(const char* fileName, std::uint8_t* data, std::size_t yccc_width, std::size_t yccc_height);
-    void toBayerGB(std::size_t lossyBits);
+    void toBayerGB(std::size_t lossyBits, cfaPattern cfa = cfaPattern::gbrg);
     static void YCCC_to_BayerGB(
        const std::int16_t y,
        const std::int16_t cd,
@@ -82,6 +78,7 @@ class Decoder : public DecoderBase
     void toFull(const std::int16_t* src, std::int16_t* dst, std::size_t height, std::size_t width);
     void decodeBitstreamAll(std::uint32_t N_threshold, std::uint32_t A_init);
     void importBitstream(const char* fileName);
+    void importBitstream(const std::uint8_t* data, std::size_t dataSize);
     void readBitstreamOnChannel(Reader reader, uQuadChannelCS::Channel ch);
 
     std::size_t getWidth() const;
@@ -69,13 +69,9 @@ std::uint32_t Reader::fetchBit_impl(
    std::size_t& byteIdx,
    std::uint8_t& byte)
 {
-    if(byteIdx == bitStream_size) {
-        std::cout << "All bytes have been read." << std::endl;
-        throw(BASE_ERROR_ALL_BYTES_ALREADY_READ);
-    }
     if(bitsReadFromByte == 8) {
         bitsReadFromByte = 0;
-        (byteIdx)++;
+        byteIdx += byteIdx < bitStream_size + OMLS_INPUT_GUARD_BYTES - 1;   // saturate at last guard byte
         byte = bitStream[byteIdx];   //update only if it all bits have been read
     }
     // todo: consider changing bit order so that there is only bitshift for 1 bit >> 1
@@ -132,10 +128,148 @@ STATUS_t Reader::getTimestampAndCompressionInfoFromHeader(
         bpp = 8;
     }
 
-    if(width % 16 != 0 || height % 16 != 0 || (bpp != 8 && bpp != 10 && bpp != 12)) {
+    if(width % OMLS_SIZE_MULTIPLE != 0 || height % OMLS_SIZE_MULTIPLE != 0 || !isSupportedBpp(bpp)) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+
+    // Reserved byte carries format flags, unknown ones mean the stream cannot be decoded correctly
+    if(reserved & ~OMLS_FLAGS_SUPPORTED) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+
+    return BASE_SUCCESS;
+}
+
+STATUS_t Reader::getHeader(const std::uint8_t* bitStream, std::size_t bitStreamSize, headerData_t& header)
+{
+    if(bitStreamSize < OMLS_HEADER_MAGIC_SIZE || memcmp(bitStream, OMLS_HEADER_MAGIC, OMLS_HEADER_MAGIC_SIZE) != 0) {
+        // Version 1
+        if(bitStreamSize < OMLS_HEADER_V1_SIZE) {
+            return BASE_ERROR_HEADER_DATA_INVALID;
+        }
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint8_t unaryMaxWidth;
+        RETURN_ON_FAILURE(Reader::getTimestampAndCompressionInfoFromHeader(
+           bitStream,
+           header.timestamp,
+           header.roi,
+           width,
+           height,
+           unaryMaxWidth,
+           header.bpp,
+           header.lossyBits,
+           header.reserved));
+        header.width         = width;
+        header.height        = height;
+        header.unaryMaxWidth = unaryMaxWidth;
+        header.version       = 1;
+#ifdef ROI_NOT_INCLUDED
+        header.headerSize = OMLS_HEADER_V1_SIZE - 8;
+#else
+        header.headerSize = OMLS_HEADER_V1_SIZE;
+#endif
+        header.flags = header.reserved;
+        return BASE_SUCCESS;
+    }
+
+    if(bitStreamSize < OMLS_HEADER_V2_SIZE) {
         return BASE_ERROR_HEADER_DATA_INVALID;
     }
+    OmlsHeaderV2_t v2;
+    memcpy(&v2, bitStream, sizeof(v2));
+
+    if(v2.version < 2 || v2.version > OMLS_HEADER_VERSION) {
+        std::cout << "Unsupported header version: " << v2.version << std::endl;
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+    if(v2.headerLength < OMLS_HEADER_V2_SIZE || v2.headerLength % 8 != 0 || v2.headerLength > bitStreamSize) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+    if(v2.flags & ~OMLS_FLAGS_SUPPORTED) {
+        std::cout << "Unsupported header flags: 0x" << std::hex << v2.flags << std::dec << std::endl;
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+    if(v2.width % OMLS_SIZE_MULTIPLE != 0 || v2.height % OMLS_SIZE_MULTIPLE != 0 || !isSupportedBpp(v2.bpp) || v2.unaryMaxWidth == 0 ||
+       v2.lossyBits >= v2.bpp) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+    // Channel planar coding keeps int16_t planes and 16-bit seeds
+    if(v2.flags & OMLS_FLAG_CHANNEL_PLANAR && v2.bpp > OMLS_YCCC16_MAX_BPP) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+
+    // Extensions must tile the rest of the header exactly
+    std::size_t offset = OMLS_HEADER_V2_SIZE;
+    while(offset < v2.headerLength) {
+        std::uint16_t extLength;
+        memcpy(&extLength, &bitStream[offset + 2], sizeof(extLength));
+        offset += (OMLS_HEADER_EXT_SIZE + extLength + 7) & ~(std::size_t)7;
+    }
+    if(offset != v2.headerLength) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+
+    header.timestamp     = v2.timestamp;
+    header.roi           = v2.roi;
+    header.width         = v2.width;
+    header.height        = v2.height;
+    header.unaryMaxWidth = v2.unaryMaxWidth;
+    header.bpp           = v2.bpp;
+    header.lossyBits     = v2.lossyBits;
+    header.reserved      = 0;
+    header.version       = v2.version;
+    header.headerSize    = v2.headerLength;
+    header.flags         = v2.flags;
+    return BASE_SUCCESS;
+}
+
+bool Reader::findHeaderExtension(
+   const std::uint8_t* bitStream,
+   const headerData_t& header,
+   std::uint16_t type,
+   const std::uint8_t*& payload,
+   std::uint16_t& length)
+{
+    if(header.version < 2) {
+        return false;
+    }
+    // Layout was validated by getHeader
+    std::size_t offset = OMLS_HEADER_V2_SIZE;
+    while(offset < header.headerSize) {
+        std::uint16_t extType;
+        std::uint16_t extLength;
+        memcpy(&extType, &bitStream[offset], sizeof(extType));
+        memcpy(&extLength, &bitStream[offset + 2], sizeof(extLength));
+        if(extType == type) {
+            payload = &bitStream[offset + OMLS_HEADER_EXT_SIZE];
+            length  = extLength;
+            return true;
+        }
+        offset += (OMLS_HEADER_EXT_SIZE + extLength + 7) & ~(std::size_t)7;
+    }
+    return false;
+}
 
+STATUS_t Reader::getChannelOffsets(
+   const std::uint8_t* bitStream,
+   std::size_t bitStreamSize,
+   const headerData_t& header,
+   std::uint64_t (&offsets)[5])
+{
+    const std::uint8_t* payload;
+    std::uint16_t length;
+    if(!Reader::findHeaderExtension(bitStream, header, OMLS_EXT_CHANNEL_OFFSETS, payload, length) ||
+       length != 4 * sizeof(std::uint64_t)) {
+        return BASE_ERROR_HEADER_DATA_INVALID;
+    }
+    memcpy(offsets, payload, length);
+    offsets[4] = bitStreamSize - header.headerSize;
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        if(offsets[ch] > offsets[ch + 1]) {
+            return BASE_ERROR_HEADER_DATA_INVALID;
+        }
+    }
     return BASE_SUCCESS;
 }
 
@@ -180,29 +314,59 @@ std::int16_t DecoderBase::fromAbs(std::uint16_t absValue)
     }
 };
 
+std::int32_t DecoderBase::fromAbs(std::uint32_t absValue)
+{
+    if(absValue % 2 == 0) {
+        return absValue / 2;
+    } else {
+        return -(std::int32_t)((absValue + 1) / 2);
+    }
+};
+
 /**
- * Reads bitstream from fileName. Interprets first 4 bytes as image resolution.
- * The pointer to the bitstream data is then assigned to member m_pFileData.
+ * Reads bitstream from fileName into outData, followed by OMLS_INPUT_GUARD_BYTES zero bytes.
+ * @param dataSize is set to the file size.
 */
-STATUS_t DecoderBase::importBitstream(const char* fileName, std::unique_ptr<std::vector<std::uint8_t>>& outData)
+STATUS_t DecoderBase::importBitstream(
+   const char* fileName,
+   std::unique_ptr<std::vector<std::uint8_t>>& outData,
+   std::size_t& dataSize)
 {
-    std::ifstream rf(fileName, std::ios::in | std::ios::binary);
+    std::ifstream rf(fileName, std::ios::in | std::ios::binary | std::ios::ate);
     if(!rf) {
         return BASE_CANNOT_OPEN_INPUT_FILE;
     }
 
-    std::vector<std::uint8_t> inputBytes(
-       (std::istreambuf_iterator<char>(rf)),   //
-       (std::istreambuf_iterator<char>()));
+    dataSize = rf.tellg();
+    rf.seekg(0, std::ios::beg);
 
-    outData =
-       std::move(std::make_unique<std::vector<std::uint8_t>>(std::forward<std::vector<std::uint8_t>>(inputBytes)));
+    outData = std::make_unique<std::vector<std::uint8_t>>(dataSize + OMLS_INPUT_GUARD_BYTES);   // zero initialized
+    rf.read(reinterpret_cast<char*>(outData->data()), dataSize);
 
+    if(!rf) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
     rf.close();
 
     return BASE_SUCCESS;
 };
 
+/**
+ * Copies bitstream of @param size bytes from memory into outData, followed by OMLS_INPUT_GUARD_BYTES zero bytes.
+*/
+STATUS_t DecoderBase::importBitstream(
+   const std::uint8_t* data,
+   std::size_t size,
+   std::unique_ptr<std::vector<std::uint8_t>>& outData,
+   std::size_t& dataSize)
+{
+    outData = std::make_unique<std::vector<std::uint8_t>>(size + OMLS_INPUT_GUARD_BYTES);
+    memcpy(outData->data(), data, size);
+    dataSize = size;
+
+    return BASE_SUCCESS;
+};
+
 STATUS_t DecoderBase::handleReturnValue(STATUS_t status)
 {
     switch(status) {
@@ -238,6 +402,24 @@ STATUS_t DecoderBase::handleReturnValue(STATUS_t status)
         case BASE_OPENCL_ERROR:
             std::cout << "DecoderBase: OpenCL error." << std::endl;
             break;
+        case BASE_OUTPUT_DESCRIPTOR_INVALID:
+            std::cout << "DecoderBase: Output descriptor invalid error." << std::endl;
+            break;
+        case BASE_ARCHIVE_INVALID:
+            std::cout << "DecoderBase: Archive is not valid or its index is missing." << std::endl;
+            break;
+        case BASE_FRAME_NOT_FOUND:
+            std::cout << "DecoderBase: Frame not found in archive." << std::endl;
+            break;
+        case BASE_RING_INVALID:
+            std::cout << "DecoderBase: Shared memory ring is not valid or not initialized yet." << std::endl;
+            break;
+        case BASE_IMAGE_INVALID:
+            std::cout << "DecoderBase: Image file is not a supported PPM, PGM or PNG image." << std::endl;
+            break;
+        case BASE_LINE_SEGMENT_INVALID:
+            std::cout << "DecoderBase: Line-scan stream segment is invalid or truncated." << std::endl;
+            break;
         default:
             std::cout << "DecoderBase: Unknown error." << std::endl;
             break;
@@ -256,9 +438,9 @@ void createMissingDirectory(const char* folder_out)
     char out_path[500];
 
     if(!path(folder_out).is_absolute()) {
-        sprintf_s(out_path, "./%s", folder_out);
+        snprintf(out_path, sizeof(out_path), "./%s", folder_out);
     } else {
-        sprintf_s(out_path, "%s", folder_out);
+        snprintf(out_path, sizeof(out_path), "%s", folder_out);
     };
     //}
 
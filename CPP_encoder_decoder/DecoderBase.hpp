@@ -1,9 +1,15 @@
 #pragma once
 
+#include "Cfa.hpp"
+#include "OmlsHeader.hpp"
+#include "YcccType.hpp"
 #include "globalDefines.hpp"
 
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include <filesystem>
@@ -47,6 +53,12 @@ enum
     BASE_ERROR_HEADER_NOT_ALIGNED     = 10,
     BASE_ERROR_HEADER_DATA_INVALID    = 11,
     BASE_OPENCL_ERROR                 = 12,
+    BASE_OUTPUT_DESCRIPTOR_INVALID    = 13,
+    BASE_ARCHIVE_INVALID              = 14,
+    BASE_FRAME_NOT_FOUND              = 15,
+    BASE_RING_INVALID                 = 16,
+    BASE_IMAGE_INVALID                = 17,
+    BASE_LINE_SEGMENT_INVALID         = 18,
 };
 
 /*
@@ -68,7 +80,8 @@ struct Reader {
     Reader(const std::uint8_t* bitStream, const std::size_t bitStreamSize);
 
     /*
-    * Fetches single bit.
+    * Fetches single bit. Does not check for the end of bitstream: bitStream must be followed by
+    * OMLS_INPUT_GUARD_BYTES readable bytes. Byte index saturates at the last guard byte, check overrun() afterwards.
     */
     static std::uint32_t fetchBit_impl(
        const std::uint8_t* bitStream,
@@ -119,6 +132,38 @@ struct Reader {
         return Reader::fetchBit_impl(m_bitStream, m_bitStreamSize, m_bitsReadFromByte, m_byteIdx, m_byte);
     }
 
+    /**
+     * Fetches @param n bits and assembles them LSB first (remainders and escape values).
+     */
+    std::uint32_t fetchBits(std::size_t n)
+    {
+        std::uint32_t value = 0;
+        for(std::size_t i = 0; i < n; i++) {
+            value |= fetchBit() << i;
+        }
+        return value;
+    }
+
+    /**
+     * Counts '1's until delimiter '0' is read or @param maxOnes is reached (delimiter is then not read).
+     */
+    std::uint32_t fetchUnary(std::size_t maxOnes)
+    {
+        std::uint32_t ones = 0;
+        while(ones < maxOnes && fetchBit() == 1) {
+            ones++;
+        }
+        return ones;
+    }
+
+    /*
+    * Returns true if more bits have been fetched than bitstream contains.
+    */
+    bool overrun() const
+    {
+        return m_byteIdx * 8 + m_bitsReadFromByte > m_bitStreamSize * 8;
+    }
+
     /*
     * Gets timestamp from bitstream[0:7]
     */
@@ -160,6 +205,125 @@ struct Reader {
        std::uint8_t& bpp,
        std::uint8_t& lossyBits,
        std::uint8_t& reserved);
+
+    /*
+    * Parses header of either version into @param header without copying the stream. Version 1 streams
+    * are read by getTimestampAndCompressionInfoFromHeader. @param bitStreamSize is size of the whole file.
+    */
+    static STATUS_t getHeader(const std::uint8_t* bitStream, std::size_t bitStreamSize, headerData_t& header);
+
+    /*
+    * Finds extension @param type in version 2 header. Sets @param payload to point into bitStream.
+    * Returns false if header has no such extension.
+    */
+    static bool findHeaderExtension(
+       const std::uint8_t* bitStream,
+       const headerData_t& header,
+       std::uint16_t type,
+       const std::uint8_t*& payload,
+       std::uint16_t& length);
+
+    /*
+    * Gets byte offsets of Y, Cd, Cm and Co bitstreams of channel planar stream, relative to header end.
+    * @param offsets[4] is set to bitstream size, so channel size is offsets[ch + 1] - offsets[ch].
+    */
+    static STATUS_t getChannelOffsets(
+       const std::uint8_t* bitStream,
+       std::size_t bitStreamSize,
+       const headerData_t& header,
+       std::uint64_t (&offsets)[5]);
+};
+
+static_assert(OMLS_INPUT_GUARD_BYTES >= sizeof(std::uint64_t), "ReaderLSB loads whole 64-bit words");
+
+/*
+* Bitstream reader for streams packed LSB first (OMLS_FLAG_LSB_FIRST). Bit n of the stream is bit (n % 64) of
+* the little-endian 64-bit word starting at byte n / 8, so every fetch is a single unaligned load and shift.
+* Has the same fetch interface as Reader, so decoders can be instantiated with either.
+* Like Reader, it relies on OMLS_INPUT_GUARD_BYTES after the bitstream instead of checking bounds on every fetch.
+*/
+struct ReaderLSB {
+    const std::uint8_t* m_bitStream = nullptr;
+    std::size_t m_bitStreamSize     = 0;
+    std::size_t m_bitPos            = 0;
+
+    ReaderLSB(const std::uint8_t* bitStream, const std::size_t bitStreamSize)
+       : m_bitStream(bitStream)
+       , m_bitStreamSize(bitStreamSize){};
+
+    /*
+    * Nothing to preload, kept for interface compatibility with Reader.
+    */
+    void loadFirstByte(){};
+
+    /*
+    * Returns next bits of the stream in LSB of result. At least 57 bits are valid, upper bits are zero.
+    */
+    std::uint64_t peek() const
+    {
+        const std::size_t lastByteIdx = m_bitStreamSize + OMLS_INPUT_GUARD_BYTES - sizeof(std::uint64_t);
+        std::size_t byteIdx           = m_bitPos >> 3;
+        byteIdx                       = byteIdx < lastByteIdx ? byteIdx : lastByteIdx;   // saturate inside guard
+        std::uint64_t word;
+        memcpy(&word, &m_bitStream[byteIdx], sizeof(word));
+        if constexpr(std::endian::native == std::endian::big) {
+            word = __builtin_bswap64(word);
+        }
+        return word >> (m_bitPos & 7);
+    }
+
+    void consume(std::size_t n)
+    {
+        m_bitPos += n;
+    }
+
+    /*
+    * Returns true if more bits have been fetched than bitstream contains.
+    */
+    bool overrun() const
+    {
+        return m_bitPos > m_bitStreamSize * 8;
+    }
+
+    std::uint32_t fetchBit()
+    {
+        std::uint32_t bit = (std::uint32_t)(peek() & 1);
+        consume(1);
+        return bit;
+    }
+
+    /**
+     * Fetches @param n <= 32 bits, LSB first.
+     */
+    std::uint32_t fetchBits(std::size_t n)
+    {
+        std::uint32_t value = (std::uint32_t)(peek() & ((1LLU << n) - 1));
+        consume(n);
+        return value;
+    }
+
+    /**
+     * Counts '1's until delimiter '0' is read or @param maxOnes is reached (delimiter is then not read).
+     */
+    std::uint32_t fetchUnary(std::size_t maxOnes)
+    {
+        const std::uint32_t validBits = 56;   // peek() guarantees 57, keep one as possible delimiter
+        std::uint32_t ones            = 0;
+        while(true) {
+            std::uint32_t run = std::countr_one(peek());
+            run               = run > validBits ? validBits : run;
+            if(ones + run >= maxOnes) {
+                consume(maxOnes - ones);
+                return maxOnes;
+            }
+            if(run < validBits) {
+                consume(run + 1);   // ones and delimiter
+                return ones + run;
+            }
+            consume(validBits);
+            ones += validBits;
+        }
+    }
 };
 
 /**
@@ -180,13 +344,18 @@ inline std::uint32_t getMSBfirst(std::uint32_t lsb, std::size_t validBits)
      */
 inline void reverseByteOrder_16bytes(const std::uint8_t* bitStream, std::uint8_t* dest);
 
+template<typename T, cfaPattern P = cfaPattern::gbrg>
+struct BayerSink;
+
 struct DecoderBase {
 
     /**
  * @param width_a and @param height_a are full image width and height.
- * BayerCFA image.
+ * BayerCFA image in CFA pattern @param cfa. Reader R selects bit packing order: Reader (MSB first) or ReaderLSB
+ * (OMLS_FLAG_LSB_FIRST). @param bitStream must be followed by OMLS_INPUT_GUARD_BYTES readable bytes (see
+ * importBitstream).
  */
-    template<typename T>
+    template<typename T, typename R = Reader>
     static STATUS_t decodeBitstreamParallel_actual(
        std::size_t width_a,
        std::size_t height_a,
@@ -196,73 +365,111 @@ struct DecoderBase {
        const std::uint8_t* bitStream,
        const std::size_t bitStreamSize,
        T* bayerGB,
-       std::size_t bayerGBSize)
+       std::size_t bayerGBSize,
+       cfaPattern cfa = cfaPattern::gbrg)
+    {
+        // Check if full decompressed image buffer is large enough. Multply by 4 because there are Gb,B,R & Gr channels.
+        if(2 * (width_a / 2) * 2 * (height_a / 2) != bayerGBSize) {
+            fprintf(
+               stdout,
+               "DecoderBase: expected size of output buffer: %zu, actual size: %zu (bpp: %zu)\n",
+               2 * (width_a / 2) * 2 * (height_a / 2),
+               bayerGBSize,
+               bpp_a);
+            return BASE_OUTPUT_BUFFER_FALSE_SIZE;
+        }
+
+        return withCfaQuad(cfa, [&](auto quad) {
+            BayerSink<T, decltype(quad)::pattern> sink{bayerGB, width_a / 2, lossyBits_a};
+            return decodeBitstreamParallel_sink<R>(
+               width_a, height_a, unaryMaxWidth_a, bpp_a, bitStream, bitStreamSize, sink, height_a / 2);
+        });
+    }
+
+    /**
+ * Parallel decoding core. Each reconstructed YCCC quad is handed to @param sink (see BayerSink), which decides
+ * what is written where. @param width_a and @param height_a are full image width and height.
+ * Parsing stops after @param rowEnd quad rows, rest of the bitstream is not read (ROI decoding).
+ */
+    template<typename R, typename S>
+    static STATUS_t decodeBitstreamParallel_sink(
+       std::size_t width_a,
+       std::size_t height_a,
+       std::size_t unaryMaxWidth_a,
+       std::size_t bpp_a,
+       const std::uint8_t* bitStream,
+       const std::size_t bitStreamSize,
+       S& sink,
+       std::size_t rowEnd)
+    {
+        return withYcccType(bpp_a, [&](auto v) {
+            return decodeBitstreamParallel_core<R, decltype(v)>(
+               width_a, height_a, unaryMaxWidth_a, bpp_a, bitStream, bitStreamSize, sink, rowEnd);
+        });
+    }
+
+    /**
+ * decodeBitstreamParallel_sink with YCCC and dpcm values of type V (see withYcccType).
+ */
+    template<typename R, typename V, typename S>
+    static STATUS_t decodeBitstreamParallel_core(
+       std::size_t width_a,
+       std::size_t height_a,
+       std::size_t unaryMaxWidth_a,
+       std::size_t bpp_a,
+       const std::uint8_t* bitStream,
+       const std::size_t bitStreamSize,
+       S& sink,
+       std::size_t rowEnd)
     {
+        using U                   = std::make_unsigned_t<V>;
         std::uint32_t N_threshold = 8;
         std::uint32_t A_init      = 32;
 
-        Reader reader{bitStream, bitStreamSize};
+        R reader{bitStream, bitStreamSize};
 
         std::size_t width;
         std::size_t height;
-        std::size_t lossyBits;
         std::size_t unaryMaxWidth;
-        unaryMaxWidth        = unaryMaxWidth_a;
         width                = width_a / 2;
-        height               = height_a / 2;
-        lossyBits            = lossyBits_a;
+        height               = rowEnd < height_a / 2 ? rowEnd : height_a / 2;
         unaryMaxWidth        = unaryMaxWidth_a;
-        std::uint32_t k_seed = bpp_a + 3;   // max 12 BPP + 3 = 15
+        std::uint32_t k_seed = bpp_a + 3;   // max 16 BPP + 3 = 19
 
-        // Check if full decompressed image buffer is large enough. Multply by 4 because there are Gb,B,R & Gr channels.
-        if(2 * width * 2 * height != bayerGBSize) {
-            fprintf(
-               stdout,
-               "DecoderBase: expected size of output buffer: %zu, actual size: %zu (bpp: %zu)\n",
-               2 * width * 2 * height,
-               bayerGBSize,
-               bpp_a);
-            return BASE_OUTPUT_BUFFER_FALSE_SIZE;
+        if(height == 0) {
+            return BASE_SUCCESS;
         }
 
         reader.loadFirstByte();
 
-        std::uint32_t A[]        = {A_init, A_init, A_init, A_init};
-        std::uint32_t N          = N_START;
-        std::int16_t YCCC[]      = {0, 0, 0, 0};
-        std::int16_t YCCC_prev[] = {0, 0, 0, 0};
-        std::int16_t YCCC_up[]   = {0, 0, 0, 0};
+        std::uint32_t A[] = {A_init, A_init, A_init, A_init};
+        std::uint32_t N   = N_START;
+        V YCCC[]          = {0, 0, 0, 0};
+        V YCCC_prev[]     = {0, 0, 0, 0};
+        V YCCC_up[]       = {0, 0, 0, 0};
 
         // 1.) decode 4 seed pixels
         // Seed pixel
-        std::uint16_t posValue[] = {0, 0, 0, 0};
+        U posValue[] = {0, 0, 0, 0};
         for(std::size_t ch = 0; ch < 4; ch++) {
             // for(std::uint32_t n = k_SEED + 1; n > 0; n--) { // MSB first
             //     std::uint32_t lastBit = fetchBit(reader);
             //     posValue[ch]          = (posValue[ch] << 1) | lastBit;
             // }
             (void)reader.fetchBit();   // read delimiter
-            for(std::uint32_t n = 0; n < k_seed; n++) {   // LSB first
-                std::uint32_t lastBit = reader.fetchBit();
-                posValue[ch]          = posValue[ch] | ((std::uint16_t)lastBit << n);
-            };
-            YCCC[ch] = DecoderBase::fromAbs(posValue[ch]);
+            posValue[ch] = (U)reader.fetchBits(k_seed);   // LSB first
+            YCCC[ch]     = DecoderBase::fromAbs(posValue[ch]);
         }
 
         for(std::size_t ch = 0; ch < 4; ch++) {   //
             A[ch] += YCCC[ch] > 0 ? YCCC[ch] : -YCCC[ch];
         }
 
-        RETURN_ON_FAILURE(DecoderBase::YCCC_to_BayerGB<T>(
-           YCCC[0],
-           YCCC[1],
-           YCCC[2],
-           YCCC[3],
-           bayerGB[0],
-           bayerGB[1],
-           bayerGB[2 * width],
-           bayerGB[2 * width + 1],
-           lossyBits))
+        if(height * width == 1 && reader.overrun()) {
+            return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+        }
+
+        RETURN_ON_FAILURE(sink.put(0, 0, YCCC[0], YCCC[1], YCCC[2], YCCC[3]))
 
         memcpy(YCCC_up, YCCC, sizeof(YCCC));
         memcpy(YCCC_prev, YCCC, sizeof(YCCC));
@@ -270,10 +477,10 @@ struct DecoderBase {
         for(std::size_t idx = 1; idx < height * width; idx++) {
 
             // 2.) AGOR
-            std::uint16_t quotient[]  = {0, 0, 0, 0};
-            std::uint16_t remainder[] = {0, 0, 0, 0};
-            std::uint16_t k[]         = {0, 0, 0, 0};
-            std::int16_t dpcm_curr[]  = {0, 0, 0, 0};
+            U quotient[]      = {0, 0, 0, 0};
+            U remainder[]     = {0, 0, 0, 0};
+            std::uint16_t k[] = {0, 0, 0, 0};
+            V dpcm_curr[]     = {0, 0, 0, 0};
 
             for(std::size_t ch = 0; ch < 4; ch++) {
                 // for(std::size_t it = 0; it < 10; it++) {
@@ -284,31 +491,14 @@ struct DecoderBase {
                         k[ch] = k[ch];
                     }
                 }
-                std::uint32_t lastBit;
-
-                std::uint16_t absVal = 0;
-                do {   // decode quotient: unary coding
-                    lastBit = reader.fetchBit();
-                    if(lastBit == 1) {   //
-                        quotient[ch]++;
-                    }
-                } while(lastBit == 1 && quotient[ch] < unaryMaxWidth);
+                U absVal     = 0;
+                quotient[ch] = reader.fetchUnary(unaryMaxWidth);   // decode quotient: unary coding
 
                 /* m_unaryMaxWidth * '1' -> indicates binary coding of positive value */
                 if(quotient[ch] >= unaryMaxWidth) {
-                    // for(std::uint32_t n = 0; n < k_MAX; n++) {   //decode remainder
-                    for(std::uint32_t n = 0; n < k_seed; n++) {   //decode remainder
-                        lastBit = reader.fetchBit();
-                        absVal  = absVal | ((std::uint16_t)lastBit << n); /* LSB first */
-                        // absVal  = (absVal << 1) | lastBit; /* MSB first*/
-                    };
-
+                    absVal = (U)reader.fetchBits(k_seed); /* LSB first */
                 } else {
-                    for(std::uint32_t n = 0; n < k[ch]; n++) {   //decode remainder
-                        lastBit       = reader.fetchBit();
-                        remainder[ch] = remainder[ch] | ((std::uint16_t)lastBit << n); /* LSB first*/
-                        // remainder[ch] = (remainder[ch] << 1) | lastBit; /* MSB first*/
-                    };
+                    remainder[ch] = (U)reader.fetchBits(k[ch]); /* LSB first*/
                     absVal        = (quotient[ch] << k[ch]) + remainder[ch];
                 }
                 dpcm_curr[ch] = DecoderBase::fromAbs(absVal);
@@ -322,17 +512,7 @@ struct DecoderBase {
                 YCCC_prev[ch] = YCCC[ch];   // save pixel to be used as a reference for the next pixel
             }
 
-            std::size_t idxGB = (idx / width) * width * 4 + 2 * (idx % width);
-            RETURN_ON_FAILURE(DecoderBase::YCCC_to_BayerGB<T>(
-                                 YCCC[0],   //
-                                 YCCC[1],
-                                 YCCC[2],
-                                 YCCC[3],
-                                 bayerGB[idxGB],
-                                 bayerGB[idxGB + 1],
-                                 bayerGB[idxGB + 2 * width],
-                                 bayerGB[idxGB + 2 * width + 1],
-                                 lossyBits);)
+            RETURN_ON_FAILURE(sink.put(idx / width, idx % width, YCCC[0], YCCC[1], YCCC[2], YCCC[3]))
             N += 1;
             if(N >= N_threshold) {
                 N >>= 1;
@@ -345,14 +525,20 @@ struct DecoderBase {
             A[1] = A[1] < A_MIN ? A_MIN : A[1];
             A[2] = A[2] < A_MIN ? A_MIN : A[2];
             A[3] = A[3] < A_MIN ? A_MIN : A[3];
+
+            if((idx + 1) % width == 0 && reader.overrun()) {   // validated once per row, fetches are unchecked
+                return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+            }
         }
         return BASE_SUCCESS;
     }
 
     /**
  * @param width_a and @param height_a are related to channel size which is one half of the actual BayerCFA image.
- * BayerCFA image.
+ * BayerCFA image with samples of type T, uint8_t for 8 bpp, uint16_t for 10 and 12 bpp. Reader R selects bit
+ * packing order, see decodeBitstreamParallel_actual. Phases keep int16_t YCCC planes, deeper bpp is not supported.
  */
+    template<typename T, typename R = Reader>
     STATUS_t decodeBitstreamParallel_pseudo_gpu(
        std::size_t width_a,
        std::size_t height_a,
@@ -361,24 +547,26 @@ struct DecoderBase {
        std::size_t bpp_a,
        const std::uint8_t* bitStream,
        const std::size_t bitStreamSize,
-       std::uint8_t* bayerGB,
+       T* bayerGB,
        std::size_t bayerGBSize)
     {
 
         printf("Pseudo GPU decoding started!\n");
 
-        if(bpp_a != 8) {
+        if(bpp_a > 8 * sizeof(T) || bpp_a > OMLS_YCCC16_MAX_BPP) {
             fprintf(
                stdout,
-               "DecoderBase: bpp is not 8, but %zu. GPU decompression implemented only for 8 BPP.\n",
-               bpp_a);
+               "DecoderBase: bpp %zu does not fit %zu-bit output samples or exceeds %d BPP of GPU decompression.\n",
+               bpp_a,
+               8 * sizeof(T),
+               OMLS_YCCC16_MAX_BPP);
             return BASE_ERROR;
         }
 
         std::uint32_t N_threshold = 8;
         std::uint32_t A_init      = 32;
 
-        Reader reader{bitStream, bitStreamSize};
+        R reader{bitStream, bitStreamSize};
 
         std::size_t width;
         std::size_t height;
@@ -426,10 +614,7 @@ struct DecoderBase {
             //     posValue[ch]          = (posValue[ch] << 1) | lastBit;
             // }
             (void)reader.fetchBit();   // read delimiter
-            for(std::uint32_t n = 0; n < k_seed; n++) {   // LSB first
-                std::uint32_t lastBit = reader.fetchBit();
-                posValue[ch]          = posValue[ch] | ((std::uint16_t)lastBit << n);
-            };
+            posValue[ch] = (std::uint16_t)reader.fetchBits(k_seed);   // LSB first
             YCCC[0 + ch] = DecoderBase::fromAbs(posValue[ch]);
         }
 
@@ -437,6 +622,10 @@ struct DecoderBase {
             A[ch] += YCCC[0 + ch] > 0 ? YCCC[0 + ch] : -YCCC[0 + ch];
         }
 
+        if(height * width == 1 && reader.overrun()) {
+            return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+        }
+
         RETURN_ON_FAILURE(DecoderBase::YCCC_to_BayerGB(
            YCCC[0 + 0],
            YCCC[0 + 1],
@@ -474,30 +663,15 @@ struct DecoderBase {
                         k[ch] = k[ch];
                     }
                 }
-                std::uint32_t lastBit;
-
                 std::uint16_t absVal = 0;
-                do {   // decode quotient: unary coding
-                    lastBit = reader.fetchBit();
-                    if(lastBit == 1) {   //
-                        quotient[ch]++;
-                    }
-                } while(lastBit == 1 && quotient[ch] < unaryMaxWidth);
+                quotient[ch]         = reader.fetchUnary(unaryMaxWidth);   // decode quotient: unary coding
 
                 /* m_unaryMaxWidth * '1' -> indicates binary coding of positive value */
                 if(quotient[ch] >= unaryMaxWidth) {
-                    for(std::uint32_t n = 0; n < k_seed; n++) {   //decode remainder
-                        lastBit = reader.fetchBit();
-                        absVal  = absVal | ((std::uint16_t)lastBit << n); /* LSB first */
-                        // absVal  = (absVal << 1) | lastBit; /* MSB first*/
-                    };
+                    absVal = (std::uint16_t)reader.fetchBits(k_seed); /* LSB first */
                 } else {
-                    for(std::uint32_t n = 0; n < k[ch]; n++) {   //decode remainder
-                        lastBit       = reader.fetchBit();
-                        remainder[ch] = remainder[ch] | ((std::uint16_t)lastBit << n); /* LSB first*/
-                        // remainder[ch] = (remainder[ch] << 1) | lastBit; /* MSB first*/
-                    };
-                    absVal = quotient[ch] * (1 << k[ch]) + remainder[ch];
+                    remainder[ch] = (std::uint16_t)reader.fetchBits(k[ch]); /* LSB first*/
+                    absVal        = quotient[ch] * (1 << k[ch]) + remainder[ch];
                 }
 
                 // TODO: OPPORTUNITY: unsigned absVal to signed dpcm can also be done in parallel
@@ -521,6 +695,10 @@ struct DecoderBase {
             A[1] = A[1] < A_MIN ? A_MIN : A[1];
             A[2] = A[2] < A_MIN ? A_MIN : A[2];
             A[3] = A[3] < A_MIN ? A_MIN : A[3];
+
+            if((idx + 1) % width == 0 && reader.overrun()) {   // validated once per row, fetches are unchecked
+                return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+            }
         }
 
 #ifdef TIMING_EN
@@ -614,6 +792,166 @@ struct DecoderBase {
         return BASE_SUCCESS;
     }
 
+    /**
+ * Fused decoding of channel planar bitstream (OMLS_FLAG_CHANNEL_PLANAR): symbols to YCCC to BayerCFA in one pass.
+ * All 4 channels are read row by row through their own reader, so only one row per channel is kept in memory.
+ * @param width_a and @param height_a are full image width and height. @param channelData and
+ * @param channelSize describe Y, Cd, Cm and Co bitstreams, each followed by readable guard bytes.
+ * @param YCCC is caller provided scratch row of 4 * width_a / 2 elements.
+ */
+    template<typename T, typename R = Reader>
+    static STATUS_t decodeBitstreamPlanar_actual(
+       std::size_t width_a,
+       std::size_t height_a,
+       std::size_t lossyBits,
+       std::uint32_t N_threshold,
+       std::uint32_t A_init,
+       const std::uint8_t* const* channelData,
+       const std::size_t* channelSize,
+       std::int16_t* YCCC,
+       T* bayerGB,
+       std::size_t bayerGBSize,
+       cfaPattern cfa = cfaPattern::gbrg)
+    {
+        if(2 * (width_a / 2) * 2 * (height_a / 2) != bayerGBSize) {
+            fprintf(
+               stdout,
+               "DecoderBase: expected size of output buffer: %zu, actual size: %zu\n",
+               2 * (width_a / 2) * 2 * (height_a / 2),
+               bayerGBSize);
+            return BASE_OUTPUT_BUFFER_FALSE_SIZE;
+        }
+
+        return withCfaQuad(cfa, [&](auto quad) {
+            BayerSink<T, decltype(quad)::pattern> sink{bayerGB, width_a / 2, lossyBits};
+            return decodeBitstreamPlanar_sink<R>(
+               width_a, height_a, N_threshold, A_init, channelData, channelSize, YCCC, sink, height_a / 2);
+        });
+    }
+
+    /**
+ * Channel planar decoding core, see decodeBitstreamPlanar_actual. Reconstructed rows of YCCC quads are handed
+ * to @param sink one quad at a time. Parsing stops after @param rowEnd quad rows.
+ */
+    template<typename R, typename S>
+    static STATUS_t decodeBitstreamPlanar_sink(
+       std::size_t width_a,
+       std::size_t height_a,
+       std::uint32_t N_threshold,
+       std::uint32_t A_init,
+       const std::uint8_t* const* channelData,
+       const std::size_t* channelSize,
+       std::int16_t* YCCC,
+       S& sink,
+       std::size_t rowEnd)
+    {
+        R readers[] = {
+           R{channelData[0], channelSize[0]},
+           R{channelData[1], channelSize[1]},
+           R{channelData[2], channelSize[2]},
+           R{channelData[3], channelSize[3]}};
+
+        for(std::size_t ch = 0; ch < 4; ch++) {
+            readers[ch].loadFirstByte();
+        }
+        return decodeChannelsInterleaved(readers, width_a, height_a, N_threshold, A_init, YCCC, sink, rowEnd);
+    }
+
+    /**
+ * Decodes Y, Cd, Cm and Co row by row from @param readers, already positioned at the start of each channel.
+ * Channels may share one bitstream (sequential format) or have their own (channel planar format).
+ * @param YCCC is scratch row of 4 * width_a / 2 elements. Parsing stops after @param rowEnd quad rows.
+ */
+    template<typename R, typename S>
+    static STATUS_t decodeChannelsInterleaved(
+       R* readers,
+       std::size_t width_a,
+       std::size_t height_a,
+       std::uint32_t N_threshold,
+       std::uint32_t A_init,
+       std::int16_t* YCCC,
+       S& sink,
+       std::size_t rowEnd)
+    {
+        const std::size_t width  = width_a / 2;
+        const std::size_t height = rowEnd < height_a / 2 ? rowEnd : height_a / 2;
+
+        std::uint32_t A[]      = {A_init, A_init, A_init, A_init};
+        std::uint32_t N[]      = {N_START, N_START, N_START, N_START};
+        std::int16_t pixelUp[] = {0, 0, 0, 0};   // first pixel of previous row
+
+        for(std::size_t row = 0; row < height; row++) {
+            for(std::size_t ch = 0; ch < 4; ch++) {
+                RETURN_ON_FAILURE(decodeChannelRow(
+                   readers[ch], row, width, N_threshold, A[ch], N[ch], pixelUp[ch], &YCCC[ch * width]))
+            }
+
+            for(std::size_t col = 0; col < width; col++) {
+                RETURN_ON_FAILURE(
+                   sink.put(row, col, YCCC[col], YCCC[width + col], YCCC[2 * width + col], YCCC[3 * width + col]))
+            }
+        }
+        return BASE_SUCCESS;
+    }
+
+    /**
+ * Decodes one row of @param width full values of a single sequentially coded channel (16 bit two's complement
+ * seed, unlimited unary, MSB first remainders) into @param full. @param A, @param N and @param pixelUp carry
+ * the channel state from row to row, start with A_init, N_START and 0.
+ */
+    template<typename R>
+    static STATUS_t decodeChannelRow(
+       R& reader,
+       std::size_t row,
+       std::size_t width,
+       std::uint32_t N_threshold,
+       std::uint32_t& A,
+       std::uint32_t& N,
+       std::int16_t& pixelUp,
+       std::int16_t* full)
+    {
+        for(std::size_t col = 0; col < width; col++) {
+            std::int16_t dpcm;
+            if(row == 0 && col == 0) {
+                std::uint16_t seed = 0;
+                for(std::size_t n = 0; n < 16; n++) {   // two's complement, MSB first
+                    seed = (seed << 1) | reader.fetchBit();
+                }
+                dpcm = (std::int16_t)seed;
+            } else {
+                std::uint16_t k = 0;
+                while((N << k) < A) {
+                    k++;
+                }
+                std::uint32_t q = reader.fetchUnary((std::size_t)-1);   // unlimited unary
+                std::uint32_t r = 0;
+                for(std::uint16_t n = 0; n < k; n++) {   // MSB first
+                    r = (r << 1) | reader.fetchBit();
+                }
+                dpcm = DecoderBase::fromAbs((std::uint16_t)((q << k) + r));
+
+                A += dpcm > 0 ? dpcm : -dpcm;
+                N += 1;
+                if(N >= N_threshold) {
+                    N /= 2;
+                    A /= 2;
+                }
+                A = A < A_MIN ? A_MIN : A;
+            }
+
+            if(col == 0) {   // first column is predicted from pixel one row up
+                full[0] = pixelUp + dpcm;
+                pixelUp = full[0];
+            } else {
+                full[col] = full[col - 1] + dpcm;
+            }
+        }
+        if(reader.overrun()) {   // validated once per row, fetches are unchecked
+            return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+        }
+        return BASE_SUCCESS;
+    }
+
     // template<typename T>
     static STATUS_t exportImage(
        const char* fileName,
@@ -661,17 +999,30 @@ struct DecoderBase {
     {
         createMissingDirectory(folderName);
         char path[500];
-        sprintf_s(path, "%s/%s", folderName, fileName);
+        snprintf(path, sizeof(path), "%s/%s", folderName, fileName);
 
         return DecoderBase::exportImage(path, data, data_size_bytes, header, roi, timestamp);
     }
 
-    static STATUS_t importBitstream(const char* fileName, std::unique_ptr<std::vector<std::uint8_t>>& outData);
+    /**
+     * Imports bitstream from file or memory into @param outData, followed by OMLS_INPUT_GUARD_BYTES zero bytes.
+     * @param dataSize is set to size of the bitstream without guard bytes.
+     */
+    static STATUS_t importBitstream(
+       const char* fileName,
+       std::unique_ptr<std::vector<std::uint8_t>>& outData,
+       std::size_t& dataSize);
+    static STATUS_t importBitstream(
+       const std::uint8_t* data,
+       std::size_t size,
+       std::unique_ptr<std::vector<std::uint8_t>>& outData,
+       std::size_t& dataSize);
 
     /**
    * Get DPCM value from Absolute value.
    */
     static std::int16_t fromAbs(std::uint16_t absValue);
+    static std::int32_t fromAbs(std::uint32_t absValue);
 
     /**
      * Transform from YCdCmCo to Bayer GB color space
@@ -680,13 +1031,14 @@ struct DecoderBase {
      * ---+--- =>  ---+---
      * Cm | Co =>  Rd | Gr
      *
+     * Sums are formed in YCCC type V, int16_t up to 12 bpp (see withYcccType).
      */
-    template<typename T>
+    template<typename T, typename V>
     static STATUS_t YCCC_to_BayerGB(
-       const std::int16_t y,
-       const std::int16_t cd,
-       const std::int16_t cm,
-       const std::int16_t co,
+       const V y,
+       const V cd,
+       const V cm,
+       const V co,
        T& gb,
        T& b,
        T& r,
@@ -713,13 +1065,154 @@ struct DecoderBase {
     //    return BASE_DIVISION_ERROR;
     //}
 
-    gr = (T)((std::int16_t)(2 * y +  2 * cd +  4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
-    r  = (T)((std::int16_t)(2 * y +  2 * cd + -4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
-    b  = (T)((std::int16_t)(2 * y +  2 * cd + -4 * cm + -6 * co) >> 3) << lossyBits;   // divide by 8
-    gb = (T)((std::int16_t)(2 * y + -6 * cd +  4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
+    gr = (T)((V)(2 * y +  2 * cd +  4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
+    r  = (T)((V)(2 * y +  2 * cd + -4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
+    b  = (T)((V)(2 * y +  2 * cd + -4 * cm + -6 * co) >> 3) << lossyBits;   // divide by 8
+    gb = (T)((V)(2 * y + -6 * cd +  4 * cm +  2 * co) >> 3) << lossyBits;   // divide by 8
         // clang-format on
         return BASE_SUCCESS;
     }
 
     static STATUS_t handleReturnValue(STATUS_t status);
 };
+
+/*
+* Output sinks of the decoding cores (decodeBitstreamParallel_sink, decodeBitstreamPlanar_sink).
+* put() receives YCCC quad at quad @param row and @param col (half resolution coordinates) in raster order, values
+* of the core's YCCC type V (see withYcccType).
+*/
+
+/**
+ * Writes quads as full resolution BayerCFA image of 2 * @param width quads per row, in CFA pattern P.
+*/
+template<typename T, cfaPattern P>
+struct BayerSink {
+    T* bayerGB;
+    std::size_t width;
+    std::size_t lossyBits;
+
+    template<typename V>
+    STATUS_t put(std::size_t row, std::size_t col, V y, V cd, V cm, V co)
+    {
+        T* quad = &bayerGB[row * 4 * width + 2 * col];
+        T gb, b, r, gr;
+        DecoderBase::YCCC_to_BayerGB<T>(y, cd, cm, co, gb, b, r, gr, lossyBits);
+        cfaQuad<P>::scatter(quad, quad + 2 * width, gb, b, r, gr);
+        return BASE_SUCCESS;
+    }
+};
+
+/**
+ * Writes only Y (sum of the 4 Bayer samples) as half resolution grey image, scaled from bpp + 2 bits to the
+ * width of T. Skips the Bayer reconstruction.
+*/
+template<typename T>
+struct PreviewSink {
+    T* preview;
+    std::size_t width;
+    std::size_t lossyBits;
+    std::size_t bpp;
+
+    template<typename V>
+    STATUS_t put(std::size_t row, std::size_t col, V y, V, V, V)
+    {
+        const std::size_t srcBits = bpp + 2;   // sum of 4 samples
+        const std::size_t dstBits = 8 * sizeof(T);
+        std::uint32_t value       = (std::uint32_t)(std::make_unsigned_t<V>)y << lossyBits;
+        value                     = srcBits > dstBits ? value >> (srcBits - dstBits) : value << (dstBits - srcBits);
+        preview[row * width + col] = (T)value;
+        return BASE_SUCCESS;
+    }
+};
+
+/*
+* Caller provided BayerCFA output buffer.
+*/
+struct outputDescriptor_t {
+    enum class pixelFormat
+    {
+        u8,   // 8-bit samples, higher bpp is shifted down to 8 bits
+        u16   // 16-bit samples, value as decoded (not MSB aligned)
+    };
+
+    void* data;
+    std::size_t pitch;   // bytes between starts of output rows, at least cropWidth * sample size
+    pixelFormat format;
+    std::size_t cropX      = 0;   // crop rectangle in BayerCFA pixels, all even. Zero width or height: full image
+    std::size_t cropY      = 0;
+    std::size_t cropWidth  = 0;
+    std::size_t cropHeight = 0;
+    bool flipHorizontal    = false;
+    bool flipVertical      = false;   // both flips: rotate by 180 degrees. Flips change the CFA phase of output.
+};
+
+/**
+ * Writes quads inside crop rectangle to strided buffer, flipping them in place. Quads outside the rectangle
+ * are dropped before Bayer reconstruction. Coordinates are in quads, [x0, x1) x [y0, y1). Quads are laid out in
+ * CFA pattern P before flipping.
+*/
+template<typename T, cfaPattern P = cfaPattern::gbrg>
+struct StridedBayerSink {
+    std::uint8_t* data;
+    std::size_t pitch;
+    std::size_t x0, y0, x1, y1;
+    bool flipHorizontal;
+    bool flipVertical;
+    std::size_t lossyBits;
+    std::size_t shift;   // right shift from bpp to sample width
+
+    template<typename V>
+    STATUS_t put(std::size_t row, std::size_t col, V y, V cd, V cm, V co)
+    {
+        if(row < y0 || row >= y1 || col < x0 || col >= x1) {
+            return BASE_SUCCESS;
+        }
+        std::uint16_t gb, b, r, gr;
+        DecoderBase::YCCC_to_BayerGB<std::uint16_t>(y, cd, cm, co, gb, b, r, gr, lossyBits);
+
+        const std::size_t outCol = flipHorizontal ? x1 - 1 - col : col - x0;
+        const std::size_t outRow = flipVertical ? y1 - 1 - row : row - y0;
+        T* upper                 = (T*)(data + 2 * outRow * pitch) + 2 * outCol;
+        T* lower                 = (T*)((std::uint8_t*)upper + pitch);
+        if(flipVertical) {
+            std::swap(upper, lower);
+        }
+        T quad[4];
+        cfaQuad<P>::scatter(quad, quad + 2, gb >> shift, b >> shift, r >> shift, gr >> shift);
+        const std::size_t left = flipHorizontal ? 1 : 0;
+        upper[left]            = quad[0];
+        upper[1 - left]        = quad[1];
+        lower[left]            = quad[2];
+        lower[1 - left]        = quad[3];
+        return BASE_SUCCESS;
+    }
+
+    /**
+     * Sets up sink for image of @param width x @param height, @param bpp from @param out. Validates crop and pitch.
+    */
+    STATUS_t init(
+       const outputDescriptor_t& out,
+       std::size_t width,
+       std::size_t height,
+       std::size_t bpp,
+       std::size_t lossy)
+    {
+        std::size_t cropWidth  = out.cropWidth ? out.cropWidth : width;
+        std::size_t cropHeight = out.cropHeight ? out.cropHeight : height;
+        if(!out.data || (out.cropX | out.cropY | cropWidth | cropHeight) & 1 || out.cropX + cropWidth > width ||
+           out.cropY + cropHeight > height || out.pitch < cropWidth * sizeof(T)) {
+            return BASE_OUTPUT_DESCRIPTOR_INVALID;
+        }
+        data           = (std::uint8_t*)out.data;
+        pitch          = out.pitch;
+        x0             = out.cropX / 2;
+        y0             = out.cropY / 2;
+        x1             = x0 + cropWidth / 2;
+        y1             = y0 + cropHeight / 2;
+        flipHorizontal = out.flipHorizontal;
+        flipVertical   = out.flipVertical;
+        lossyBits      = lossy;
+        shift          = sizeof(T) == 1 && bpp > 8 ? bpp - 8 : 0;
+        return BASE_SUCCESS;
+    }
+};
@@ -0,0 +1,328 @@
+#include "DecoderSession.hpp"
+#include <cstdio>
+#include <cstring>
+
+DecoderSession::DecoderSession() {}
+
+DecoderSession::DecoderSession(std::uint32_t A_init, std::uint32_t N_threshold)
+    : m_A_init(A_init)
+    , m_N_threshold(N_threshold)
+{
+}
+
+/**
+ * Preallocates buffers for frames up to @param maxFileSize compressed bytes and @param maxWidth x @param maxHeight
+ * pixels, so that even the first decode does not allocate, in any output mode. Outputs are sized for full resolution
+ * RGB, 3 samples per pixel.
+*/
+void DecoderSession::reserve(std::size_t maxFileSize, std::size_t maxWidth, std::size_t maxHeight)
+{
+    growInput(maxFileSize);
+    if(m_output_16bit.size() < 3 * maxWidth * maxHeight) {
+        m_output_8bit.resize(3 * maxWidth * maxHeight);
+        m_output_16bit.resize(3 * maxWidth * maxHeight);
+    }
+    if(m_YCCC_row.size() < 2 * maxWidth) {
+        m_YCCC_row.resize(2 * maxWidth);
+    }
+    if(m_bayerRows.size() < 4 * maxWidth) {   // 4 rows of Bayer samples, see decodeInput()
+        m_bayerRows.resize(4 * maxWidth);
+    }
+}
+
+/**
+ * Makes room for bitstream of @param size bytes and guard bytes. Buffer only grows.
+*/
+void DecoderSession::growInput(std::size_t size)
+{
+    if(m_input.size() < size + OMLS_INPUT_GUARD_BYTES) {
+        m_input.resize(size + OMLS_INPUT_GUARD_BYTES);
+    }
+}
+
+/**
+ * Reads whole file into the input buffer and decodes it to session output.
+*/
+STATUS_t DecoderSession::decodeFile(const char* fileName)
+{
+    RETURN_ON_FAILURE(loadFile(fileName))
+    return decodeInput();
+}
+
+/**
+ * Copies bitstream of @param size bytes into the input buffer and decodes it to session output.
+*/
+STATUS_t DecoderSession::decode(const std::uint8_t* data, std::size_t size)
+{
+    RETURN_ON_FAILURE(load(data, size))
+    return decodeInput();
+}
+
+/**
+ * Reads whole file into the input buffer and parses its header, see getHeader(). Unbuffered stdio is used,
+ * so no stream buffer is allocated per file.
+*/
+STATUS_t DecoderSession::loadFile(const char* fileName)
+{
+    m_outputSize = 0;
+    m_inputSize  = 0;
+
+    FILE* pFile = fopen(fileName, "rb");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    setvbuf(pFile, nullptr, _IONBF, 0);
+
+    long fileSize = -1;
+    if(fseek(pFile, 0, SEEK_END) == 0) {
+        fileSize = ftell(pFile);
+    }
+    if(fileSize < 0 || fseek(pFile, 0, SEEK_SET) != 0) {
+        fclose(pFile);
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+
+    growInput(fileSize);
+    std::size_t bytesRead = fread(m_input.data(), 1, fileSize, pFile);
+    fclose(pFile);
+    if(bytesRead != (std::size_t)fileSize) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+
+    memset(m_input.data() + fileSize, 0, OMLS_INPUT_GUARD_BYTES);
+    RETURN_ON_FAILURE(Reader::getHeader(m_input.data(), fileSize, m_header))
+    m_inputSize = fileSize;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Copies bitstream of @param size bytes into the input buffer and parses its header.
+*/
+STATUS_t DecoderSession::load(const std::uint8_t* data, std::size_t size)
+{
+    m_outputSize = 0;
+    m_inputSize  = 0;
+
+    growInput(size);
+    memcpy(m_input.data(), data, size);
+    memset(m_input.data() + size, 0, OMLS_INPUT_GUARD_BYTES);
+    RETURN_ON_FAILURE(Reader::getHeader(m_input.data(), size, m_header))
+    m_inputSize = size;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Decodes loaded frame (see load(), loadFile()) as BayerCFA image into caller buffer described by @param out,
+ * applying crop and flips while writing. Session output is not changed. Symbols above the crop are parsed but
+ * not converted, parsing stops after the last cropped row.
+*/
+STATUS_t DecoderSession::decodeInto(const outputDescriptor_t& out)
+{
+    if(!m_inputSize) {
+        return BASE_ERROR;   // nothing loaded
+    }
+    return withCfaQuad(cfaPatternFromFlags(m_header.flags), [&](auto quad) -> STATUS_t {
+        constexpr cfaPattern P = decltype(quad)::pattern;
+        if(out.format == outputDescriptor_t::pixelFormat::u8) {
+            StridedBayerSink<std::uint8_t, P> sink;
+            RETURN_ON_FAILURE(sink.init(out, m_header.width, m_header.height, m_header.bpp, m_header.lossyBits))
+            return decodeTo(sink, sink.y1);
+        }
+        StridedBayerSink<std::uint16_t, P> sink;
+        RETURN_ON_FAILURE(sink.init(out, m_header.width, m_header.height, m_header.bpp, m_header.lossyBits))
+        return decodeTo(sink, sink.y1);
+    });
+}
+
+/**
+ * Decodes bitstream in the input buffer through @param sink, picking the core and reader from header flags.
+ * Only first @param rowEnd quad rows are parsed.
+*/
+template<typename S>
+STATUS_t DecoderSession::decodeTo(S& sink, std::size_t rowEnd)
+{
+    const bool lsbFirst = m_header.flags & OMLS_FLAG_LSB_FIRST;
+
+    if(m_header.flags & OMLS_FLAG_CHANNEL_PLANAR) {
+        std::uint64_t offsets[5];
+        STATUS_t status = Reader::getChannelOffsets(m_input.data(), m_inputSize, m_header, offsets);
+        if(status) {
+            return status;
+        }
+        const std::uint8_t* payload = m_input.data() + m_header.headerSize;
+        const std::uint8_t* channelData[4];
+        std::size_t channelSize[4];
+        for(std::size_t ch = 0; ch < 4; ch++) {
+            channelData[ch] = payload + offsets[ch];
+            channelSize[ch] = offsets[ch + 1] - offsets[ch];
+        }
+        if(m_YCCC_row.size() < 2 * (std::size_t)m_header.width) {
+            m_YCCC_row.resize(2 * (std::size_t)m_header.width);
+        }
+
+        auto decode = lsbFirst ? DecoderBase::decodeBitstreamPlanar_sink<ReaderLSB, S>
+                               : DecoderBase::decodeBitstreamPlanar_sink<Reader, S>;
+        return decode(
+           m_header.width,
+           m_header.height,
+           m_N_threshold,
+           m_A_init,
+           channelData,
+           channelSize,
+           m_YCCC_row.data(),
+           sink,
+           rowEnd);
+    }
+
+    auto decode = lsbFirst ? DecoderBase::decodeBitstreamParallel_sink<ReaderLSB, S>
+                           : DecoderBase::decodeBitstreamParallel_sink<Reader, S>;
+    return decode(
+       m_header.width,
+       m_header.height,
+       m_header.unaryMaxWidth,
+       m_header.bpp,
+       m_input.data() + m_header.headerSize,
+       m_inputSize - m_header.headerSize,
+       sink,
+       rowEnd);
+}
+
+/**
+ * Decodes bitstream in the input buffer to m_output_8bit or m_output_16bit, as selected by setOutput().
+*/
+STATUS_t DecoderSession::decodeInput()
+{
+    STATUS_t status;
+
+    const std::size_t quadWidth  = m_header.width / 2;
+    const std::size_t quadHeight = m_header.height / 2;
+    const std::size_t quads      = quadWidth * quadHeight;
+    const cfaPattern cfa         = cfaPatternFromFlags(m_header.flags);
+    std::size_t outputSize;
+    bool eightBit;
+    switch(m_output) {
+        case output::preview8:
+            outputSize = quads;
+            eightBit   = true;
+            break;
+        case output::preview16:
+            outputSize = quads;
+            eightBit   = false;
+            break;
+        case output::rgbHalf:
+            outputSize = 3 * quads;
+            eightBit   = m_header.bpp == 8;
+            break;
+        case output::rgbBilinear:
+        case output::rgbEdgeAware:
+            outputSize = 3 * 4 * quads;
+            eightBit   = m_header.bpp == 8;
+            if(m_bayerRows.size() < 4 * 2 * quadWidth) {
+                m_bayerRows.resize(4 * 2 * quadWidth);
+            }
+            break;
+        default:
+            outputSize = 4 * quads;
+            eightBit   = m_header.bpp == 8;
+            break;
+    }
+    if(eightBit && m_output_8bit.size() < outputSize) {
+        m_output_8bit.resize(outputSize);
+    }
+    if(!eightBit && m_output_16bit.size() < outputSize) {
+        m_output_16bit.resize(outputSize);
+    }
+
+    switch(m_output) {
+        case output::preview8: {
+            PreviewSink<std::uint8_t> sink{m_output_8bit.data(), quadWidth, m_header.lossyBits, m_header.bpp};
+            status = decodeTo(sink, quadHeight);
+            break;
+        }
+        case output::preview16: {
+            PreviewSink<std::uint16_t> sink{m_output_16bit.data(), quadWidth, m_header.lossyBits, m_header.bpp};
+            status = decodeTo(sink, quadHeight);
+            break;
+        }
+        case output::rgbHalf:
+            if(eightBit) {
+                RgbHalfSink<std::uint8_t> sink{m_output_8bit.data(), quadWidth, m_header.lossyBits};
+                status = decodeTo(sink, quadHeight);
+            } else {
+                RgbHalfSink<std::uint16_t> sink{m_output_16bit.data(), quadWidth, m_header.lossyBits};
+                status = decodeTo(sink, quadHeight);
+            }
+            break;
+        case output::rgbBilinear:
+        case output::rgbEdgeAware: {
+            const bool edgeAware = m_output == output::rgbEdgeAware;
+            status               = withCfaQuad(cfa, [&](auto quad) {
+                constexpr cfaPattern P = decltype(quad)::pattern;
+                if(eightBit) {
+                    RgbBilinearSink<std::uint8_t, P> sink{
+                       m_output_8bit.data(), quadWidth, quadHeight, m_header.lossyBits, m_bayerRows.data(), edgeAware};
+                    return decodeTo(sink, quadHeight);
+                }
+                RgbBilinearSink<std::uint16_t, P> sink{
+                   m_output_16bit.data(), quadWidth, quadHeight, m_header.lossyBits, m_bayerRows.data(), edgeAware};
+                return decodeTo(sink, quadHeight);
+            });
+            break;
+        }
+        default:
+            status = withCfaQuad(cfa, [&](auto quad) {
+                constexpr cfaPattern P = decltype(quad)::pattern;
+                if(eightBit) {
+                    BayerSink<std::uint8_t, P> sink{m_output_8bit.data(), quadWidth, m_header.lossyBits};
+                    return decodeTo(sink, quadHeight);
+                }
+                BayerSink<std::uint16_t, P> sink{m_output_16bit.data(), quadWidth, m_header.lossyBits};
+                return decodeTo(sink, quadHeight);
+            });
+            break;
+    }
+
+    if(status == BASE_SUCCESS) {
+        m_outputSize = outputSize;
+        m_output8bit = eightBit;
+    }
+    return status;
+}
+
+/**
+ * Selects what following decodes produce: full BayerCFA image (default), half resolution Y preview,
+ * or demosaiced RGB image.
+*/
+void DecoderSession::setOutput(output out)
+{
+    m_output = out;
+}
+
+const headerData_t& DecoderSession::getHeader() const
+{
+    return m_header;
+}
+
+/**
+ * Output of last frame with 8-bit samples: BayerCFA or RGB image if it was 8 bpp, or 8-bit preview.
+ * Empty if last frame failed to decode or has 16-bit samples. Valid until next decode.
+*/
+std::span<const std::uint8_t> DecoderSession::getOutput8bit() const
+{
+    if(!m_output8bit) {
+        return {};
+    }
+    return {m_output_8bit.data(), m_outputSize};
+}
+
+/**
+ * Output of last frame with 16-bit samples: BayerCFA or RGB image if it was 10 to 16 bpp, or 16-bit preview.
+ * See getOutput8bit().
+*/
+std::span<const std::uint16_t> DecoderSession::getOutput16bit() const
+{
+    if(m_output8bit) {
+        return {};
+    }
+    return {m_output_16bit.data(), m_outputSize};
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include "Demosaic.hpp"
+#include "OmlsHeader.hpp"
+#include "globalDefines.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+* Decoder for continuous streams of frames. Input, output and scratch buffers are kept between frames and only
+* grow to the largest frame seen so far, so after the first frame (or reserve()) decoding does not allocate.
+* Decodes parallel and channel planar streams. Errors are returned as STATUS_t.
+* Frames are decoded either to session output (decodeFile(), decode(), see setOutput()), or loaded first and
+* decoded into caller buffer (loadFile() or load(), then decodeInto()).
+*/
+class DecoderSession
+{
+  public:
+    enum class output
+    {
+        bayer,   // full resolution BayerCFA, 8-bit samples for 8 bpp, 16-bit otherwise
+        preview8,   // half resolution Y (luma), 8-bit
+        preview16,   // half resolution Y (luma), 16-bit
+        rgbHalf,   // half resolution interleaved RGB, one pixel per quad
+        rgbBilinear,   // full resolution interleaved RGB, bilinear demosaicing
+        rgbEdgeAware   // full resolution interleaved RGB, bilinear with gradient directed green
+    };
+
+  private:
+    std::uint32_t m_A_init      = 32;
+    std::uint32_t m_N_threshold = 8;
+
+    std::vector<std::uint8_t> m_input;   // bitstream followed by OMLS_INPUT_GUARD_BYTES zero bytes
+    std::size_t m_inputSize = 0;
+    std::vector<std::uint8_t> m_output_8bit;
+    std::vector<std::uint16_t> m_output_16bit;
+    std::size_t m_outputSize = 0;
+    bool m_output8bit        = true;   // last output is in m_output_8bit
+    std::vector<std::int16_t> m_YCCC_row;   // scratch of fused planar decoding
+    std::vector<std::uint16_t> m_bayerRows;   // scratch of RGB demosaicing
+    headerData_t m_header{};
+    output m_output = output::bayer;
+
+    void growInput(std::size_t size);
+    STATUS_t decodeInput();
+    template<typename S>
+    STATUS_t decodeTo(S& sink, std::size_t rowEnd);
+
+  public:
+    DecoderSession();
+    DecoderSession(std::uint32_t A_init, std::uint32_t N_threshold);
+
+    void reserve(std::size_t maxFileSize, std::size_t maxWidth, std::size_t maxHeight);
+    void setOutput(output out);
+
+    STATUS_t decodeFile(const char* fileName);
+    STATUS_t decode(const std::uint8_t* data, std::size_t size);
+    STATUS_t loadFile(const char* fileName);
+    STATUS_t load(const std::uint8_t* data, std::size_t size);
+    STATUS_t decodeInto(const outputDescriptor_t& out);
+
+    const headerData_t& getHeader() const;
+    std::span<const std::uint8_t> getOutput8bit() const;
+    std::span<const std::uint16_t> getOutput16bit() const;
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include <cstdint>
+
+/*
+* RGB output sinks of the decoding cores, see BayerSink. Bayer GB samples are demosaiced as they are
+* reconstructed, so no full resolution BayerCFA buffer is written or read back. Output is interleaved RGB
+* with the same sample width as the Bayer output (8-bit for 8 bpp, 16-bit otherwise), not rescaled.
+*
+* Gb | B
+* ---+---
+* R  | Gr
+*
+* is the GBRG quad, other CFA patterns (cfaQuad) only move the four samples around.
+*/
+
+/**
+ * Half resolution RGB taken straight from each quad: R, mean of both greens, B.
+*/
+template<typename T>
+struct RgbHalfSink {
+    T* rgb;
+    std::size_t width;   // quads per row
+    std::size_t lossyBits;
+
+    template<typename V>
+    STATUS_t put(std::size_t row, std::size_t col, V y, V cd, V cm, V co)
+    {
+        std::uint16_t gb, b, r, gr;
+        DecoderBase::YCCC_to_BayerGB<std::uint16_t>(y, cd, cm, co, gb, b, r, gr, lossyBits);
+        T* pixel = &rgb[3 * (row * width + col)];
+        pixel[0] = (T)r;
+        pixel[1] = (T)((gb + gr + 1) >> 1);
+        pixel[2] = (T)b;
+        return BASE_SUCCESS;
+    }
+};
+
+/**
+ * Full resolution RGB by bilinear demosaicing. Reconstructed quads are kept in a rolling window of 4 Bayer rows
+ * (two quad rows), a Bayer row is interpolated as soon as the row below it is complete. Borders are mirrored.
+ * With @param edgeAware green at R and B sites is interpolated along the direction of the smaller gradient.
+ * Quads are laid out in CFA pattern P.
+*/
+template<typename T, cfaPattern P = cfaPattern::gbrg>
+struct RgbBilinearSink {
+    T* rgb;
+    std::size_t width;   // quads per row
+    std::size_t height;   // quad rows
+    std::size_t lossyBits;
+    std::uint16_t* rows;   // scratch of 4 * 2 * width samples
+    bool edgeAware;
+
+    template<typename V>
+    STATUS_t put(std::size_t row, std::size_t col, V y, V cd, V cm, V co)
+    {
+        std::uint16_t gb, b, r, gr;
+        DecoderBase::YCCC_to_BayerGB<std::uint16_t>(y, cd, cm, co, gb, b, r, gr, lossyBits);
+        cfaQuad<P>::scatter(bayerRow(2 * row) + 2 * col, bayerRow(2 * row + 1) + 2 * col, gb, b, r, gr);
+
+        if(col == width - 1) {   // quad row complete
+            if(row > 0) {
+                interpolateRow(2 * row - 1);
+            }
+            interpolateRow(2 * row);
+            if(row == height - 1) {
+                interpolateRow(2 * row + 1);
+            }
+        }
+        return BASE_SUCCESS;
+    }
+
+  private:
+    std::uint16_t* bayerRow(std::size_t y)
+    {
+        return &rows[(y & 3) * 2 * width];
+    }
+
+    /**
+     * Mirrors index outside [0, n) around the border sample, keeping the CFA phase.
+    */
+    static std::size_t mirror(std::ptrdiff_t i, std::size_t n)
+    {
+        if(i < 0) {
+            return -i;
+        }
+        if(i >= (std::ptrdiff_t)n) {
+            return 2 * n - 2 - i;
+        }
+        return i;
+    }
+
+    std::uint32_t green(
+       const std::uint16_t* up,
+       const std::uint16_t* cur,
+       const std::uint16_t* down,
+       std::size_t x,
+       std::size_t xl,
+       std::size_t xr) const
+    {
+        std::uint32_t horizontal = cur[xl] + cur[xr];
+        std::uint32_t vertical   = up[x] + down[x];
+        if(edgeAware) {
+            std::uint32_t dh = cur[xl] > cur[xr] ? cur[xl] - cur[xr] : cur[xr] - cur[xl];
+            std::uint32_t dv = up[x] > down[x] ? up[x] - down[x] : down[x] - up[x];
+            if(dh < dv) {
+                return (horizontal + 1) >> 1;
+            }
+            if(dv < dh) {
+                return (vertical + 1) >> 1;
+            }
+        }
+        return (horizontal + vertical + 2) >> 2;
+    }
+
+    /**
+     * RGB at sample @param x of channel C (0 Gb, 1 B, 2 R, 3 Gr) of row @param cur, @param xl and @param xr are its
+     * left and right neighbours. Gb has B on its left and right and R above and below, Gr the other way round.
+    */
+    template<std::size_t C>
+    void interpolateSite(
+       const std::uint16_t* up,
+       const std::uint16_t* cur,
+       const std::uint16_t* down,
+       std::size_t x,
+       std::size_t xl,
+       std::size_t xr,
+       T* pixel) const
+    {
+        if constexpr(C == 0) {
+            pixel[0] = (T)((up[x] + down[x] + 1) >> 1);
+            pixel[1] = (T)cur[x];
+            pixel[2] = (T)((cur[xl] + cur[xr] + 1) >> 1);
+        } else if constexpr(C == 1) {   // R on diagonals
+            pixel[0] = (T)((up[xl] + up[xr] + down[xl] + down[xr] + 2) >> 2);
+            pixel[1] = (T)green(up, cur, down, x, xl, xr);
+            pixel[2] = (T)cur[x];
+        } else if constexpr(C == 2) {   // B on diagonals
+            pixel[0] = (T)cur[x];
+            pixel[1] = (T)green(up, cur, down, x, xl, xr);
+            pixel[2] = (T)((up[xl] + up[xr] + down[xl] + down[xr] + 2) >> 2);
+        } else {
+            pixel[0] = (T)((cur[xl] + cur[xr] + 1) >> 1);
+            pixel[1] = (T)cur[x];
+            pixel[2] = (T)((up[x] + down[x] + 1) >> 1);
+        }
+    }
+
+    /**
+     * Interpolates row @param cur whose even columns hold channel EVEN and odd columns channel ODD.
+    */
+    template<std::size_t EVEN, std::size_t ODD>
+    void interpolatePairs(const std::uint16_t* up, const std::uint16_t* cur, const std::uint16_t* down, T* out) const
+    {
+        const std::size_t W = 2 * width;
+        for(std::size_t x = 0; x < W; x += 2) {
+            const std::size_t xl  = mirror((std::ptrdiff_t)x - 1, W);   // left of even column
+            const std::size_t xr  = x + 1;   // right of even column, left of odd column
+            const std::size_t xrr = mirror((std::ptrdiff_t)x + 2, W);   // right of odd column
+            interpolateSite<EVEN>(up, cur, down, x, xl, xr, &out[3 * x]);
+            interpolateSite<ODD>(up, cur, down, xr, x, xrr, &out[3 * x + 3]);
+        }
+    }
+
+    void interpolateRow(std::size_t y)
+    {
+        const std::uint16_t* up   = bayerRow(mirror((std::ptrdiff_t)y - 1, 2 * height));
+        const std::uint16_t* cur  = bayerRow(y);
+        const std::uint16_t* down = bayerRow(mirror((std::ptrdiff_t)y + 1, 2 * height));
+        T* out                    = &rgb[3 * y * 2 * width];
+
+        using quad = cfaQuad<P>;
+        if((y & 1) == 0) {
+            interpolatePairs<quad::channelAt(0), quad::channelAt(1)>(up, cur, down, out);
+        } else {
+            interpolatePairs<quad::channelAt(2), quad::channelAt(3)>(up, cur, down, out);
+        }
+    }
+};
@@ -3,9 +3,11 @@
 #include "Channels.hpp"
 #include <bitset>
 #include <chrono>
+#include <sstream>
+#include <thread>
 
 Writter_s::Writter_s(){};
-Writter_s::Writter_s(std::ofstream* pWf, std::uint32_t* pBfr, std::size_t* pBitCnt, std::size_t* pBytesCnt)
+Writter_s::Writter_s(std::ostream* pWf, std::uint32_t* pBfr, std::size_t* pBitCnt, std::size_t* pBytesCnt)
    : m_pWf(pWf)
    , m_pBfr(pBfr)
    , m_pBitCnt(pBitCnt)
@@ -27,11 +29,37 @@ Encoder::Encoder(
    std::uint8_t bpp,
    std::size_t header_bytes,
    const char* fileName)
-   : m_pImg(pImg)
-   //    , m_width(pImg->getWidth() / 2)
-   //    , m_height(pImg->getHeight() / 2)
-   , m_width(width / 2)
-   , m_height(height / 2)
+   : Encoder(
+        BayerView{pImg->getDataView().data(), pImg->getWidth(), 0, 0, width, height},
+        folderOut,
+        imgIdx,
+        A_init,
+        N_threshold,
+        lossyBits,
+        unaryMaxWidth,
+        bpp,
+        header_bytes,
+        fileName){};
+
+/**
+ * Parallel version reading BAYER samples in place from @param view, which may be a window of a larger frame.
+ * View offsets are written to the ROI header. Data must stay valid while encoding. Throws if the view size is not a
+ * multiple of OMLS_SIZE_MULTIPLE, as the stream could not be decoded.
+ */
+Encoder::Encoder(
+   const BayerView& view,
+   const char* folderOut,
+   std::size_t imgIdx,
+   std::uint32_t A_init,
+   std::uint32_t N_threshold,
+   std::size_t lossyBits,
+   std::size_t unaryMaxWidth,
+   std::uint8_t bpp,
+   std::size_t header_bytes,
+   const char* fileName)
+   : m_view(view)
+   , m_width(view.width / 2)
+   , m_height(view.height / 2)
    , m_length(m_width * m_height)
    , m_folderOut(folderOut)
    , m_imgIdx(imgIdx)
@@ -43,7 +71,14 @@ Encoder::Encoder(
    , m_header_bytes(header_bytes)
    , m_fileName(fileName)
    , m_k_seed(bpp + 3)
-   , m_k_max(bpp + 2){};
+   , m_k_max(bpp + 2)
+   , m_roiOffsetX(view.offsetX)
+   , m_roiOffsetY(view.offsetY)
+{
+    if(view.width == 0 || view.height == 0 || view.width % OMLS_SIZE_MULTIPLE || view.height % OMLS_SIZE_MULTIPLE) {
+        throw std::runtime_error("Encoder(): Frame width and height must be non-zero multiples of 16.");
+    }
+};
 
 /**
  * Sequential and ideal version. Encode data to binary array. Supply YCCC image.
@@ -53,33 +88,48 @@ Encoder::Encoder(
    const char* folderOut,
    std::size_t imgIdx,
    std::size_t lossyBits,
-   std::size_t header_bytes)
+   std::size_t header_bytes,
+   std::uint8_t bpp,
+   const char* fileName)
    : m_pImgYCCC(pImgYCCC)
    , m_width(pImgYCCC->getWidth())
    , m_height(pImgYCCC->getHeight())
    , m_length(m_width * m_height)
-   , m_kValues(m_length)
-   , m_dpcm(m_length)
-   , m_abs(m_length)
-   , m_quotient(m_length)
-   , m_remainder(m_length)
+   , m_planeArena(5 * sQuadChannelCS::getBytesRequired(m_width, m_height))
+   , m_kValues(m_width, m_height, &m_planeArena)
+   , m_dpcm(m_width, m_height, &m_planeArena)
+   , m_abs(m_width, m_height, &m_planeArena)
+   , m_quotient(m_width, m_height, &m_planeArena)
+   , m_remainder(m_width, m_height, &m_planeArena)
    , m_folderOut(folderOut)
    , m_imgIdx(imgIdx)
    , m_lossyBits(lossyBits)
-   , m_header_bytes(header_bytes){};
+   , m_unaryMaxWidth(C_MAX_UNARY_LENGTH_FULL)   // sequential coding has no unary limit
+   , m_bpp(bpp)
+   , m_header_bytes(header_bytes)
+   , m_fileName(fileName){};
 
 /**
  * 
 */
 std::unique_ptr<std::vector<std::size_t>> Encoder::encodeUsingMethod(Encoder::method method)
 {
-    std::cout << "Encoding: " << unsigned(m_width) << " x " << unsigned(m_height) << std::endl;
+    if(m_verbose) {
+        std::cout << "Encoding: " << unsigned(m_width) << " x " << unsigned(m_height) << std::endl;
+    }
+    if(m_pImgYCCC && m_bpp > OMLS_YCCC16_MAX_BPP) {   // ImageYCCC and channel planes are int16_t
+        throw std::runtime_error(
+           "encodeUsingMethod(): sequential and planar coding support up to 12 BPP, use a parallel method.");
+    }
     switch(method) {
         /* Encode by calculating dpcm using diffUp method, then encode the single seed in two's complement.
         * Sequental encoding (CH1, CH1, CH1,... CH2, CH2, CH2,... CH3, CH3, CH3,... , CH4, CH4, CH4,...)
         * Reset statistics (A and N) when going to new row.*/
         case Encoder::method::singleSeedInTwos:
             if(m_pImgYCCC) {
+                if(m_headerVersion >= 2) {
+                    return encodePlanar();   // channels on separate threads, offsets in header
+                }
                 differentiateAll(Encoder::algorithm::diffUp);
                 adaptiveGolombRiceAll(Encoder::algorithm::singleSeedInTwos);
                 return encodeBitstreamAll();
@@ -107,11 +157,11 @@ std::unique_ptr<std::vector<std::size_t>> Encoder::encodeUsingMethod(Encoder::me
                    "encodeUsingMethod(parallel_standard): You wanted to use standard unary encoding but it seems that "
                    "you have set the unaryMaxWidth parameter.");
             }
-            if(m_pImg) {
+            if(m_view.data) {
                 return runParallelCompression();
             } else {
                 throw std::runtime_error(
-                   "encodeUsingMethod(): m_pImg was not initilised through proper Encoder constructor.");
+                   "encodeUsingMethod(): m_view was not initilised through proper Encoder constructor.");
             }
         /* Encode all 4 channels simultaneously with single seed (diff up method). Limit maximal allowed length of compressed data.*/
         case Encoder::method::parallel_limited:
@@ -120,11 +170,11 @@ std::unique_ptr<std::vector<std::size_t>> Encoder::encodeUsingMethod(Encoder::me
                    "encodeUsingMethod(parallel_limited): You wanted to use limited unary encoding but it seems that "
                    "you have set the unaryMaxWidth parameter to maximum value (no limiting).");
             }
-            if(m_pImg) {
+            if(m_view.data) {
                 return runParallelCompression();
             } else {
                 throw std::runtime_error(
-                   "encodeUsingMethod(): m_pImg was not initilised through proper Encoder constructor.");
+                   "encodeUsingMethod(): m_view was not initilised through proper Encoder constructor.");
             }
         default:
             throw std::runtime_error("Invalid method!");
@@ -139,59 +189,62 @@ std::unique_ptr<std::vector<std::size_t>> Encoder::encodeUsingMethod(Encoder::me
 std::unique_ptr<std::vector<std::size_t>> Encoder::runParallelCompression()
 {
     char txt[200];
-    sprintf(
-       txt,
-       "Parallel encoding with params: imgIdx: %zu, unaryMaxWidth: %zu, A_init: %u, N_threshold: %u\n",
-       m_imgIdx,
-       m_unaryMaxWidth,
-       m_A_init,
-       m_N_threshold);
-    std::cout << txt;
+    if(m_verbose) {
+        sprintf(
+           txt,
+           "Parallel encoding with params: imgIdx: %zu, unaryMaxWidth: %zu, A_init: %u, N_threshold: %u\n",
+           m_imgIdx,
+           m_unaryMaxWidth,
+           m_A_init,
+           m_N_threshold);
+        std::cout << txt;
+    }
 
 #ifdef DUMP_VERIFICATION
-    char outputFile[200];
-    sprintf(
-       outputFile,
-       "%s/dump/%s%02zu_BAYER.txt",
-       m_folderOut,
-       m_fileName,
-       m_imgIdx);
-    std::ofstream wf(outputFile, std::ios::out);
-    if(!wf) {
-        char msg[200];
-        sprintf(msg, "Cannot open specified file: %s", outputFile);
-        throw std::runtime_error(msg);
+    std::ofstream wf;
+    if(m_dump) {
+        char outputFile[200];
+        sprintf(
+           outputFile,
+           "%s/dump/%s%02zu_BAYER.txt",
+           m_folderOut,
+           m_fileName,
+           m_imgIdx);
+        wf.open(outputFile, std::ios::out);
+        if(!wf) {
+            char msg[200];
+            sprintf(msg, "Cannot open specified file: %s", outputFile);
+            throw std::runtime_error(msg);
+        }
+        sprintf(txt, "%zu %zu\n", m_width, m_height);
+        wf << txt;
     }
-    sprintf(txt, "%zu %zu\n", m_width, m_height);
-    wf << txt;
 #endif
 
-    auto imageData = m_pImg->getDataView();
-    for(std::size_t i = 0; i < m_pImg->getHeight() / 2; i++) {
-        for(std::size_t j = 0; j < m_pImg->getWidth() / 2; j++) {
-            std::size_t idxGB = 2 * i * m_pImg->getWidth() + 2 * j;
-            std::size_t idxB  = 2 * i * m_pImg->getWidth() + 2 * j + 1;
-            std::size_t idxR  = (2 * i + 1) * m_pImg->getWidth() + 2 * j;
-            std::size_t idxGR = (2 * i + 1) * m_pImg->getWidth() + 2 * j + 1;
+    withYcccType(m_bpp, [&](auto v) {
+        using V = decltype(v);
+        withCfaQuad(m_cfaPattern, [&](auto quad) {
+            for(std::size_t i = 0; i < m_height; i++) {
+                const std::uint16_t* upper = m_view.row(2 * i);
+                const std::uint16_t* lower = m_view.row(2 * i + 1);
+                for(std::size_t j = 0; j < m_width; j++) {
 #ifdef DUMP_VERIFICATION
-            m_row = i;
-            m_col = j;
+                    m_row = i;
+                    m_col = j;
 #endif
-            encodeParallel(imageData[idxGB], imageData[idxB], imageData[idxR], imageData[idxGR]);
+                    std::uint16_t gb, b, r, gr;
+                    quad.gather(upper + 2 * j, lower + 2 * j, gb, b, r, gr);
+                    encodeParallel<V>(gb, b, r, gr);
 #ifdef DUMP_VERIFICATION
-            sprintf(
-               txt,
-               "%4zu %4zu : %3u %3u %3u %3u\n",
-               i,
-               j,
-               imageData[idxGB],
-               imageData[idxB],
-               imageData[idxR],
-               imageData[idxGR]);
-            wf << txt;
+                    if(m_dump) {
+                        sprintf(txt, "%4zu %4zu : %3u %3u %3u %3u\n", i, j, gb, b, r, gr);
+                        wf << txt;
+                    }
 #endif
-        }
-    }
+                }
+            }
+        });
+    });
 
 #ifdef DUMP_VERIFICATION
     wf.close();
@@ -216,20 +269,31 @@ std::unique_ptr<std::vector<std::size_t>> Encoder::runParallelCompression()
  *  5.) add abs(dpcm) to A of respective channel. Increase N++ of respective channel.
  *  6.) Encode q & r for each channel in parallel
  * 7.) fill last byte bitstream with 1s
+ * YCCC and dpcm values are of type V (see withYcccType), the same for all quadruples of a frame.
  * 
 */
+template<typename V>
 std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint16_t r, std::uint16_t gr)
 {
-    static std::size_t idx = 0;
-    static std::uint32_t bfr;
-    static std::size_t bitCnt;
-    static std::size_t bytesCnt;
-    static std::ofstream wf;
-    static Writter_s writter;
-    static int16_t YCCC_prev[4];
-    static int16_t YCCC_up[4];
-    static std::uint32_t A[4];
-    static std::uint32_t N;
+    // Per encoder, so encoders of different cameras can run concurrently
+    std::size_t& idx      = m_parallel.idx;
+    std::uint32_t& bfr    = m_parallel.bfr;
+    std::size_t& bitCnt   = m_parallel.bitCnt;
+    std::size_t& bytesCnt = m_parallel.bytesCnt;
+    std::ofstream& wf     = m_parallel.wf;
+    std::ostream*& pOut   = m_parallel.pOut;
+    Writter_s& writter    = m_parallel.writter;
+    std::uint32_t* A      = m_parallel.A;
+    std::uint32_t& N      = m_parallel.N;
+    V* YCCC_prev;
+    V* YCCC_up;
+    if constexpr(sizeof(V) == sizeof(std::int16_t)) {
+        YCCC_prev = m_parallel.YCCC_prev;
+        YCCC_up   = m_parallel.YCCC_up;
+    } else {
+        YCCC_prev = m_parallel.YCCC_prev_wide;
+        YCCC_up   = m_parallel.YCCC_up_wide;
+    }
 
     if(idx == 0) {
         // open new file
@@ -239,22 +303,29 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
         m_fileSize = 0;
         N          = N_START;
 
-        char path[200];
-        sprintf(path, "%s/compressed/%s%02zu.bin", m_folderOut, m_fileName, m_imgIdx);
-        wf.open((const char*)path, std::ios::out | std::ios::binary);
-        if(!wf) {
-            char msg[200];
-            sprintf(msg, "Cannot open specified file: %s", path);
-            throw std::runtime_error(msg);
+        pOut = m_pOut;
+        if(!pOut) {
+            char path[200];
+            sprintf(path, "%s/compressed/%s%02zu.bin", m_folderOut, m_fileName, m_imgIdx);
+            wf.open((const char*)path, std::ios::out | std::ios::binary);
+            if(!wf) {
+                char msg[200];
+                sprintf(msg, "Cannot open specified file: %s", path);
+                throw std::runtime_error(msg);
+            }
+            pOut = &wf;
         }
 
-        writter.m_pWf       = &wf;
+        writter.m_pWf       = pOut;
         writter.m_pBfr      = &bfr;
         writter.m_pBitCnt   = &bitCnt;
         writter.m_pBytesCnt = &bytesCnt;
 
+        if(m_headerVersion >= 2) {
+            pushHeaderV2(writter);
+        }
         // if header_bytes = 8, then write 8 byte timestamp to the beginning
-        if(m_header_bytes == 8) {
+        else if(m_header_bytes == 8) {
 
             /* Timestamp: */
             // MSB                                                                          LSB
@@ -268,7 +339,7 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
             //                              std::chrono::system_clock::now().time_since_epoch())
             //                              .count();
 
-            std::uint8_t reservedBits      = 0;
+            std::uint8_t reservedBits = (m_lsbFirst ? OMLS_FLAG_LSB_FIRST : 0) | cfaPatternFlags(m_cfaPattern);
             std::uint64_t compression_info =   //
                0LLU |   //
                ((std::uint64_t)((std::uint8_t)reservedBits)) << 56 |   //
@@ -278,21 +349,23 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
                ((std::uint64_t)((std::uint16_t)2 * m_height)) << 16 |   //
                ((std::uint64_t)((std::uint16_t)2 * m_width)) << 0;
             // clang-format on
-            for(std::size_t s = 0; s < 64; s += 8) {
-                printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+            if(m_verbose) {
+                for(std::size_t s = 0; s < 64; s += 8) {
+                    printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+                }
+                printf("Compression data: 0x%08llX\n", compression_info);
             }
-            printf("Compression data: 0x%08llX\n", compression_info);
 
             pushHeader(writter, compression_info);
 
         } else if(m_header_bytes == 16) {
-            std::uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                         std::chrono::system_clock::now().time_since_epoch())
-                                         .count();
+            std::uint64_t timestamp = headerTimestamp();
 
             pushHeader(writter, timestamp);
 
-            std::cout << "Compression Image timestamp: " << timestamp << std::endl;
+            if(m_verbose) {
+                std::cout << "Compression Image timestamp: " << timestamp << std::endl;
+            }
 
             /* Compression info: */
             //  MSB                                                                          LSB
@@ -309,7 +382,7 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
             //       6 : lossy bits
             //       7 : reserved
 
-            std::uint8_t reservedBits = 0;
+            std::uint8_t reservedBits = (m_lsbFirst ? OMLS_FLAG_LSB_FIRST : 0) | cfaPatternFlags(m_cfaPattern);
             // clang-format off
             std::uint64_t compression_info =   //
                0LLU                                                    |   //
@@ -320,25 +393,27 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
                ((std::uint64_t)((std::uint16_t)2*m_height))      << 16 |   //
                ((std::uint64_t)((std::uint16_t)2*m_width))       << 0;
             // clang-format on
-            for(std::size_t s = 0; s < 64; s += 8) {
-                printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+            if(m_verbose) {
+                for(std::size_t s = 0; s < 64; s += 8) {
+                    printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+                }
+                printf("Compression data: 0x%08llX\n", compression_info);
             }
-            printf("Compression data: 0x%08llX\n", compression_info);
 
             pushHeader(writter, compression_info);
             // wf.write((const char*)&compression_info, sizeof(compression_info));
             // (*writter.m_pBytesCnt) += sizeof(compression_info);
         } else if(m_header_bytes == 24) {
-            std::uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                         std::chrono::system_clock::now().time_since_epoch())
-                                         .count();
+            std::uint64_t timestamp = headerTimestamp();
 
             pushHeader(writter, timestamp);
 
-            std::cout << "Compression Image timestamp: " << timestamp << std::endl;
+            if(m_verbose) {
+                std::cout << "Compression Image timestamp: " << timestamp << std::endl;
+            }
             std::uint64_t roi      = 0;
-            std::uint16_t offset_y = 0;
-            std::uint16_t offset_x = 0;
+            std::uint64_t offset_y = m_roiOffsetY;
+            std::uint64_t offset_x = m_roiOffsetX;
             roi = (2 * m_height & 0xFFFF) << 48 | (2 * m_width & 0xFFFF) << 32 | offset_y << 16 | offset_x;
             pushHeader(writter, roi);
 
@@ -357,7 +432,7 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
             //       6 : lossy bits
             //       7 : reserved
 
-            std::uint8_t reservedBits = 0;
+            std::uint8_t reservedBits = (m_lsbFirst ? OMLS_FLAG_LSB_FIRST : 0) | cfaPatternFlags(m_cfaPattern);
             // clang-format off
             std::uint64_t compression_info =   //
                0LLU                                                    |   //
@@ -368,17 +443,21 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
                ((std::uint64_t)((std::uint16_t)2*m_height))      << 16 |   //
                ((std::uint64_t)((std::uint16_t)2*m_width))       << 0;
             // clang-format on
-            for(std::size_t s = 0; s < 64; s += 8) {
-                printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+            if(m_verbose) {
+                for(std::size_t s = 0; s < 64; s += 8) {
+                    printf("Byte %zu: %02X\n", s / 8, (uint8_t)(compression_info >> s));
+                }
+                printf("Compression data: 0x%08llX\n", compression_info);
             }
-            printf("Compression data: 0x%08llX\n", compression_info);
 
             pushHeader(writter, compression_info);
 
         }
 
         else {
-            printf("No header will be added to the compressed file.\n");
+            if(m_verbose) {
+                printf("No header will be added to the compressed file.\n");
+            }
         }
 
         for(std::size_t ch = 0; ch < 4; ch++) {
@@ -386,13 +465,13 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
             A[ch]         = m_A_init;
         }
         encodeParallelOneQuadrupleSeedPixel(gb, b, r, gr, YCCC_prev, A, writter);
-        memcpy(YCCC_up, YCCC_prev, sizeof(YCCC_prev));   // Copy first pixel of a row to YCCC_prev.
+        memcpy(YCCC_up, YCCC_prev, 4 * sizeof(V));   // Copy first pixel of a row to YCCC_prev.
         idx++;
 
     } else if(idx % m_width == 0) {   // new row
         // provide YCCC_up pixel value. YCCC_up is then updated with new value.
         encodeParallelOneQuadruple(gb, b, r, gr, YCCC_up, A, N, m_N_threshold, 0, writter);
-        memcpy(YCCC_prev, YCCC_up, sizeof(YCCC_prev));   // Copy first pixel of a row to YCCC_prev.
+        memcpy(YCCC_prev, YCCC_up, 4 * sizeof(V));   // Copy first pixel of a row to YCCC_prev.
         idx++;
     } else if(idx == (m_length - 4)) {   // fourth-to-last pixel
         encodeParallelOneQuadruple(gb, b, r, gr, YCCC_prev, A, N, m_N_threshold, 1, writter);
@@ -406,7 +485,9 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
     } else if(idx == (m_length - 1)) {   // last pixel
         encodeParallelOneQuadruple(gb, b, r, gr, YCCC_prev, A, N, m_N_threshold, 1, writter);
         flushBitstream(writter);
-        wf.close();
+        if(pOut == &wf) {
+            wf.close();
+        }
         idx        = 0;
         m_fileSize = *writter.m_pBytesCnt;
     } else {
@@ -420,16 +501,18 @@ std::size_t Encoder::encodeParallel(std::uint16_t gb, std::uint16_t b, std::uint
 /**
  * YCCC_prev is updated with current YCCC values.
 */
+template<typename V>
 void Encoder::encodeParallelOneQuadrupleSeedPixel(
    std::uint16_t gb,
    std::uint16_t b,
    std::uint16_t r,
    std::uint16_t gr,
-   std::int16_t* YCCC_prev,
+   V* YCCC_prev,
    std::uint32_t* A,
    Writter_s writter)
 {
-    std::int16_t YCCC[] = {0, 0, 0, 0};
+    using U  = std::make_unsigned_t<V>;
+    V YCCC[] = {0, 0, 0, 0};
 
     // 1.) BayerCFA to YCCC
     Helpers::transformColorGB(
@@ -444,7 +527,7 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
        m_lossyBits);   //
 
 #ifdef DUMP_VERIFICATION
-    {
+    if(m_dump) {
         char outputFile[200];
         sprintf(
            outputFile,
@@ -485,7 +568,7 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
     // std::uint16_t k[] = {k_SEED, k_SEED, k_SEED, k_SEED};
     std::uint16_t k[] = {(uint16_t)m_k_seed, (uint16_t)m_k_seed, (uint16_t)m_k_seed, (uint16_t)m_k_seed};
 #ifdef DUMP_VERIFICATION
-    {
+    if(m_dump) {
         char outputFile[200];
         sprintf(
            outputFile,
@@ -521,20 +604,20 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
     }
 #endif
     // 4.) AGOR
-    std::uint16_t quotient[]  = {0, 0, 0, 0};
-    std::uint16_t remainder[] = {0, 0, 0, 0};
-#ifdef DUMP_VERIFICATION
+    U quotient[]  = {0, 0, 0, 0};
+    U remainder[] = {0, 0, 0, 0};
     // 3.) To positive value
-    std::uint16_t posValue[] = {0, 0, 0, 0};
+    U posValue[] = {0, 0, 0, 0};
     for(std::size_t ch = 0; ch < 4; ch++) {   //
-        posValue[ch] = (std::uint16_t)toAbsSingle(YCCC[ch]);
+        posValue[ch] = (U)toAbsSingle(YCCC[ch]);
     }
 
     for(std::size_t ch = 0; ch < 4; ch++) {
         quotient[ch]  = posValue[ch] >> k[ch];
-        remainder[ch] = posValue[ch] & (std::uint16_t)((1 << k[ch]) - 1);   // modulus op = take last k bits
+        remainder[ch] = posValue[ch] & (U)((1 << k[ch]) - 1);   // modulus op = take last k bits
     }
-    {
+#ifdef DUMP_VERIFICATION
+    if(m_dump) {
         char outputFile[200];
         sprintf(
            outputFile,
@@ -571,7 +654,7 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
         wf << txt;
         wf.close();
     }
-    {
+    if(m_dump) {
         char outputFile[200];
         sprintf(
            outputFile,
@@ -609,51 +692,60 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
         wf << txt;
         wf.close();
     }
-    char outputFile[200];
-    sprintf(
-       outputFile,
-       "%s/dump/%s%02zu_codes.txt",
-       m_folderOut,
-       m_fileName,
-       m_imgIdx);
-    std::ofstream wf_codes(outputFile, std::ios::out);
-    if(!wf_codes) {
-        char msg[200];
-        std::sprintf(msg, "Cannot open specified file: %s", outputFile);
-        throw std::runtime_error(msg);
-    }
+    std::ofstream wf_codes;
     char txt[200];
-    std::sprintf(txt, "%zu %zu  quotient : remai : k  : len    code\n", m_width, m_height);
-    wf_codes << txt;
+    if(m_dump) {
+        char outputFile[200];
+        sprintf(
+           outputFile,
+           "%s/dump/%s%02zu_codes.txt",
+           m_folderOut,
+           m_fileName,
+           m_imgIdx);
+        wf_codes.open(outputFile, std::ios::out);
+        if(!wf_codes) {
+            char msg[200];
+            std::sprintf(msg, "Cannot open specified file: %s", outputFile);
+            throw std::runtime_error(msg);
+        }
+        std::sprintf(txt, "%zu %zu  quotient : remai : k  : len    code\n", m_width, m_height);
+        wf_codes << txt;
+    }
 #endif
     // 6.) Encode
     for(std::size_t ch = 0; ch < 4; ch++) {
 #ifdef DUMP_VERIFICATION
-        std::size_t code_len =
-           ((std::size_t)(quotient[ch] + 1 + k[ch]) < (m_k_seed + m_unaryMaxWidth) ? quotient[ch] + 1 + k[ch]
-                                                                                   : (m_k_seed + m_unaryMaxWidth));
-        std::sprintf(
-           txt,
-           "%4zu %4zu : %4hu  : %4hu  : %2hu : %3zu ",
-           m_row,
-           m_col,
-           quotient[ch],
-           remainder[ch],
-           k[ch],
-           code_len);
-        wf_codes << txt;
+        if(m_dump) {
+            std::size_t code_len =
+               ((std::size_t)(quotient[ch] + 1 + k[ch]) < (m_k_seed + m_unaryMaxWidth) ? quotient[ch] + 1 + k[ch]
+                                                                                       : (m_k_seed + m_unaryMaxWidth));
+            std::sprintf(
+               txt,
+               "%4zu %4zu : %4hu  : %4hu  : %2hu : %3zu ",
+               m_row,
+               m_col,
+               quotient[ch],
+               remainder[ch],
+               k[ch],
+               code_len);
+            wf_codes << txt;
+        }
 #endif
 
         // unary coding of quotient
-        for(std::uint16_t n = 0; n < quotient[ch]; n++) {   // big endian
+        for(U n = 0; n < quotient[ch]; n++) {   // big endian
             pushBit_1(writter);
 #ifdef DUMP_VERIFICATION
-            wf_codes << '1';
+            if(m_dump) {
+                wf_codes << '1';
+            }
 #endif
         }
         pushBit_0(writter);
 #ifdef DUMP_VERIFICATION
-        wf_codes << '0';
+        if(m_dump) {
+            wf_codes << '0';
+        }
 #endif
 
         // // remainder coding
@@ -666,11 +758,15 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
             std::uint32_t bit = (remainder[ch] >> n) & (std::uint32_t)1;
             pushBit(writter, bit);
 #ifdef DUMP_VERIFICATION
-            wf_codes << (bit ? '1' : '0');
+            if(m_dump) {
+                wf_codes << (bit ? '1' : '0');
+            }
 #endif
         }
 #ifdef DUMP_VERIFICATION
-        wf_codes << '\n';
+        if(m_dump) {
+            wf_codes << '\n';
+        }
 #endif
     }
 #ifdef DUMP_VERIFICATION
@@ -690,19 +786,21 @@ void Encoder::encodeParallelOneQuadrupleSeedPixel(
  * (e.g. when going to new row or when pixel is seed pixel).
  * YCCC_prev is updated with current YCCC values.
 */
+template<typename V>
 void Encoder::encodeParallelOneQuadruple(
    std::uint16_t gb,
    std::uint16_t b,
    std::uint16_t r,
    std::uint16_t gr,
-   std::int16_t* YCCC_prev,
+   V* YCCC_prev,
    std::uint32_t* A,
    std::uint32_t& N,
    std::uint32_t N_threshold,
    std::uint8_t last,
    Writter_s writter)
 {
-    std::int16_t YCCC[] = {0, 0, 0, 0};
+    using U  = std::make_unsigned_t<V>;
+    V YCCC[] = {0, 0, 0, 0};
 
     // 1.) BayerCFA to YCCC
     Helpers::transformColorGB(
@@ -717,14 +815,14 @@ void Encoder::encodeParallelOneQuadruple(
        m_lossyBits);   //
 
     // 2.) to dpcm: difference between prev pixel and current pixel.
-    std::int16_t dpcm[] = {0, 0, 0, 0};
+    V dpcm[] = {0, 0, 0, 0};
     for(std::size_t ch = 0; ch < 4; ch++) {
         dpcm[ch] = YCCC[ch] - YCCC_prev[ch];   // dX(n) = X(n) - X(n-1)
     }
 
 #ifdef DUMP_VERIFICATION
-    {
-        static std::ofstream wf_dpcm;
+    if(m_dump) {
+        static thread_local std::ofstream wf_dpcm;
         if((m_row == 0) & (m_col == 1)) {
             char outputFile[200];
             std::sprintf(
@@ -742,10 +840,10 @@ void Encoder::encodeParallelOneQuadruple(
         }
         char txt[200];
 
-        int16_t mask_Y      = (1 << (m_bpp + 2)) - 1;   // 0x03FF
-        int16_t mask_C      = (1 << (m_bpp + 1)) - 1;   // 0x01FF;
-        int16_t mask_Y_dpcm = (1 << (m_bpp + 3)) - 1;   // 0x07FF;
-        int16_t mask_C_dpcm = (1 << (m_bpp + 2)) - 1;   // 0x03FF;
+        V mask_Y      = (1 << (m_bpp + 2)) - 1;   // 0x03FF
+        V mask_C      = (1 << (m_bpp + 1)) - 1;   // 0x01FF;
+        V mask_Y_dpcm = (1 << (m_bpp + 3)) - 1;   // 0x07FF;
+        V mask_C_dpcm = (1 << (m_bpp + 2)) - 1;   // 0x03FF;
 
         std::sprintf(
            txt,
@@ -772,15 +870,15 @@ void Encoder::encodeParallelOneQuadruple(
 #endif
 
     // 3.) To positive value
-    std::uint16_t posValue[] = {0, 0, 0, 0};
+    U posValue[] = {0, 0, 0, 0};
     for(std::size_t ch = 0; ch < 4; ch++) {   //
-        posValue[ch] = (std::uint16_t)toAbsSingle(dpcm[ch]);
+        posValue[ch] = (U)toAbsSingle(dpcm[ch]);
     }
 
     // 4.) AGOR
-    std::uint16_t quotient[]  = {0, 0, 0, 0};
-    std::uint16_t remainder[] = {0, 0, 0, 0};
-    std::uint16_t k[]         = {m_k_min, m_k_min, m_k_min, m_k_min};
+    U quotient[]      = {0, 0, 0, 0};
+    U remainder[]     = {0, 0, 0, 0};
+    std::uint16_t k[] = {m_k_min, m_k_min, m_k_min, m_k_min};
 
     for(std::size_t ch = 0; ch < 4; ch++) {
         for(std::size_t it = m_k_min; it < m_k_max; it++) {
@@ -791,12 +889,12 @@ void Encoder::encodeParallelOneQuadruple(
             }
         }
         quotient[ch]  = posValue[ch] >> k[ch];
-        remainder[ch] = posValue[ch] & (std::uint16_t)((1 << k[ch]) - 1);   // modulus op = take last k bits
+        remainder[ch] = posValue[ch] & (U)((1 << k[ch]) - 1);   // modulus op = take last k bits
     }
 
 #ifdef DUMP_VERIFICATION
-    {
-        static std::ofstream wf_calc;
+    if(m_dump) {
+        static thread_local std::ofstream wf_calc;
         if((m_row == 0) & (m_col == 1)) {
             char outputFile[200];
             std::sprintf(
@@ -836,8 +934,8 @@ void Encoder::encodeParallelOneQuadruple(
 #endif
 
 #ifdef DUMP_VERIFICATION
-    {
-        static std::ofstream wf_qr;
+    if(m_dump) {
+        static thread_local std::ofstream wf_qr;
         if((m_row == 0) & (m_col == 1)) {
             char outputFile[200];
             std::sprintf(outputFile, "%s/dump/%s%02zu_qr.txt", m_folderOut, m_fileName, m_imgIdx);
@@ -871,8 +969,8 @@ void Encoder::encodeParallelOneQuadruple(
             wf_qr.close();
         }
     }
-    {
-        static std::ofstream wf_qr;
+    if(m_dump) {
+        static thread_local std::ofstream wf_qr;
         if((m_row == 0) & (m_col == 1)) {
             char outputFile[200];
             std::sprintf(outputFile, "%s/dump/%s%02zu_qrK.txt", m_folderOut, m_fileName, m_imgIdx);
@@ -930,8 +1028,8 @@ void Encoder::encodeParallelOneQuadruple(
 
     // 6.) Encode
 #ifdef DUMP_VERIFICATION
-    static std::ofstream wf_codes;
-    if((m_row == 0) & (m_col == 1)) {
+    static thread_local std::ofstream wf_codes;
+    if(m_dump & (m_row == 0) & (m_col == 1)) {
         char outputFile[200];
         std::sprintf(outputFile, "%s/dump/%s%02zu_codes.txt", m_folderOut, m_fileName, m_imgIdx);
         wf_codes.open(outputFile, std::ios::app);
@@ -944,33 +1042,39 @@ void Encoder::encodeParallelOneQuadruple(
 #endif
     for(std::size_t ch = 0; ch < 4; ch++) {
 #ifdef DUMP_VERIFICATION
-        char txt[200];
-        std::size_t code_len =
-           ((std::size_t)(quotient[ch] + 1 + k[ch]) < (m_k_seed + m_unaryMaxWidth) ? quotient[ch] + 1 + k[ch]
-                                                                                   : (m_k_seed + m_unaryMaxWidth));
-        std::sprintf(
-           txt,
-           "%4zu %4zu : %4hu  : %4hu  : %2hu : %3zu ",
-           m_row,
-           m_col,
-           quotient[ch],
-           remainder[ch],
-           k[ch],
-           code_len);
-        wf_codes << txt;
+        if(m_dump) {
+            char txt[200];
+            std::size_t code_len =
+               ((std::size_t)(quotient[ch] + 1 + k[ch]) < (m_k_seed + m_unaryMaxWidth) ? quotient[ch] + 1 + k[ch]
+                                                                                       : (m_k_seed + m_unaryMaxWidth));
+            std::sprintf(
+               txt,
+               "%4zu %4zu : %4hu  : %4hu  : %2hu : %3zu ",
+               m_row,
+               m_col,
+               quotient[ch],
+               remainder[ch],
+               k[ch],
+               code_len);
+            wf_codes << txt;
+        }
 #endif
         /* check if it fits to GR encoding or should it switch to limited encoding */
         if(quotient[ch] < m_unaryMaxWidth) {
             // unary coding of quotient
-            for(std::uint16_t n = 0; n < quotient[ch]; n++) { /* big endian */
+            for(U n = 0; n < quotient[ch]; n++) { /* big endian */
                 pushBit_1(writter);
 #ifdef DUMP_VERIFICATION
-                wf_codes << '1';
+                if(m_dump) {
+                    wf_codes << '1';
+                }
 #endif
             }
             pushBit_0(writter);
 #ifdef DUMP_VERIFICATION
-            wf_codes << '0';
+            if(m_dump) {
+                wf_codes << '0';
+            }
 #endif
             /* remainder coding */
             // for(std::int16_t n = k[ch]; n > 0; n--) {   /* MSB first */
@@ -981,7 +1085,9 @@ void Encoder::encodeParallelOneQuadruple(
                 std::uint32_t bit = (remainder[ch] >> n) & (std::uint32_t)1;
                 pushBit(writter, bit);
 #ifdef DUMP_VERIFICATION
-                wf_codes << (bit ? '1' : '0');
+                if(m_dump) {
+                    wf_codes << (bit ? '1' : '0');
+                }
 #endif
             }
         } else {
@@ -989,23 +1095,29 @@ void Encoder::encodeParallelOneQuadruple(
             for(std::uint16_t n = 0; n < m_unaryMaxWidth; n++) {   //
                 pushBit_1(writter);
 #ifdef DUMP_VERIFICATION
-                wf_codes << '1';
+                if(m_dump) {
+                    wf_codes << '1';
+                }
 #endif
             }
             for(std::uint16_t n = 0; n < m_k_seed; n++) { /* LSB first */
                 std::uint32_t bit = (posValue[ch] >> n) & (std::uint32_t)1;
                 pushBit(writter, bit);
 #ifdef DUMP_VERIFICATION
-                wf_codes << (bit ? '1' : '0');
+                if(m_dump) {
+                    wf_codes << (bit ? '1' : '0');
+                }
 #endif
             }
         }
 #ifdef DUMP_VERIFICATION
-        wf_codes << '\n';
+        if(m_dump) {
+            wf_codes << '\n';
+        }
 #endif
     }
 #ifdef DUMP_VERIFICATION
-    if((m_row == m_height - 1) & (m_col == m_width - 1)) {   //
+    if(m_dump & (m_row == m_height - 1) & (m_col == m_width - 1)) {   //
         wf_codes.close();
     }
 #endif
@@ -1076,6 +1188,11 @@ std::int16_t Encoder::toAbsSingle(const std::int16_t src)
     return (src < 0) ? (-2 * (std::int32_t)src - 1) : (2 * (std::int32_t)src);
 }
 
+std::int32_t Encoder::toAbsSingle(const std::int32_t src)
+{
+    return (src < 0) ? (-2 * src - 1) : (2 * src);
+}
+
 /**
  * Calculates difference between actual and predicted value for all channels.
  */
@@ -1259,7 +1376,7 @@ void Encoder::adaptiveGolombRiceSingleSeedInTwos(
     std::size_t length = height * width;
 
     std::uint32_t A = A_init;   // floor(2^16+32)/64
-    std::uint32_t N = 4;
+    std::uint32_t N = N_START;   // same as Decoder::decodeBitstream
 
     /* Seed pixel will be encoded using two's complement so just cast it. */
     q[0]       = (std::int16_t)dpcm[0];
@@ -1327,6 +1444,93 @@ std::size_t Encoder::getFileSize() const
     return m_fileSize;
 };
 
+/**
+ * Select bit packing order of parallel bitstream. LSB first lets decoder fetch bits with single
+ * unaligned 64-bit loads (see ReaderLSB). Order is stored as OMLS_FLAG_LSB_FIRST in the header.
+*/
+void Encoder::setBitOrderLSBFirst(bool lsbFirst)
+{
+    m_lsbFirst = lsbFirst;
+};
+
+/**
+ * Sets CFA pattern of the input, stored in the header. Parallel encoding reads BayerView quads in this pattern,
+ * channel input (ImageYCCC) must be gathered with the same pattern (Helpers::bayer_to_YCCC).
+*/
+void Encoder::setCfaPattern(cfaPattern pattern)
+{
+    m_cfaPattern = pattern;
+}
+
+/**
+ * Sets sensor position of the encoded image, written to the ROI header. Parallel version takes it from BayerView.
+*/
+void Encoder::setRoiOffset(std::uint16_t offsetX, std::uint16_t offsetY)
+{
+    m_roiOffsetX = offsetX;
+    m_roiOffsetY = offsetY;
+};
+
+/**
+ * Redirects compressed output of parallel and planar versions to @param pOut (e.g. an archive buffer) instead of
+ * a file per image. nullptr restores file output.
+*/
+void Encoder::setOutputStream(std::ostream* pOut)
+{
+    m_pOut = pOut;
+};
+
+/**
+ * Compressed output is padded with zeros to a multiple of @param bytes, e.g. FRAME_WRITER_BLOCK so frames
+ * recorded with O_DIRECT stay block aligned. Default BITSTREAM_PAD_ALIGNMENT.
+*/
+void Encoder::setPadAlignment(std::size_t bytes)
+{
+    if(bytes == 0) {
+        throw std::runtime_error("Pad alignment must not be 0.");
+    }
+    m_padAlignment = bytes;
+};
+
+/**
+ * Header gets @param timestamp [ms] (e.g. capture time of frame) instead of the time of encoding. 0 restores
+ * system time.
+*/
+void Encoder::setTimestamp(std::uint64_t timestamp)
+{
+    m_timestamp = timestamp;
+};
+
+/**
+ * Verification dumps to <folderOut>/dump are written by DUMP_VERIFICATION builds unless @param dump is false,
+ * e.g. for continuous encoding of a camera stream. No effect in other builds.
+*/
+void Encoder::setDumpVerification(bool dump)
+{
+    m_dump = dump;
+};
+
+/**
+ * Progress and header values are printed to stdout unless @param verbose is false, e.g. when frames are encoded
+ * on several threads or stdout carries compressed data.
+*/
+void Encoder::setVerbose(bool verbose)
+{
+    m_verbose = verbose;
+};
+
+/**
+ * Select header version of parallel bitstream: OMLS_HEADER_VERSION (default) or 1 for legacy 24-byte header
+ * (layout then depends on header_bytes).
+*/
+void Encoder::setHeaderVersion(std::uint16_t version)
+{
+    if(version != 1 && version != OMLS_HEADER_VERSION) {
+        throw std::runtime_error("setHeaderVersion(): Unsupported header version.");
+    }
+    m_headerVersion = version;
+};
+
 /**
  * Generate and write bitstream for all channels. Returns pointer to vector with channel sizes in bytes.
 */
@@ -1372,6 +1576,91 @@ std::unique_ptr<std::vector<std::size_t>> Encoder::encodeBitstreamAll()
     return std::make_unique<std::vector<std::size_t>>(std::forward<std::vector<std::size_t>>(bytesWritten));
 }
 
+/**
+ * Channel planar version of encodeBitstreamAll. Each channel is differentiated, coded and flushed to
+ * a byte boundary on its own thread. Channel offsets are stored in header (OMLS_EXT_CHANNEL_OFFSETS),
+ * so decoder can also decode channels in parallel. Returns pointer to vector with channel sizes in bytes.
+*/
+std::unique_ptr<std::vector<std::size_t>> Encoder::encodePlanar()
+{
+    char fileName[200];
+    sprintf(fileName, "%s/compressed/%s%02zu.bin", m_folderOut, m_fileName, m_imgIdx);
+
+    std::ostringstream channelStreams[4];
+    std::thread threads[4];
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        threads[ch] = std::thread(&Encoder::encodeChannelPlanar, this, (sQuadChannelCS::Channel)ch, &channelStreams[ch]);
+    }
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        threads[ch].join();
+    }
+
+    std::vector<std::size_t> bytesWritten(4);
+    std::uint64_t offsets[4];
+    std::uint64_t offset = 0;
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        bytesWritten[ch] = channelStreams[ch].view().size();
+        offsets[ch]      = offset;
+        offset += bytesWritten[ch];
+    }
+
+    std::uint32_t bfr    = 0;
+    std::size_t bitCnt   = 0;
+    std::size_t bytesCnt = 0;
+    std::ofstream wf;
+    std::ostream* pOut = m_pOut;
+    if(!pOut) {
+        wf.open(fileName, std::ios::out | std::ios::binary);
+        if(!wf) {
+            char msg[200];
+            sprintf(msg, "Cannot open specified file: %s", fileName);
+            throw std::runtime_error(msg);
+        }
+        pOut = &wf;
+    }
+
+    Writter_s writter{pOut, &bfr, &bitCnt, &bytesCnt};
+
+    std::vector<std::uint8_t> extensions;
+    appendOmlsHeaderExtension(extensions, OMLS_EXT_CHANNEL_OFFSETS, offsets, sizeof(offsets));
+    pushHeaderV2(writter, OMLS_FLAG_CHANNEL_PLANAR, extensions);
+
+    for(std::size_t ch = 0; ch < 4; ch++) {
+        pOut->write(channelStreams[ch].view().data(), bytesWritten[ch]);
+        bytesCnt += bytesWritten[ch];
+    }
+    flushBitstream(writter);
+    m_fileSize = bytesCnt;
+
+    return std::make_unique<std::vector<std::size_t>>(std::forward<std::vector<std::size_t>>(bytesWritten));
+}
+
+/**
+ * Differentiates, codes and writes single channel to @param pOut, flushed to a byte boundary.
+ * Touches only data of channel @param ch, so channels can run concurrently.
+*/
+void Encoder::encodeChannelPlanar(sQuadChannelCS::Channel ch, std::ostream* pOut)
+{
+    differentiateDiffUp(ch);
+    adaptiveGolombRiceSingleSeedInTwos(
+       m_dpcm.getChannel(ch).data(),
+       m_height,
+       m_width,
+       m_quotient.getChannel(ch).data(),
+       m_remainder.getChannel(ch).data(),
+       m_kValues.getChannel(ch).data(),
+       m_N_threshold,
+       m_A_init);
+
+    std::uint32_t bfr    = 0;
+    std::size_t bitCnt   = 0;
+    std::size_t bytesCnt = 0;
+    Writter_s writter{pOut, &bfr, &bitCnt, &bytesCnt};
+
+    encodeBitstreamOnChannel(writter, ch);
+    flushByte(writter);
+}
+
 /**
  * Generate and write bitstream for specific channel. If seedInTwosComplement = true
  * then encode first value in two's complement.
@@ -1457,13 +1746,16 @@ void Encoder::pushBit_0(Writter_s writter)
  */
 void Encoder::pushBit(Writter_s writter, std::uint32_t bit)
 {
-
-    if(bit == 1) {
+    if(bit > 1) {
+        throw std::runtime_error("Non bit value suppplied to pushBit");
+    }
+    if(m_lsbFirst) {
+        /* LSB first: n-th bit of a byte goes to bit position n */
+        *writter.m_pBfr = (*writter.m_pBfr & ~((uint32_t)1 << *writter.m_pBitCnt)) | (bit << *writter.m_pBitCnt);
+    } else if(bit == 1) {
         *writter.m_pBfr = (*writter.m_pBfr << 1) | (uint32_t)1;
-    } else if(bit == 0) {
-        *writter.m_pBfr = (*writter.m_pBfr << 1) & ~((uint32_t)1);
     } else {
-        throw std::runtime_error("Non bit value suppplied to pushBit");
+        *writter.m_pBfr = (*writter.m_pBfr << 1) & ~((uint32_t)1);
     }
     (*(writter.m_pBitCnt))++;
     // Buffer full (8 bits collected), write new byte to file.
@@ -1482,6 +1774,58 @@ void Encoder::pushHeader(Writter_s writter, std::uint64_t header)
     (*writter.m_pBytesCnt) += sizeof(header);
 }
 
+/**
+ * Timestamp of header in milliseconds: set by setTimestamp(), otherwise current system time.
+*/
+std::uint64_t Encoder::headerTimestamp() const
+{
+    if(m_timestamp) {
+        return m_timestamp;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+       .count();
+}
+
+/**
+ * Writes version 2 header with additional @param flags and @param extensions (already padded, see
+ * appendOmlsHeaderExtension). See OmlsHeader.hpp for layout.
+*/
+void Encoder::pushHeaderV2(Writter_s writter, std::uint32_t flags, const std::vector<std::uint8_t>& extensions)
+{
+    OmlsHeaderV2_t header{};
+    memcpy(header.magic, OMLS_HEADER_MAGIC, OMLS_HEADER_MAGIC_SIZE);
+    header.version      = OMLS_HEADER_VERSION;
+    header.headerLength = OMLS_HEADER_V2_SIZE + extensions.size();
+    header.flags        = flags | (m_lsbFirst ? OMLS_FLAG_LSB_FIRST : 0) | cfaPatternFlags(m_cfaPattern);
+    header.timestamp    = headerTimestamp();
+    std::uint64_t offset_y = m_roiOffsetY;
+    std::uint64_t offset_x = m_roiOffsetX;
+    header.roi = (2 * m_height & 0xFFFF) << 48 | (2 * m_width & 0xFFFF) << 32 | offset_y << 16 | offset_x;
+    header.width         = 2 * m_width;
+    header.height        = 2 * m_height;
+    header.unaryMaxWidth = m_unaryMaxWidth;
+    header.bpp           = m_bpp;
+    header.lossyBits     = m_lossyBits;
+
+    if(m_verbose) {
+        std::cout << "Compression Image timestamp: " << header.timestamp << std::endl;
+    }
+
+    writter.m_pWf->write((const char*)&header, sizeof(header));
+    writter.m_pWf->write((const char*)extensions.data(), extensions.size());
+    (*writter.m_pBytesCnt) += sizeof(header) + extensions.size();
+}
+
+/**
+ * Fill in '0' to missing bits of last byte and write it.
+*/
+void Encoder::flushByte(Writter_s writter)
+{
+    while(*writter.m_pBitCnt != 0) {
+        pushBit_0(writter);
+    }
+}
+
 /**
  * Flush last byte. Fill in '0' to missing bits and write to file.
 */
@@ -1491,8 +1835,8 @@ void Encoder::flushBitstream(Writter_s writter)
         pushBit_0(writter);
     }
 
-    if(*writter.m_pBytesCnt % 16 != 0) {
-        for(auto n = 16 - (*writter.m_pBytesCnt % 16); n > 0; n--) {   //
+    if(*writter.m_pBytesCnt % m_padAlignment != 0) {
+        for(auto n = m_padAlignment - (*writter.m_pBytesCnt % m_padAlignment); n > 0; n--) {   //
             for(auto n = 8; n > 0; n--) {   //
                 pushBit_0(writter);
             }
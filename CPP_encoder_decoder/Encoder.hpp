@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Cfa.hpp"
 #include "ImageYCCC.hpp"
+#include "OmlsHeader.hpp"
+#include "YcccType.hpp"
 #include "globalDefines.hpp"
 #include "helpers.hpp"
 #include <cstdint>
@@ -9,21 +12,22 @@
 #include <span>
 
 struct Writter_s {
-    std::ofstream* m_pWf;
+    std::ostream* m_pWf;
     std::uint32_t* m_pBfr;
     std::size_t* m_pBitCnt;
     std::size_t* m_pBytesCnt;
 
     explicit Writter_s();
-    explicit Writter_s(std::ofstream* pWf, std::uint32_t* pBfr, std::size_t* pBitCnt, std::size_t* pBytes);
+    explicit Writter_s(std::ostream* pWf, std::uint32_t* pBfr, std::size_t* pBitCnt, std::size_t* pBytes);
 };
 
 class Encoder
 {
   private:
-    const Image* m_pImg         = nullptr;
+    BayerView m_view;   // input of parallel version, may be a window of a larger frame
     const ImageYCCC* m_pImgYCCC = nullptr;
     std::size_t m_width, m_height, m_length;
+    PlaneArena m_planeArena;   // single allocation for the 5 quad channels below (sequential version)
     sQuadChannelCS m_kValues;
     sQuadChannelCS m_dpcm;   // max value 2*max(dpcm) = 1020 - 0 = 1020 (Y channel), 255 - -255 = 510 (others)
     sQuadChannelCS m_abs;   // max value 2*max(dpcm) = 2*1020 = 2040 (max val for int16 = 32768)
@@ -42,12 +46,37 @@ class Encoder
     std::uint16_t m_k_min       = 0;
     std::uint16_t m_k_max       = 0;
     std::uint64_t m_roi         = 0;
+    std::uint16_t m_roiOffsetX  = 0;   // position of encoded window on the sensor, stored in ROI header
+    std::uint16_t m_roiOffsetY  = 0;
     std::size_t m_fileSize      = 0;
     std::size_t m_idealRule     = 0;
+    bool m_lsbFirst             = false;
+    cfaPattern m_cfaPattern     = cfaPattern::gbrg;
+    std::uint16_t m_headerVersion = OMLS_HEADER_VERSION;
+    std::ostream* m_pOut          = nullptr;   // compressed output, file in m_folderOut if nullptr
+    std::size_t m_padAlignment    = BITSTREAM_PAD_ALIGNMENT;
+    std::uint64_t m_timestamp     = 0;   // header timestamp [ms], system time if 0
+    bool m_dump                   = true;   // verification dumps of DUMP_VERIFICATION builds
+    bool m_verbose                = true;   // progress and header printed to stdout
+    struct parallelState_s {   // encodeParallel codes one quadruple per call, frame state kept between calls
+        std::size_t idx = 0;
+        std::uint32_t bfr;
+        std::size_t bitCnt;
+        std::size_t bytesCnt;
+        std::ofstream wf;
+        std::ostream* pOut;
+        Writter_s writter;
+        std::int16_t YCCC_prev[4];
+        std::int16_t YCCC_up[4];
+        std::int32_t YCCC_prev_wide[4];   // replace the two above for bpp over OMLS_YCCC16_MAX_BPP
+        std::int32_t YCCC_up_wide[4];
+        std::uint32_t A[4];
+        std::uint32_t N;
+    } m_parallel;
 #ifdef DUMP_VERIFICATION
     std::size_t m_row                 = 0;
     std::size_t m_col                 = 0;
-    std::ofstream m_wf_bitstream      = 0;
+    std::ofstream m_wf_bitstream;
     std::size_t m_ASCII_bitstream_cnt = 0;
     std::size_t m_charsInRow          = 0;
 #endif
@@ -81,12 +110,25 @@ class Encoder
        std::uint8_t bpp,
        std::size_t header_bytes,
        const char* fileName);
+    Encoder(
+       const BayerView& view,
+       const char* folderOut,
+       std::size_t imgIdx,
+       std::uint32_t A_init,
+       std::uint32_t N_threshold,
+       std::size_t lossyBits,
+       std::size_t unaryMaxWidth,
+       std::uint8_t bpp,
+       std::size_t header_bytes,
+       const char* fileName);
     Encoder(
        const ImageYCCC* pImgYCCC,
        const char* folderOut,
        std::size_t imgIdx,
        std::size_t lossyBits,
-       std::size_t header_bytes);
+       std::size_t header_bytes,
+       std::uint8_t bpp,
+       const char* fileName);
 
     std::unique_ptr<std::vector<std::size_t>> encodeUsingMethod(Encoder::method method);
 
@@ -98,25 +140,28 @@ class Encoder
     const sQuadChannelCS* getDpcmChannelsConst() const;
 
     std::unique_ptr<std::vector<std::size_t>> runParallelCompression();
+    template<typename V>
     std::size_t encodeParallel(
        std::uint16_t gb,   //
        std::uint16_t b,
        std::uint16_t r,
        std::uint16_t gr);
+    template<typename V>
     void encodeParallelOneQuadrupleSeedPixel(
        std::uint16_t gb,   //
        std::uint16_t b,
        std::uint16_t r,
        std::uint16_t gr,
-       std::int16_t* YCCC_prev,
+       V* YCCC_prev,
        std::uint32_t* A,
        Writter_s writter);
+    template<typename V>
     void encodeParallelOneQuadruple(
        std::uint16_t gb,
        std::uint16_t b,
        std::uint16_t r,
        std::uint16_t gr,
-       std::int16_t* YCCC_prev,
+       V* YCCC_prev,
        std::uint32_t* A,
        std::uint32_t& N,
        std::uint32_t N_threshold,
@@ -125,6 +170,7 @@ class Encoder
 
     void toAbs(const std::int16_t* src, std::int16_t* dst, std::size_t length);
     std::int16_t toAbsSingle(const std::int16_t src);
+    std::int32_t toAbsSingle(const std::int32_t src);
     void toAbsAll();
     void toAbsAll(const sQuadChannelCS* pIn);
 
@@ -152,8 +198,19 @@ class Encoder
     std::size_t getFileSize() const;
     const std::size_t getGolombRiceParameter_k() const;
     void setGolombRiceParameter_k(std::uint32_t new_k);
+    void setBitOrderLSBFirst(bool lsbFirst);
+    void setCfaPattern(cfaPattern pattern);
+    void setHeaderVersion(std::uint16_t version);
+    void setRoiOffset(std::uint16_t offsetX, std::uint16_t offsetY);
+    void setOutputStream(std::ostream* pOut);
+    void setPadAlignment(std::size_t bytes);
+    void setTimestamp(std::uint64_t timestamp);
+    void setDumpVerification(bool dump);
+    void setVerbose(bool verbose);
 
     std::unique_ptr<std::vector<std::size_t>> encodeBitstreamAll();
+    std::unique_ptr<std::vector<std::size_t>> encodePlanar();
+    void encodeChannelPlanar(sQuadChannelCS::Channel ch, std::ostream* pOut);
     std::size_t encodeBitstreamOnChannel(   //
        Writter_s writter,
        sQuadChannelCS::Channel ch);
@@ -167,9 +224,12 @@ class Encoder
 
     void pushBit(Writter_s writter, std::uint32_t bit);
     void pushHeader(Writter_s writter, std::uint64_t header);
+    std::uint64_t headerTimestamp() const;
+    void pushHeaderV2(Writter_s writter, std::uint32_t flags = 0, const std::vector<std::uint8_t>& extensions = {});
     void pushBit_1(Writter_s writter);
     void pushBit_0(Writter_s writter);
     void flushBitstream(Writter_s writter);
+    void flushByte(Writter_s writter);
 
     void dumpAbsToFile(const char* fileName);
     void dumpQuotientToFile(const char* fileName);
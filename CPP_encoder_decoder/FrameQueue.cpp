@@ -0,0 +1,104 @@
+#include "FrameQueue.hpp"
+#include <chrono>
+
+#define FRAME_QUEUE_POLL_MS 100 /* Longest wait of a blocked input before it checks for stop */
+
+FrameQueue::FrameQueue(std::size_t depth)
+   : m_frames(depth ? depth : 1)
+{
+    for(std::size_t i = 0; i < m_frames.size(); i++) {
+        m_free.push_back(i);
+    }
+}
+
+queuedFrame_t& FrameQueue::frame(int index)
+{
+    return m_frames[index];
+}
+
+/**
+ * Input side: frame to fill with the arriving one, handling a full queue by @param policy.
+ * -1 if the arriving frame is dropped or @param stop was set while waiting.
+*/
+int FrameQueue::acquire(dropPolicy policy, const std::atomic<bool>& stop, std::atomic<std::uint64_t>& dropped)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for(;;) {
+        if(!m_free.empty()) {
+            int index = m_free.back();
+            m_free.pop_back();
+            return index;
+        }
+        if(policy == dropPolicy::dropNewest) {
+            dropped++;
+            return -1;
+        }
+        if(policy == dropPolicy::dropOldest && !m_ready.empty()) {
+            int index = m_ready.front();
+            m_ready.pop_front();
+            dropped++;
+            return index;
+        }
+        if(stop) {
+            return -1;
+        }
+        m_freed.wait_for(lock, std::chrono::milliseconds(FRAME_QUEUE_POLL_MS));
+    }
+}
+
+void FrameQueue::publish(int index)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(index);
+    }
+    m_available.notify_one();
+}
+
+/**
+ * Returns a coded frame, or one acquired but not published (e.g. input ended in the middle of it).
+*/
+void FrameQueue::release(int index)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(index);
+    }
+    m_freed.notify_one();
+}
+
+/**
+ * Coding side: oldest published frame, waits for one. -1 once the queue is closed and empty.
+*/
+int FrameQueue::pop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_available.wait(lock, [this]() { return !m_ready.empty() || m_closed; });
+    if(m_ready.empty()) {
+        return -1;
+    }
+    int index = m_ready.front();
+    m_ready.pop_front();
+    return index;
+}
+
+/**
+ * Input has ended, pop() returns -1 once the remaining frames are taken.
+*/
+void FrameQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_available.notify_all();
+}
+
+/**
+ * Frames waiting to be coded.
+*/
+std::size_t FrameQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ready.size();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "FrameRing.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/*
+* What an input does with a frame arriving while its queue is full.
+*/
+enum class dropPolicy
+{
+    block,   // stop reading the input until a frame is taken, producer sees backpressure
+    dropOldest,   // replace the oldest queued frame, latency stays bounded
+    dropNewest   // discard the arriving frame
+};
+
+/*
+* Frame buffered between an input thread and the thread coding it.
+*/
+struct queuedFrame_t {
+    frameSlot_t slot;
+    std::vector<std::uint8_t> payload;
+    std::uint64_t arrival;   // us, steady clock
+};
+
+/*
+* Bounded queue of frames whose buffers are allocated once and reused, so an input runs without allocations
+* once its frame size is known. One thread fills frames (acquire(), publish()), one codes them (pop(), release()).
+*/
+class FrameQueue
+{
+  private:
+    std::vector<queuedFrame_t> m_frames;
+    std::vector<int> m_free;
+    std::deque<int> m_ready;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_freed;
+    std::condition_variable m_available;
+    bool m_closed = false;
+
+  public:
+    explicit FrameQueue(std::size_t depth);
+
+    queuedFrame_t& frame(int index);
+    int acquire(dropPolicy policy, const std::atomic<bool>& stop, std::atomic<std::uint64_t>& dropped);
+    void publish(int index);
+    void release(int index);
+    int pop();
+    void close();
+    std::size_t size() const;
+};
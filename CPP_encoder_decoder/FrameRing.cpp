@@ -0,0 +1,265 @@
+#include "FrameRing.hpp"
+#include <cstring>
+#include <new>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * POSIX shared memory names start with a slash, Windows mapping names may not contain one.
+*/
+static std::string sharedName(const char* name)
+{
+#ifdef _WIN32
+    return name[0] == '/' ? name + 1 : name;
+#else
+    return name[0] == '/' ? name : std::string("/") + name;
+#endif
+}
+
+FrameRing::FrameRing() {}
+
+FrameRing::~FrameRing()
+{
+    close();
+}
+
+/**
+ * Creates ring @param name with @param slotCount slots of @param slotSize payload bytes, replacing an existing one.
+*/
+STATUS_t FrameRing::create(const char* name, std::uint32_t slotCount, std::uint64_t slotSize)
+{
+    close();
+    if(slotCount == 0 || slotSize == 0) {
+        return BASE_RING_INVALID;
+    }
+    const std::uint64_t stride =
+       (sizeof(frameSlot_t) + slotSize + OMLS_RING_CACHE_LINE - 1) / OMLS_RING_CACHE_LINE * OMLS_RING_CACHE_LINE;
+    const std::uint64_t size = sizeof(frameRingHeader_t) + stride * slotCount;
+
+#ifdef _WIN32
+    m_hMapping = CreateFileMappingA(
+       INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, sharedName(name).c_str());
+    if(!m_hMapping) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    void* pMapped = MapViewOfFile(m_hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if(!pMapped) {
+        close();
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+#else
+    int fd = shm_open(sharedName(name).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if(fd < 0) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    void* pMapped = ftruncate(fd, size) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                                             : MAP_FAILED;
+    ::close(fd);
+    if(pMapped == MAP_FAILED) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+#endif
+    m_mappedSize = size;
+    m_pHeader    = new(pMapped) frameRingHeader_t{};
+
+    m_pHeader->version    = OMLS_RING_VERSION;
+    m_pHeader->slotCount  = slotCount;
+    m_pHeader->slotSize   = slotSize;
+    m_pHeader->slotStride = stride;
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_pHeader->magic, OMLS_RING_MAGIC, OMLS_RING_MAGIC_SIZE);
+
+    m_head = m_tail = m_cachedHead = m_cachedTail = 0;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Attaches to existing ring @param name. Returns BASE_RING_INVALID while the creator has not initialized it yet.
+*/
+STATUS_t FrameRing::open(const char* name)
+{
+    close();
+#ifdef _WIN32
+    m_hMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, sharedName(name).c_str());
+    if(!m_hMapping) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    void* pMapped = MapViewOfFile(m_hMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if(!pMapped || !VirtualQuery(pMapped, &info, sizeof(info))) {
+        close();
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    const std::uint64_t size = info.RegionSize;
+#else
+    int fd = shm_open(sharedName(name).c_str(), O_RDWR, 0600);
+    if(fd < 0) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    struct stat info;
+    void* pMapped = MAP_FAILED;
+    if(fstat(fd, &info) == 0 && (std::uint64_t)info.st_size >= sizeof(frameRingHeader_t)) {
+        pMapped = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if(pMapped == MAP_FAILED) {
+        return BASE_RING_INVALID;
+    }
+    const std::uint64_t size = info.st_size;
+#endif
+    m_mappedSize = size;
+    m_pHeader    = static_cast<frameRingHeader_t*>(pMapped);
+
+    const bool valid = memcmp(m_pHeader->magic, OMLS_RING_MAGIC, OMLS_RING_MAGIC_SIZE) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(!valid || m_pHeader->version != OMLS_RING_VERSION || m_pHeader->slotCount == 0
+       || m_pHeader->slotStride < sizeof(frameSlot_t) + m_pHeader->slotSize
+       || sizeof(frameRingHeader_t) + m_pHeader->slotStride * m_pHeader->slotCount > size) {
+        close();
+        return BASE_RING_INVALID;
+    }
+
+    m_head = m_cachedHead = m_pHeader->head.load(std::memory_order_acquire);
+    m_tail = m_cachedTail = m_pHeader->tail.load(std::memory_order_acquire);
+    return BASE_SUCCESS;
+}
+
+/**
+ * Unmaps the ring. Shared memory stays until remove() is called, so the other side may still drain it.
+*/
+void FrameRing::close()
+{
+    if(m_pHeader) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_pHeader);
+#else
+        munmap(m_pHeader, m_mappedSize);
+#endif
+        m_pHeader = nullptr;
+    }
+#ifdef _WIN32
+    if(m_hMapping) {
+        CloseHandle(m_hMapping);
+    }
+#endif
+    m_hMapping   = nullptr;
+    m_mappedSize = 0;
+}
+
+/**
+ * Removes ring @param name. On Windows the mapping disappears with its last handle.
+*/
+void FrameRing::remove(const char* name)
+{
+#ifndef _WIN32
+    shm_unlink(sharedName(name).c_str());
+#else
+    (void)name;
+#endif
+}
+
+std::uint32_t FrameRing::getSlotCount() const
+{
+    return m_pHeader ? m_pHeader->slotCount : 0;
+}
+
+std::uint64_t FrameRing::getSlotSize() const
+{
+    return m_pHeader ? m_pHeader->slotSize : 0;
+}
+
+frameSlot_t* FrameRing::slot(std::uint64_t index) const
+{
+    return reinterpret_cast<frameSlot_t*>(
+       reinterpret_cast<std::uint8_t*>(m_pHeader + 1) + (index % m_pHeader->slotCount) * m_pHeader->slotStride);
+}
+
+/**
+ * Producer: next free slot to fill in place, nullptr while the ring is full. Publish it with endWrite().
+*/
+frameSlot_t* FrameRing::beginWrite()
+{
+    if(m_head - m_cachedTail == m_pHeader->slotCount) {
+        m_cachedTail = m_pHeader->tail.load(std::memory_order_acquire);
+        if(m_head - m_cachedTail == m_pHeader->slotCount) {
+            return nullptr;
+        }
+    }
+    return slot(m_head);
+}
+
+void FrameRing::endWrite()
+{
+    m_pHeader->head.store(++m_head, std::memory_order_release);
+}
+
+/**
+ * Producer: no more frames follow, consumer sees isFinished() once it has read all published ones.
+*/
+void FrameRing::finish()
+{
+    m_pHeader->finished.store(1, std::memory_order_release);
+}
+
+/**
+ * Consumer: oldest published slot, nullptr while the ring is empty. Slot stays valid until endRead().
+*/
+const frameSlot_t* FrameRing::beginRead()
+{
+    if(m_tail == m_cachedHead) {
+        m_cachedHead = m_pHeader->head.load(std::memory_order_acquire);
+        if(m_tail == m_cachedHead) {
+            return nullptr;
+        }
+    }
+    return slot(m_tail);
+}
+
+void FrameRing::endRead()
+{
+    m_pHeader->tail.store(++m_tail, std::memory_order_release);
+}
+
+/**
+ * Consumer: producer has finished and all its frames were read.
+*/
+bool FrameRing::isFinished()
+{
+    if(!m_pHeader->finished.load(std::memory_order_acquire)) {
+        return false;
+    }
+    m_cachedHead = m_pHeader->head.load(std::memory_order_acquire);
+    return m_tail == m_cachedHead;
+}
+
+/**
+ * Raw payload holds height rows of pitch samples, at most @param maxPayload bytes, window size is a multiple of
+ * OMLS_SIZE_MULTIPLE so its stream can be decoded.
+*/
+bool isValidRawSlot(const frameSlot_t& slot, std::uint64_t maxPayload)
+{
+    return slot.width && slot.height && slot.width % OMLS_SIZE_MULTIPLE == 0 && slot.height % OMLS_SIZE_MULTIPLE == 0
+           && slot.width <= slot.pitch && slot.size == (std::uint64_t)slot.pitch * slot.height * sizeof(std::uint16_t)
+           && slot.size <= maxPayload;
+}
+
+FrameSlotBuffer::FrameSlotBuffer(frameSlot_t* pSlot, std::size_t capacity)
+{
+    char* pPayload = reinterpret_cast<char*>(pSlot->payload());
+    setp(pPayload, pPayload + capacity);
+}
+
+/**
+ * Bytes written to the slot so far.
+*/
+std::size_t FrameSlotBuffer::size() const
+{
+    return pptr() - pbase();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include <atomic>
+#include <cstdint>
+#include <streambuf>
+
+/*
+* Ring of fixed size frame slots in named shared memory, for passing frames between processes without files.
+* One producer and one consumer; slots are written and read in place. All fields little-endian.
+* address : content
+*       0 : frameRingHeader_t
+*     256 : slotCount slots, each a frameSlot_t followed by slotSize payload bytes, slotStride apart
+*
+* Producer fills slot head % slotCount and publishes it by incrementing head, consumer reads slot tail % slotCount
+* and frees it by incrementing tail. Both counters only grow, ring is full when head - tail == slotCount.
+*/
+
+#define OMLS_RING_MAGIC "\x89OMLSRNG"
+#define OMLS_RING_MAGIC_SIZE 8
+#define OMLS_RING_VERSION 1
+#define OMLS_RING_CACHE_LINE 64
+
+struct frameRingHeader_t {
+    std::uint8_t magic[OMLS_RING_MAGIC_SIZE];   // written last, ring is usable once it is valid
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint64_t slotSize;   // payload bytes of one slot
+    std::uint64_t slotStride;   // bytes between slots
+    alignas(OMLS_RING_CACHE_LINE) std::atomic<std::uint64_t> head;   // slots published by producer
+    alignas(OMLS_RING_CACHE_LINE) std::atomic<std::uint64_t> tail;   // slots released by consumer
+    alignas(OMLS_RING_CACHE_LINE) std::atomic<std::uint32_t> finished;   // producer publishes no more
+};
+static_assert(sizeof(frameRingHeader_t) == 256, "frameRingHeader_t must match the ring layout");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ring counters must be lock free across processes");
+
+/*
+* Slot descriptor, payload follows. Raw frames: BayerCFA samples as std::uint16_t, pitch samples per row.
+* Compressed frames: complete compressed stream as written by the encoder, pitch 0.
+*/
+struct frameSlot_t {
+    std::uint64_t size;   // payload bytes
+    std::uint64_t frameId;
+    std::uint64_t timestamp;   // us, capture time
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t pitch;
+    std::uint8_t bpp;
+    std::uint8_t reserved[27];
+
+    std::uint8_t* payload()
+    {
+        return reinterpret_cast<std::uint8_t*>(this + 1);
+    }
+    const std::uint8_t* payload() const
+    {
+        return reinterpret_cast<const std::uint8_t*>(this + 1);
+    }
+};
+static_assert(sizeof(frameSlot_t) == 64, "frameSlot_t must match the ring layout");
+
+bool isValidRawSlot(const frameSlot_t& slot, std::uint64_t maxPayload);
+
+/*
+* One side of a frame ring. Either side may create the ring, the other opens it. Calls never block: beginWrite()
+* returns nullptr while the ring is full, beginRead() while it is empty.
+*/
+class FrameRing
+{
+  private:
+    frameRingHeader_t* m_pHeader = nullptr;
+    std::size_t m_mappedSize     = 0;
+    void* m_hMapping             = nullptr;   // Windows file mapping handle
+    std::uint64_t m_head         = 0;   // producer: next slot to write
+    std::uint64_t m_tail         = 0;   // consumer: next slot to read
+    std::uint64_t m_cachedHead   = 0;   // consumer: last head seen, saves loading the producer's cache line
+    std::uint64_t m_cachedTail   = 0;   // producer: last tail seen
+
+    frameSlot_t* slot(std::uint64_t index) const;
+
+  public:
+    FrameRing();
+    FrameRing(const FrameRing&)            = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+    ~FrameRing();
+
+    STATUS_t create(const char* name, std::uint32_t slotCount, std::uint64_t slotSize);
+    STATUS_t open(const char* name);
+    void close();
+    static void remove(const char* name);
+
+    std::uint32_t getSlotCount() const;
+    std::uint64_t getSlotSize() const;
+
+    frameSlot_t* beginWrite();
+    void endWrite();
+    void finish();
+
+    const frameSlot_t* beginRead();
+    void endRead();
+    bool isFinished();
+};
+
+/*
+* Put area over the payload of a slot, so an encoder std::ostream writes compressed frames straight into shared
+* memory. Stream fails if the frame does not fit.
+*/
+class FrameSlotBuffer : public std::streambuf
+{
+  public:
+    FrameSlotBuffer(frameSlot_t* pSlot, std::size_t capacity);
+    std::size_t size() const;
+};
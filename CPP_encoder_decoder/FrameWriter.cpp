@@ -0,0 +1,313 @@
+#include "FrameWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Ring of @param bufferCount buffers of @param bufferSize bytes, rounded up to FRAME_WRITER_BLOCK. Write sizes are
+ * whole buffers, so larger buffers mean fewer, larger writes.
+*/
+FrameWriter::FrameWriter(std::size_t bufferSize, std::size_t bufferCount)
+   : m_bufferSize((bufferSize + FRAME_WRITER_BLOCK - 1) / FRAME_WRITER_BLOCK * FRAME_WRITER_BLOCK)
+   , m_buffers(bufferCount ? bufferCount : 1)
+   , m_inFlight(m_buffers.size(), 0)
+   , m_inFlightFd(m_buffers.size(), -1)
+{
+    if(m_bufferSize == 0) {
+        m_bufferSize = FRAME_WRITER_BLOCK;
+    }
+    for(auto& pBuffer : m_buffers) {
+        pBuffer = static_cast<std::uint8_t*>(::operator new(m_bufferSize, std::align_val_t{FRAME_WRITER_BLOCK}));
+    }
+    m_finished.reserve(m_buffers.size());   // each finished file has a buffer in flight
+}
+
+FrameWriter::~FrameWriter()
+{
+    close();
+    for(auto pBuffer : m_buffers) {
+        ::operator delete(pBuffer, std::align_val_t{FRAME_WRITER_BLOCK});
+    }
+}
+
+/**
+ * Creates @param fileName. With @param direct the page cache is bypassed where possible, see getBackend().
+ * Previous file is finished without waiting for its writes. Returns error of earlier writes, if any.
+*/
+STATUS_t FrameWriter::open(const char* fileName, bool direct)
+{
+    RETURN_ON_FAILURE(finishFile())
+    m_offset = 0;
+
+#ifdef __linux__
+    if(direct) {
+        m_fd = ::open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        if(m_fd >= 0) {
+            m_backend = backend::direct;
+#ifdef OMLS_IO_URING
+            if(!m_ringReady) {
+                m_ringReady = io_uring_queue_init(m_buffers.size(), &m_ring, 0) == 0;
+            }
+            if(m_ringReady) {
+                m_backend = backend::uring;
+            }
+#endif
+            resetPutArea();
+            return BASE_SUCCESS;
+        }
+    }
+#endif
+
+    m_backend = backend::buffered;
+    m_pFile   = fopen(fileName, "wb");
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    resetPutArea();
+    return BASE_SUCCESS;
+}
+
+/**
+ * Queues @param size bytes of @param data. Returns as soon as they are copied, unless a full buffer has to be
+ * written synchronously (direct backend) or the next buffer is still being written (io_uring backend).
+*/
+STATUS_t FrameWriter::write(const void* data, std::size_t size)
+{
+    if(m_status) {
+        return m_status;
+    }
+    if(!m_pFile && m_fd < 0) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    if(sputn(static_cast<const char*>(data), size) != (std::streamsize)size) {
+        if(m_status) {
+            return m_status;
+        }
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Current buffer becomes the put area, none after an error.
+*/
+void FrameWriter::resetPutArea()
+{
+    char* pBuffer = reinterpret_cast<char*>(m_buffers[m_current]);
+    if(m_status) {
+        setp(nullptr, nullptr);
+    } else {
+        setp(pBuffer, pBuffer + m_bufferSize);
+    }
+}
+
+/**
+ * Writes current buffer, @param bytes multiple of FRAME_WRITER_BLOCK for direct backends, and moves to the next
+ * buffer once it is free. Buffered backend keeps using the same buffer.
+*/
+STATUS_t FrameWriter::submit(std::size_t bytes)
+{
+    std::uint8_t* pBuffer = m_buffers[m_current];
+    if(m_backend == backend::buffered) {
+        if(fwrite(pBuffer, 1, bytes, m_pFile) != bytes) {
+            return m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        m_offset += bytes;
+        return BASE_SUCCESS;
+    }
+#ifdef OMLS_IO_URING
+    if(m_backend == backend::uring) {
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+        if(!sqe) {
+            return m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        io_uring_prep_write(sqe, m_fd, pBuffer, bytes, m_offset);
+        io_uring_sqe_set_data(sqe, (void*)(std::uintptr_t)m_current);
+        if(io_uring_submit(&m_ring) < 1) {
+            return m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        m_inFlight[m_current]   = bytes;
+        m_inFlightFd[m_current] = m_fd;
+    } else
+#endif
+    {
+#ifdef __linux__
+        if(pwrite(m_fd, pBuffer, bytes, m_offset) != (ssize_t)bytes) {
+            return m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+#endif
+    }
+    m_offset += bytes;
+    m_current = (m_current + 1) % m_buffers.size();
+    return waitFor(m_current);   // next buffer must be free before it is filled
+}
+
+/**
+ * Waits until @param buffer is not being written anymore. Finished files whose writes are all complete are closed.
+*/
+STATUS_t FrameWriter::waitFor(std::size_t buffer)
+{
+#ifdef OMLS_IO_URING
+    while(m_inFlight[buffer]) {
+        struct io_uring_cqe* cqe;
+        if(io_uring_wait_cqe(&m_ring, &cqe) < 0) {
+            std::fill(m_inFlight.begin(), m_inFlight.end(), 0);   // completions are lost, give up on them
+            m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+            break;
+        }
+        std::size_t done = (std::uintptr_t)io_uring_cqe_get_data(cqe);
+        if(cqe->res != (int)m_inFlight[done] && !m_status) {
+            m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        m_inFlight[done] = 0;
+        io_uring_cqe_seen(&m_ring, cqe);
+    }
+    closeFinished();
+#endif
+    (void)buffer;
+    return m_status;
+}
+
+/**
+ * Trims and closes finished files that have no writes in flight anymore.
+*/
+void FrameWriter::closeFinished()
+{
+    for(std::size_t i = 0; i < m_finished.size();) {
+        bool inFlight = false;
+        for(std::size_t buffer = 0; buffer < m_buffers.size(); buffer++) {
+            inFlight |= m_inFlight[buffer] && m_inFlightFd[buffer] == m_finished[i].fd;
+        }
+        if(inFlight) {
+            i++;
+            continue;
+        }
+        STATUS_t status = trimAndClose(m_finished[i].fd, m_finished[i].size);
+        if(status && !m_status) {
+            m_status = status;
+        }
+        m_finished[i] = m_finished.back();
+        m_finished.pop_back();
+    }
+}
+
+/**
+ * Trims file @param fd, written in whole FRAME_WRITER_BLOCKs, to @param size bytes and closes it.
+*/
+STATUS_t FrameWriter::trimAndClose(int fd, std::uint64_t size)
+{
+    STATUS_t status = BASE_SUCCESS;
+#ifdef __linux__
+    if(ftruncate(fd, size)) {
+        status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    if(::close(fd)) {
+        status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+#endif
+    (void)fd;
+    (void)size;
+    return status;
+}
+
+/**
+ * Submits the rest of the current file, padded to FRAME_WRITER_BLOCK, without waiting for it. The file is
+ * trimmed and closed right away if nothing of it is in flight, otherwise when its writes complete.
+*/
+STATUS_t FrameWriter::finishFile()
+{
+    const std::size_t fill   = pptr() - pbase();
+    const std::uint64_t size = m_offset + fill;
+    setp(nullptr, nullptr);
+
+    if(m_pFile) {
+        if(fill && !m_status) {
+            submit(fill);
+        }
+        if(fclose(m_pFile) && !m_status) {
+            m_status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+        }
+        m_pFile   = nullptr;
+        m_written = size;
+        return m_status;
+    }
+    if(m_fd < 0) {
+        return m_status;
+    }
+
+    if(fill && !m_status) {
+        std::size_t padded = (fill + FRAME_WRITER_BLOCK - 1) / FRAME_WRITER_BLOCK * FRAME_WRITER_BLOCK;
+        memset(m_buffers[m_current] + fill, 0, padded - fill);
+        submit(padded);
+    }
+    m_finished.push_back({m_fd, size});
+    m_fd      = -1;
+    m_written = size;
+    closeFinished();
+    return m_status;
+}
+
+/**
+ * Finishes the current file, waits for all writes and closes all files. Returns first error since the last
+ * close().
+*/
+STATUS_t FrameWriter::close()
+{
+    finishFile();
+    for(std::size_t buffer = 0; buffer < m_buffers.size(); buffer++) {
+        waitFor(buffer);
+    }
+    closeFinished();
+#ifdef OMLS_IO_URING
+    if(m_ringReady) {
+        io_uring_queue_exit(&m_ring);
+        m_ringReady = false;
+    }
+#endif
+    STATUS_t status = m_status;
+    m_status        = BASE_SUCCESS;
+    return status;
+}
+
+FrameWriter::backend FrameWriter::getBackend() const
+{
+    return m_backend;
+}
+
+/**
+ * Bytes written to the current file since open(), after close() the size of the last file.
+*/
+std::uint64_t FrameWriter::getBytesWritten() const
+{
+    if(!m_pFile && m_fd < 0) {
+        return m_written;
+    }
+    return m_offset + (pptr() - pbase());
+}
+
+/**
+ * Put area is full: writes it and continues in the next buffer.
+*/
+FrameWriter::int_type FrameWriter::overflow(int_type ch)
+{
+    if((!m_pFile && m_fd < 0) || m_status) {
+        return traits_type::eof();
+    }
+    if(pptr() == epptr()) {
+        STATUS_t status = submit(m_bufferSize);
+        resetPutArea();
+        if(status) {
+            return traits_type::eof();
+        }
+    }
+    if(traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+}
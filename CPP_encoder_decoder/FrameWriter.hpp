@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include "globalDefines.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <streambuf>
+#include <vector>
+
+#ifdef OMLS_IO_URING
+#include <liburing.h>
+#endif
+
+#define FRAME_WRITER_BLOCK 4096 /* O_DIRECT alignment of buffers, file offsets and write sizes */
+
+/**
+ * Sequential writer for recording compressed frames without going through the page cache. Frames are written
+ * into a ring of FRAME_WRITER_BLOCK aligned buffers, which is the put area of this std::streambuf, so an encoder
+ * std::ostream (Encoder::setOutputStream) writes straight into them. Full buffers are written with O_DIRECT,
+ * through io_uring when built with OMLS_IO_URING (the encoder keeps filling the next buffer meanwhile), otherwise
+ * with pwrite. Falls back to buffered stdio where O_DIRECT is not available (non Linux, tmpfs).
+ * Writes stay in flight across files: open() of the next file only submits the tail of the previous one, which
+ * is trimmed and closed when its writes complete. Waits happen when a buffer is reused and in close().
+*/
+class FrameWriter : public std::streambuf
+{
+  public:
+    enum class backend
+    {
+        buffered,
+        direct,
+        uring
+    };
+
+    explicit FrameWriter(std::size_t bufferSize = 1 << 20, std::size_t bufferCount = 4);
+    FrameWriter(const FrameWriter&)            = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+    ~FrameWriter();
+
+    STATUS_t open(const char* fileName, bool direct = true);
+    STATUS_t write(const void* data, std::size_t size);
+    STATUS_t close();
+    backend getBackend() const;
+    std::uint64_t getBytesWritten() const;
+
+  protected:
+    int_type overflow(int_type ch) override;
+
+  private:
+    struct pendingFile_t {
+        int fd;
+        std::uint64_t size;   // file is trimmed to it once its writes complete
+    };
+
+    std::size_t m_bufferSize;
+    std::vector<std::uint8_t*> m_buffers;
+    std::vector<std::size_t> m_inFlight;   // bytes submitted from each buffer and not completed yet
+    std::vector<int> m_inFlightFd;   // file each buffer is written to
+    std::vector<pendingFile_t> m_finished;   // files with all data submitted and writes in flight
+    std::size_t m_current   = 0;   // buffer being filled
+    std::uint64_t m_offset  = 0;   // file offset of current buffer
+    std::uint64_t m_written = 0;   // size of the last finished file
+    backend m_backend       = backend::buffered;
+    FILE* m_pFile           = nullptr;   // buffered backend
+    int m_fd                = -1;   // direct backends
+    STATUS_t m_status       = BASE_SUCCESS;   // first error of asynchronous writes
+#ifdef OMLS_IO_URING
+    struct io_uring m_ring;
+    bool m_ringReady = false;
+#endif
+
+    void resetPutArea();
+    STATUS_t finishFile();
+    STATUS_t submit(std::size_t bytes);
+    STATUS_t waitFor(std::size_t buffer);
+    void closeFinished();
+    static STATUS_t trimAndClose(int fd, std::uint64_t size);
+};
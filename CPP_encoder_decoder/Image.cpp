@@ -1,6 +1,8 @@
 #include "Image.hpp"
+#include "globalDefines.hpp"
 #include <iostream>
 #include <span>
+#include <stdexcept>
 
 Image::Image(std::vector<std::uint16_t>&& data, std::size_t w, std::size_t h)
    : m_width(w)
@@ -42,6 +44,29 @@ std::span<std::uint16_t const> Image::getDataView() const
     return {m_data.data(), m_data.size()};
 }
 
+/**
+ * View of the whole image.
+*/
+BayerView Image::getView() const
+{
+    return {m_data.data(), m_width, 0, 0, m_width, m_height};
+}
+
+/**
+ * Sub-window at @param x, @param y (relative to this view) of @param w x @param h. No data is copied.
+ * Throws if the window does not fit, breaks the 2x2 Bayer pattern or has a size the decoder rejects.
+*/
+BayerView BayerView::window(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const
+{
+    if(x + w > width || y + h > height || (x | y) & 1) {
+        throw std::runtime_error("BayerView::window(): Window must be even aligned and lie inside the view.");
+    }
+    if(w % OMLS_SIZE_MULTIPLE || h % OMLS_SIZE_MULTIPLE) {
+        throw std::runtime_error("BayerView::window(): Window width and height must be multiples of 16.");
+    }
+    return {data, pitch, offsetX + x, offsetY + y, w, h};
+}
+
 /**
  * Make unique pointer to imageYCCC object.
 */
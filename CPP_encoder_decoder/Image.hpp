@@ -6,6 +6,26 @@
 #include <span>
 #include <vector>
 
+/**
+ * Non-owning view of a BayerCFA window inside a larger frame (e.g. a DMA buffer). Samples of window row y start at
+ * data + (offsetY + y) * pitch + offsetX; @param pitch is in samples. Offsets are recorded in the ROI header.
+*/
+struct BayerView {
+    const std::uint16_t* data = nullptr;
+    std::size_t pitch         = 0;
+    std::size_t offsetX       = 0;
+    std::size_t offsetY       = 0;
+    std::size_t width         = 0;
+    std::size_t height        = 0;
+
+    const std::uint16_t* row(std::size_t y) const
+    {
+        return data + (offsetY + y) * pitch + offsetX;
+    }
+
+    BayerView window(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const;
+};
+
 class Image
 {
   private:
@@ -27,6 +47,7 @@ class Image
 
     std::span<std::uint16_t> getData();
     std::span<std::uint16_t const> getDataView() const;
+    BayerView getView() const;
 };
 
 using pImage = std::unique_ptr<Image>;
@@ -19,8 +19,8 @@ ImageYCCC::ImageYCCC(std::size_t w, std::size_t h)
    : m_width(w)
    , m_height(h)
    , m_length(w * h)
-   , m_full(m_length)
-   , m_dpcm(m_length)
+   , m_full(w, h)
+   , m_dpcm(w, h)
 {
 }
 
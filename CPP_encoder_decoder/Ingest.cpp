@@ -0,0 +1,199 @@
+#include "Ingest.hpp"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#ifdef OMLS_STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "stb_image.h"
+#endif
+
+
+/**
+ * Bits needed for samples up to @param maxValue.
+*/
+static std::uint8_t bitsOf(std::uint32_t maxValue)
+{
+    std::uint8_t bits = 0;
+    while(bits < 32 && (std::uint64_t)1 << bits <= maxValue) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * Encoded bit depth of samples with @param sourceBits bits: nearest supported depth (8 to 16, even) not below it.
+*/
+static std::uint8_t defaultBpp(int sourceBits)
+{
+    return sourceBits <= 8 ? 8 : (sourceBits + 1) & ~1;
+}
+
+/**
+ * Writes row @param y of the GB mosaic to @param pOut from a row of @param channels interleaved channels,
+ * @param sample(i) returns i-th sample of the row. Samples are scaled from @param sourceBits to @param bpp bits.
+*/
+template<typename F>
+static void mosaicRow(
+   F sample,
+   std::size_t channels,
+   std::size_t y,
+   std::size_t width,
+   int sourceBits,
+   int bpp,
+   std::uint16_t* pOut)
+{
+    const std::size_t even = channels < 3 ? 0 : (y % 2 ? 0 : 1);   // even rows G B, odd rows R G, grey as is
+    const std::size_t odd  = channels < 3 ? 0 : (y % 2 ? 1 : 2);
+    const int up           = bpp > sourceBits ? bpp - sourceBits : 0;
+    const int down         = bpp < sourceBits ? sourceBits - bpp : 0;
+    for(std::size_t x = 0; x < width; x += 2) {
+        pOut[x]     = (std::uint16_t)((std::uint32_t)sample(x * channels + even) << up >> down);
+        pOut[x + 1] = (std::uint16_t)((std::uint32_t)sample((x + 1) * channels + odd) << up >> down);
+    }
+}
+
+/**
+ * Reads decimal header value of PPM or PGM, skipping whitespace and comments. Consumes the single whitespace byte
+ * ending it, which after maxval is the last byte of the header.
+*/
+static bool readNetpbmValue(FILE* pFile, unsigned long& value)
+{
+    int c = fgetc(pFile);
+    while(c == '#' || std::isspace(c)) {
+        if(c == '#') {
+            while(c != '\n' && c != EOF) {
+                c = fgetc(pFile);
+            }
+        }
+        c = fgetc(pFile);
+    }
+    if(!std::isdigit(c)) {
+        return false;
+    }
+    for(value = 0; std::isdigit(c); c = fgetc(pFile)) {
+        value = value * 10 + (c - '0');
+        if(value > 0xFFFFFF) {
+            return false;
+        }
+    }
+    return std::isspace(c);
+}
+
+/**
+ * Reads image @param fileName as BayerCFA GB with @param bpp bits per sample, 0 picks one from the file's depth.
+*/
+STATUS_t IngestImage::read(const char* fileName, std::uint8_t bpp)
+{
+    const char* extension = strrchr(fileName, '.');
+    if(extension && (strcmp(extension, ".png") == 0 || strcmp(extension, ".PNG") == 0)) {
+#ifdef OMLS_STB_IMAGE
+        return readPng(fileName, bpp);
+#else
+        return BASE_IMAGE_INVALID;
+#endif
+    }
+    return readNetpbm(fileName, bpp);
+}
+
+STATUS_t IngestImage::readNetpbm(const char* fileName, std::uint8_t bpp)
+{
+    FILE* pFile = fopen(fileName, "rb");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    char magic[2];
+    unsigned long width, height, maxValue;
+    if(fread(magic, 1, 2, pFile) != 2 || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6')
+       || !readNetpbmValue(pFile, width) || !readNetpbmValue(pFile, height) || !readNetpbmValue(pFile, maxValue)
+       || width < OMLS_SIZE_MULTIPLE || height < OMLS_SIZE_MULTIPLE || maxValue == 0 || maxValue > 0xFFFF) {
+        fclose(pFile);
+        return BASE_IMAGE_INVALID;
+    }
+    const std::size_t channels    = magic[1] == '6' ? 3 : 1;
+    const std::size_t sampleBytes = maxValue > 0xFF ? 2 : 1;
+    const int sourceBits          = bitsOf(maxValue);
+    m_width                       = width / OMLS_SIZE_MULTIPLE * OMLS_SIZE_MULTIPLE;
+    m_height                      = height / OMLS_SIZE_MULTIPLE * OMLS_SIZE_MULTIPLE;
+    m_bpp                         = bpp ? bpp : defaultBpp(sourceBits);
+    m_samples.resize(m_width * m_height);
+    m_row.resize(width * channels * sampleBytes);
+
+    const std::uint8_t* pRow = m_row.data();
+    for(std::size_t y = 0; y < m_height; y++) {
+        if(fread(m_row.data(), 1, m_row.size(), pFile) != m_row.size()) {
+            fclose(pFile);
+            return BASE_IMAGE_INVALID;
+        }
+        std::uint16_t* pOut = &m_samples[y * m_width];
+        if(sampleBytes == 1) {
+            mosaicRow([pRow](std::size_t i) { return pRow[i]; }, channels, y, m_width, sourceBits, m_bpp, pOut);
+        } else {   // big-endian
+            mosaicRow(
+               [pRow](std::size_t i) { return pRow[2 * i] << 8 | pRow[2 * i + 1]; },
+               channels,
+               y,
+               m_width,
+               sourceBits,
+               m_bpp,
+               pOut);
+        }
+    }
+    fclose(pFile);
+    return BASE_SUCCESS;
+}
+
+#ifdef OMLS_STB_IMAGE
+STATUS_t IngestImage::readPng(const char* fileName, std::uint8_t bpp)
+{
+    FILE* pFile = fopen(fileName, "rb");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    int width, height, channels;
+    const bool is16bit = stbi_is_16_bit_from_file(pFile);
+    void* pPixels      = is16bit ? (void*)stbi_load_from_file_16(pFile, &width, &height, &channels, 0)
+                                 : (void*)stbi_load_from_file(pFile, &width, &height, &channels, 0);
+    fclose(pFile);
+    if(!pPixels || width < OMLS_SIZE_MULTIPLE || height < OMLS_SIZE_MULTIPLE) {
+        stbi_image_free(pPixels);
+        return BASE_IMAGE_INVALID;
+    }
+    const int sourceBits = is16bit ? 16 : 8;
+    m_width              = width / OMLS_SIZE_MULTIPLE * OMLS_SIZE_MULTIPLE;
+    m_height             = height / OMLS_SIZE_MULTIPLE * OMLS_SIZE_MULTIPLE;
+    m_bpp                = bpp ? bpp : defaultBpp(sourceBits);
+    m_samples.resize(m_width * m_height);
+
+    for(std::size_t y = 0; y < m_height; y++) {
+        std::uint16_t* pOut = &m_samples[y * m_width];
+        if(is16bit) {
+            const std::uint16_t* pRow = (const std::uint16_t*)pPixels + y * width * channels;
+            mosaicRow([pRow](std::size_t i) { return pRow[i]; }, channels, y, m_width, sourceBits, m_bpp, pOut);
+        } else {
+            const std::uint8_t* pRow = (const std::uint8_t*)pPixels + y * width * channels;
+            mosaicRow([pRow](std::size_t i) { return pRow[i]; }, channels, y, m_width, sourceBits, m_bpp, pOut);
+        }
+    }
+    stbi_image_free(pPixels);
+    return BASE_SUCCESS;
+}
+#endif
+
+/**
+ * BayerCFA samples of the last image read, valid until the next read().
+*/
+BayerView IngestImage::getView() const
+{
+    BayerView view;
+    view.data   = m_samples.data();
+    view.pitch  = m_width;
+    view.width  = m_width;
+    view.height = m_height;
+    return view;
+}
+
+std::uint8_t IngestImage::getBpp() const
+{
+    return m_bpp;
+}
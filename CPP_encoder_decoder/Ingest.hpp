@@ -0,0 +1,33 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include "Image.hpp"
+#include <cstdint>
+#include <vector>
+
+/*
+* Reads image files straight into BayerCFA GB, the mosaic png2bayerCFA_GB.py builds: even rows G B, odd rows R G.
+* Grey images are taken as BayerCFA already. Rows are mosaicked while they are read, the colour image is never
+* held in memory. Width and height are cropped to multiples of 16, as png2bayerCFA_GB.py does.
+* Binary PPM (P6) and PGM (P5), 8 or 16-bit. PNG when built with OMLS_STB_IMAGE (stb_image.h on include path).
+*/
+class IngestImage
+{
+  private:
+    std::vector<std::uint16_t> m_samples;
+    std::vector<std::uint8_t> m_row;   // one row of file data
+    std::size_t m_width  = 0;
+    std::size_t m_height = 0;
+    std::uint8_t m_bpp   = 0;
+
+    STATUS_t readNetpbm(const char* fileName, std::uint8_t bpp);
+#ifdef OMLS_STB_IMAGE
+    STATUS_t readPng(const char* fileName, std::uint8_t bpp);
+#endif
+
+  public:
+    STATUS_t read(const char* fileName, std::uint8_t bpp = 0);
+
+    BayerView getView() const;
+    std::uint8_t getBpp() const;
+};
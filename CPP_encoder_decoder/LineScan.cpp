@@ -0,0 +1,214 @@
+#include "LineScan.hpp"
+#include "Encoder.hpp"
+#include <cstring>
+
+
+static std::size_t roundUp(std::size_t value)
+{
+    return (value + OMLS_SIZE_MULTIPLE - 1) / OMLS_SIZE_MULTIPLE * OMLS_SIZE_MULTIPLE;
+}
+
+/**
+ * Index repeated at padded index @param i of @param count valid ones: the last valid one with the same CFA phase.
+*/
+static std::size_t padSource(std::size_t i, std::size_t count)
+{
+    if(i < count) {
+        return i;
+    }
+    const std::size_t back = (i - count + 1) & 1;
+    return count > back ? count - 1 - back : 0;
+}
+
+/**
+ *
+ * Line-scan encoder
+*/
+LineScanEncoder::LineScanEncoder(
+   std::size_t width,
+   std::uint8_t bpp,
+   std::size_t lossyBits,
+   std::size_t unaryMaxWidth,
+   const char* folderOut)
+   : m_width(width)
+   , m_bpp(bpp)
+   , m_lossyBits(lossyBits)
+   , m_unaryMaxWidth(unaryMaxWidth)
+   , m_folderOut(folderOut)
+{
+}
+
+void LineScanEncoder::setBitOrderLSBFirst(bool lsbFirst)
+{
+    m_lsbFirst = lsbFirst;
+}
+
+void LineScanEncoder::setCfaPattern(cfaPattern pattern)
+{
+    m_cfaPattern = pattern;
+}
+
+/**
+ * Writes next segment of @param count rows (@param pitch samples apart) to @param pOut, @param bytesWritten
+ * returns its size. Rows are read in place unless they need padding. Encoder errors are thrown as by Encoder.
+*/
+STATUS_t LineScanEncoder::encode(
+   const std::uint16_t* rows,
+   std::size_t pitch,
+   std::size_t count,
+   std::uint64_t timestamp,
+   FILE* pOut,
+   std::size_t& bytesWritten)
+{
+    if(count == 0) {
+        return BASE_ERROR;
+    }
+    const std::size_t width  = roundUp(m_width);
+    const std::size_t height = roundUp(count);
+    BayerView view;
+    if(width == m_width && height == count) {
+        view.data  = rows;
+        view.pitch = pitch;
+    } else {
+        m_padded.resize(width * height);
+        for(std::size_t y = 0; y < height; y++) {
+            const std::uint16_t* pSrc = rows + padSource(y, count) * pitch;
+            std::uint16_t* pDst       = &m_padded[y * width];
+            memcpy(pDst, pSrc, m_width * sizeof(std::uint16_t));
+            for(std::size_t x = m_width; x < width; x++) {
+                pDst[x] = pSrc[padSource(x, m_width)];
+            }
+        }
+        view.data  = m_padded.data();
+        view.pitch = width;
+    }
+    view.width  = width;
+    view.height = height;
+
+    m_frame.str("");
+    Encoder enc{view, m_folderOut, m_index % 100, 32, 8, m_lossyBits, m_unaryMaxWidth, m_bpp, 24, "line_"};
+    enc.setOutputStream(&m_frame);
+    enc.setBitOrderLSBFirst(m_lsbFirst);
+    enc.setCfaPattern(m_cfaPattern);
+    enc.setHeaderVersion(2);   // 32-bit width
+    enc.setTimestamp(timestamp / 1000);
+    enc.setDumpVerification(false);
+    enc.encodeUsingMethod(
+       m_unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                  : Encoder::method::parallel_limited);
+
+    auto data = m_frame.view();
+    lineSegment_t segment;
+    memcpy(segment.magic, OMLS_LINE_MAGIC, OMLS_LINE_MAGIC_SIZE);
+    segment.index     = m_index;
+    segment.firstRow  = m_nextRow;
+    segment.timestamp = timestamp;
+    segment.size      = data.size();
+    segment.width     = (std::uint32_t)m_width;
+    segment.rows      = (std::uint32_t)count;
+    if(fwrite(&segment, sizeof(segment), 1, pOut) != 1 || fwrite(data.data(), 1, data.size(), pOut) != data.size()) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    bytesWritten = sizeof(segment) + data.size();
+    m_index++;
+    m_nextRow += count;
+    return BASE_SUCCESS;
+}
+
+std::uint64_t LineScanEncoder::getSegmentCount() const
+{
+    return m_index;
+}
+
+std::uint64_t LineScanEncoder::getRowCount() const
+{
+    return m_nextRow;
+}
+
+/**
+ *
+ * Line-scan decoder
+*/
+
+/**
+ * Skips bytes of @param pIn up to the next segment magic, for streams joined in the middle. Following read()
+ * continues after the magic. Returns BASE_ERROR_ALL_BYTES_ALREADY_READ if the stream ends first.
+*/
+STATUS_t LineScanDecoder::sync(FILE* pIn)
+{
+    std::size_t matched = 0;
+    while(matched < OMLS_LINE_MAGIC_SIZE) {
+        int c = fgetc(pIn);
+        if(c == EOF) {
+            return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+        }
+        if((char)c == OMLS_LINE_MAGIC[matched]) {
+            matched++;
+        } else {
+            matched = (char)c == OMLS_LINE_MAGIC[0] ? 1 : 0;   // first magic byte occurs only once in it
+        }
+    }
+    m_synced = true;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Reads next segment of @param pIn. Returns BASE_ERROR_ALL_BYTES_ALREADY_READ at the end of the stream.
+*/
+STATUS_t LineScanDecoder::read(FILE* pIn)
+{
+    const std::size_t offset = m_synced ? OMLS_LINE_MAGIC_SIZE : 0;
+    std::uint8_t* pSegment   = reinterpret_cast<std::uint8_t*>(&m_segment);
+    m_synced                 = false;
+    if(offset) {
+        memcpy(pSegment, OMLS_LINE_MAGIC, OMLS_LINE_MAGIC_SIZE);
+    }
+    std::size_t bytes = fread(pSegment + offset, 1, sizeof(m_segment) - offset, pIn);
+    if(bytes == 0 && !offset && feof(pIn)) {
+        return BASE_ERROR_ALL_BYTES_ALREADY_READ;
+    }
+    if(bytes != sizeof(m_segment) - offset || memcmp(m_segment.magic, OMLS_LINE_MAGIC, OMLS_LINE_MAGIC_SIZE) != 0
+       || m_segment.width == 0 || m_segment.width % 2 || m_segment.rows == 0 || m_segment.size == 0
+       || m_segment.size > OMLS_LINE_MAX_SEGMENT_BYTES) {
+        return BASE_LINE_SEGMENT_INVALID;
+    }
+    if(m_input.size() < m_segment.size) {
+        m_input.resize(m_segment.size);
+    }
+    if(fread(m_input.data(), 1, m_segment.size, pIn) != m_segment.size) {
+        return BASE_LINE_SEGMENT_INVALID;
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Decodes segment read last to getRows(): getSegment().rows rows of getSegment().width 16-bit samples.
+ * Padding rows are not reconstructed.
+*/
+STATUS_t LineScanDecoder::decode()
+{
+    RETURN_ON_FAILURE(m_session.load(m_input.data(), m_segment.size))
+    const headerData_t& header = m_session.getHeader();
+    const std::size_t rows     = (m_segment.rows + 1) & ~(std::size_t)1;   // crop is quad aligned
+    if(header.width != roundUp(m_segment.width) || header.height < rows) {
+        return BASE_LINE_SEGMENT_INVALID;
+    }
+    if(m_samples.size() < (std::size_t)m_segment.width * rows) {
+        m_samples.resize((std::size_t)m_segment.width * rows);
+    }
+    outputDescriptor_t out{
+       m_samples.data(), m_segment.width * sizeof(std::uint16_t), outputDescriptor_t::pixelFormat::u16};
+    out.cropWidth  = m_segment.width;
+    out.cropHeight = rows;
+    return m_session.decodeInto(out);
+}
+
+const lineSegment_t& LineScanDecoder::getSegment() const
+{
+    return m_segment;
+}
+
+const std::uint16_t* LineScanDecoder::getRows() const
+{
+    return m_samples.data();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Cfa.hpp"
+#include "DecoderSession.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+/*
+* Line-scan stream: one strip of fixed width and open-ended height, cut into segments of a fixed number of rows.
+* All fields little-endian. Each segment is
+*   lineSegment_t, followed by
+*   size bytes of a complete compressed stream (header v2 and bitstream) holding the segment's rows.
+*
+* Width and height of the compressed stream are the segment's padded to multiples of 16, padding repeats the
+* last columns and rows with their CFA phase and is dropped when decoding. Segments depend on nothing before
+* them, so decoding can start at any segment boundary; a reader joining a stream in the middle finds the next
+* boundary by the magic (LineScanDecoder::sync()).
+*/
+
+#define OMLS_LINE_MAGIC "\x89OMLSLIN"
+#define OMLS_LINE_MAGIC_SIZE 8
+#define OMLS_LINE_SEGMENT_ROWS 256 /* Default rows per segment */
+#define OMLS_LINE_MAX_SEGMENT_BYTES ((std::uint64_t)1 << 31) /* Larger segments are taken as a corrupt stream */
+
+struct lineSegment_t {
+    std::uint8_t magic[OMLS_LINE_MAGIC_SIZE];
+    std::uint64_t index;   // segment number, 0 is the first segment of the strip
+    std::uint64_t firstRow;   // strip row of the segment's first row
+    std::uint64_t timestamp;   // us, when the segment's rows were complete
+    std::uint64_t size;   // bytes of the compressed stream following
+    std::uint32_t width;   // strip width in samples
+    std::uint32_t rows;   // rows in the segment, compressed stream may be padded beyond them
+};
+static_assert(sizeof(lineSegment_t) == 48, "lineSegment_t must match the stream layout");
+
+/*
+* Cuts a strip into segments as its rows arrive. Only one segment is kept, memory does not grow with the strip.
+*/
+class LineScanEncoder
+{
+  private:
+    std::size_t m_width;
+    std::uint8_t m_bpp;
+    std::size_t m_lossyBits;
+    std::size_t m_unaryMaxWidth;
+    const char* m_folderOut;
+    bool m_lsbFirst         = false;
+    cfaPattern m_cfaPattern = cfaPattern::gbrg;
+    std::uint64_t m_index   = 0;
+    std::uint64_t m_nextRow = 0;
+    std::vector<std::uint16_t> m_padded;
+    std::ostringstream m_frame;
+
+  public:
+    LineScanEncoder(
+       std::size_t width,
+       std::uint8_t bpp,
+       std::size_t lossyBits,
+       std::size_t unaryMaxWidth,
+       const char* folderOut);
+
+    void setBitOrderLSBFirst(bool lsbFirst);
+    void setCfaPattern(cfaPattern pattern);
+    STATUS_t encode(
+       const std::uint16_t* rows,
+       std::size_t pitch,
+       std::size_t count,
+       std::uint64_t timestamp,
+       FILE* pOut,
+       std::size_t& bytesWritten);
+    std::uint64_t getSegmentCount() const;
+    std::uint64_t getRowCount() const;
+};
+
+/*
+* Reads segments of a line-scan stream one at a time and decodes them. Buffers are reused, so memory is bounded
+* by the largest segment.
+*/
+class LineScanDecoder
+{
+  private:
+    DecoderSession m_session;
+    lineSegment_t m_segment{};
+    bool m_synced = false;   // magic of next segment already consumed by sync()
+    std::vector<std::uint8_t> m_input;
+    std::vector<std::uint16_t> m_samples;
+
+  public:
+    STATUS_t sync(FILE* pIn);
+    STATUS_t read(FILE* pIn);
+    STATUS_t decode();
+    const lineSegment_t& getSegment() const;
+    const std::uint16_t* getRows() const;
+};
@@ -0,0 +1,231 @@
+#include "Manifest.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#define MANIFEST_HASH_BLOCK (1 << 16) /* Bytes read at once while hashing */
+#define MANIFEST_LINE_MAX 4096 /* Longer lines are skipped, their frames are encoded again */
+
+/**
+ * Field @param text as stored: '%', ',' and line ends are written as %XX, so fields never contain the separator.
+*/
+static std::string escapeField(const std::string& text)
+{
+    std::string escaped;
+    for(char c : text) {
+        if(c == '%' || c == ',' || c == '\n' || c == '\r') {
+            char code[4];
+            snprintf(code, sizeof(code), "%%%02X", (unsigned char)c);
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Inverse of escapeField() for @param length characters at @param text.
+*/
+static std::string unescapeField(const char* text, std::size_t length)
+{
+    std::string field;
+    for(std::size_t i = 0; i < length; i++) {
+        if(text[i] == '%' && i + 2 < length && isxdigit((unsigned char)text[i + 1])
+           && isxdigit((unsigned char)text[i + 2])) {
+            const char code[3] = {text[i + 1], text[i + 2], '\0'};
+            field += (char)strtoul(code, nullptr, 16);
+            i += 2;
+        } else {
+            field += text[i];
+        }
+    }
+    return field;
+}
+
+Manifest::Manifest() {}
+
+Manifest::~Manifest()
+{
+    close();
+}
+
+/**
+ * Loads manifest @param fileName, if it exists, and opens it for appending.
+*/
+STATUS_t Manifest::open(const char* fileName)
+{
+    close();
+    m_entries.clear();
+
+    if(FILE* pFile = fopen(fileName, "r")) {
+        std::vector<char> line(MANIFEST_LINE_MAX);
+        while(fgets(line.data(), line.size(), pFile)) {
+            manifestEntry_t entry;
+            unsigned long long size, hash;
+            long long mtime;
+            int consumed = 0;
+            if(sscanf(line.data(), "%llu,%lld,%llx,%n", &size, &mtime, &hash, &consumed) != 3 || !consumed) {
+                continue;   // malformed
+            }
+            const char* pParams = line.data() + consumed;
+            const char* pComma  = strchr(pParams, ',');
+            if(!pComma) {
+                continue;
+            }
+            const char* pInput = pComma + 1;
+            std::size_t length = strcspn(pInput, "\r\n");
+            if(pInput[length] == '\0') {
+                continue;   // no line end, line was not completely written or is too long
+            }
+            entry.input  = unescapeField(pInput, length);
+            entry.size   = size;
+            entry.mtime  = mtime;
+            entry.hash   = hash;
+            entry.params = unescapeField(pParams, pComma - pParams);
+
+            m_entries[entry.input] = entry;
+        }
+        fclose(pFile);
+    }
+
+    m_pFile = fopen(fileName, "a");
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    return BASE_SUCCESS;
+}
+
+void Manifest::close()
+{
+    if(m_pFile) {
+        fclose(m_pFile);
+        m_pFile = nullptr;
+    }
+}
+
+std::size_t Manifest::getEntryCount() const
+{
+    return m_entries.size();
+}
+
+/**
+ * True if output of @param current input was made from the same contents with the same parameters.
+ * Contents are compared by hash when both sides have one (copied files keep being up to date),
+ * otherwise by modification time.
+*/
+bool Manifest::isUpToDate(const manifestEntry_t& current) const
+{
+    auto it = m_entries.find(current.input);
+    if(it == m_entries.end()) {
+        return false;
+    }
+    const manifestEntry_t& done = it->second;
+    if(done.size != current.size || done.params != current.params) {
+        return false;
+    }
+    if(done.hash && current.hash) {
+        return done.hash == current.hash;
+    }
+    return done.mtime == current.mtime;
+}
+
+/**
+ * Appends @param entry and flushes it, call once the output of the frame is complete.
+*/
+STATUS_t Manifest::record(const manifestEntry_t& entry)
+{
+    if(!m_pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    fprintf(m_pFile,
+            "%llu,%lld,%llx,%s,%s\n",
+            (unsigned long long)entry.size,
+            (long long)entry.mtime,
+            (unsigned long long)entry.hash,
+            escapeField(entry.params).c_str(),
+            escapeField(entry.input).c_str());
+    if(fflush(m_pFile)) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    m_entries[entry.input] = entry;
+    return BASE_SUCCESS;
+}
+
+/**
+ * Describes all @param inputs with codec @param params on @param threads threads (0 = hardware concurrency).
+ * Fills @param current and sets @param upToDate for inputs that need no work. Missing inputs are not up to date.
+*/
+void Manifest::scan(
+   const std::vector<std::string>& inputs,
+   const std::string& params,
+   bool hash,
+   std::vector<manifestEntry_t>& current,
+   std::vector<std::uint8_t>& upToDate,
+   std::size_t threads) const
+{
+    current.assign(inputs.size(), manifestEntry_t{});
+    upToDate.assign(inputs.size(), 0);
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, inputs.size());
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for(std::size_t i = next++; i < inputs.size(); i = next++) {
+            current[i].params = params;
+            if(describe(inputs[i], hash, current[i]) == BASE_SUCCESS) {
+                upToDate[i] = isUpToDate(current[i]);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for(std::size_t t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for(auto& thread : pool) {
+        thread.join();
+    }
+}
+
+/**
+ * Fills size, modification time and, if @param hash, FNV-1a hash of file @param input into @param entry.
+*/
+STATUS_t Manifest::describe(const std::string& input, bool hash, manifestEntry_t& entry)
+{
+    entry.input = input;
+    std::error_code error;
+    entry.size = std::filesystem::file_size(input, error);
+    if(error) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    entry.mtime = std::filesystem::last_write_time(input, error).time_since_epoch().count();
+    if(error) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    entry.hash = 0;
+    if(!hash) {
+        return BASE_SUCCESS;
+    }
+
+    FILE* pFile = fopen(input.c_str(), "rb");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    std::vector<std::uint8_t> block(MANIFEST_HASH_BLOCK);
+    std::uint64_t fnv = 14695981039346656037ULL;
+    std::size_t bytes;
+    while((bytes = fread(block.data(), 1, block.size(), pFile)) > 0) {
+        for(std::size_t i = 0; i < bytes; i++) {
+            fnv = (fnv ^ block[i]) * 1099511628211ULL;
+        }
+    }
+    fclose(pFile);
+    entry.hash = fnv ? fnv : 1;   // 0 means not hashed
+    return BASE_SUCCESS;
+}
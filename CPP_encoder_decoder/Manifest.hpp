@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+* State of one input frame when its output was produced.
+*/
+struct manifestEntry_t {
+    std::string input;
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;   // filesystem clock ticks
+    std::uint64_t hash = 0;   // FNV-1a of the contents, 0 when not hashed
+    std::string params;   // codec parameters of the output
+};
+
+/*
+* Manifest of a batch: for each input, size, modification time, optional hash and codec parameters its output was
+* made with. Stored as CSV "size,mtime,hash,params,input", one line appended and flushed per finished frame,
+* so an interrupted batch resumes where it stopped. Later lines override earlier ones for the same input.
+* Commas, '%' and line ends in params and input are stored as %XX.
+*/
+class Manifest
+{
+  private:
+    std::unordered_map<std::string, manifestEntry_t> m_entries;
+    FILE* m_pFile = nullptr;
+
+  public:
+    Manifest();
+    Manifest(const Manifest&)            = delete;
+    Manifest& operator=(const Manifest&) = delete;
+    ~Manifest();
+
+    STATUS_t open(const char* fileName);
+    void close();
+    std::size_t getEntryCount() const;
+
+    bool isUpToDate(const manifestEntry_t& current) const;
+    STATUS_t record(const manifestEntry_t& entry);
+    void scan(
+       const std::vector<std::string>& inputs,
+       const std::string& params,
+       bool hash,
+       std::vector<manifestEntry_t>& current,
+       std::vector<std::uint8_t>& upToDate,
+       std::size_t threads = 0) const;
+
+    static STATUS_t describe(const std::string& input, bool hash, manifestEntry_t& entry);
+};
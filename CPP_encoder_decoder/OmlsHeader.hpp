@@ -0,0 +1,96 @@
+#pragma once
+
+#include "globalDefines.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+* Compressed stream header.
+*
+* Version 1 (legacy, 24 bytes): timestamp (u64), roi (u64), compression info (u64) packed as
+* width (u16), height (u16), unaryMaxWidth (u8), bpp (u8), lossyBits (u8), reserved/flags (u8).
+* It has no magic number and is recognized by the absence of OMLS_HEADER_MAGIC.
+*
+* Version 2 (self-describing). All fields little-endian.
+* address : content
+*       0 : magic "\x89OMLS\r\n\x1A"
+*       8 : version (u16)
+*      10 : header length in bytes including extensions, multiple of 8 (u16). Bitstream starts here.
+*      12 : flags (u32), OMLS_FLAG_*
+*      16 : timestamp (u64)
+*      24 : roi (u64)
+*      32 : width (u32)
+*      36 : height (u32)
+*      40 : unaryMaxWidth (u16)
+*      42 : bpp (u8)
+*      43 : lossyBits (u8)
+*      44 : reserved (u32)
+*      48 : optional TLV extensions: type (u16), length (u16), payload padded to a multiple of 8 bytes
+*
+* Magic ends with a non-zero byte, so a legacy millisecond timestamp can never be mistaken for it.
+* Flags that change how the bitstream is read are mandatory: decoders reject streams with unknown flags.
+* Extensions carry optional data: decoders skip unknown types.
+*/
+
+#define OMLS_HEADER_MAGIC "\x89OMLS\r\n\x1A"
+#define OMLS_HEADER_MAGIC_SIZE 8
+#define OMLS_HEADER_VERSION 2 /* Version written by the encoder */
+#define OMLS_HEADER_V1_SIZE 24
+#define OMLS_HEADER_V2_SIZE 48
+#define OMLS_HEADER_EXT_SIZE 4 /* Size of extension type and length, payload follows */
+
+/* Extension types */
+#define OMLS_EXT_CHANNEL_OFFSETS 1 /* 4 x u64 byte offset of Y, Cd, Cm, Co bitstream, relative to header end */
+
+/*
+* Fixed part of version 2 header, as laid out in the stream.
+*/
+struct OmlsHeaderV2_t {
+    std::uint8_t magic[OMLS_HEADER_MAGIC_SIZE];
+    std::uint16_t version;
+    std::uint16_t headerLength;
+    std::uint32_t flags;
+    std::uint64_t timestamp;
+    std::uint64_t roi;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint16_t unaryMaxWidth;
+    std::uint8_t bpp;
+    std::uint8_t lossyBits;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(OmlsHeaderV2_t) == OMLS_HEADER_V2_SIZE, "OmlsHeaderV2_t must match the stream layout");
+
+/*
+* Header fields of either version, as used by the decoder.
+*/
+struct headerData_t {
+    std::uint64_t timestamp;
+    std::uint64_t roi;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint16_t unaryMaxWidth;
+    std::uint8_t bpp;
+    std::uint8_t lossyBits;
+    std::uint8_t reserved;   // legacy compression info byte 7
+    std::uint16_t version;
+    std::uint16_t headerSize;   // bitstream offset from the start of the file
+    std::uint32_t flags;   // OMLS_FLAG_*
+};
+
+/*
+* Appends extension to @param extensions, padded to a multiple of 8 bytes.
+*/
+inline void appendOmlsHeaderExtension(
+   std::vector<std::uint8_t>& extensions,
+   std::uint16_t type,
+   const void* payload,
+   std::uint16_t length)
+{
+    std::size_t offset = extensions.size();
+    extensions.resize(offset + ((OMLS_HEADER_EXT_SIZE + length + 7) & ~(std::size_t)7), 0);
+    memcpy(&extensions[offset], &type, sizeof(type));
+    memcpy(&extensions[offset + 2], &length, sizeof(length));
+    memcpy(&extensions[offset + OMLS_HEADER_EXT_SIZE], payload, length);
+}
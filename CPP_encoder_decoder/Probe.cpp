@@ -0,0 +1,280 @@
+#include "Probe.hpp"
+#include "Archive.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define PROBE_CHUNK 256 /* Sources taken by a worker at once */
+
+static int openRead(const char* path)
+{
+#ifdef _WIN32
+    return _open(path, _O_RDONLY | _O_BINARY);
+#else
+    return open(path, O_RDONLY);
+#endif
+}
+
+static void closeFile(int fd)
+{
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+/**
+ * Positioned read, does not depend on file position on POSIX. Windows has no pread, there each worker seeks
+ * its own descriptor.
+*/
+static long long readAt(int fd, void* buffer, std::size_t size, std::uint64_t offset)
+{
+#ifdef _WIN32
+    if(_lseeki64(fd, (long long)offset, SEEK_SET) < 0) {
+        return -1;
+    }
+    return _read(fd, buffer, (unsigned)size);
+#else
+    return pread(fd, buffer, size, (off_t)offset);
+#endif
+}
+
+static std::uint64_t fileSize(int fd)
+{
+#ifdef _WIN32
+    return _lseeki64(fd, 0, SEEK_END);
+#else
+    return lseek(fd, 0, SEEK_END);
+#endif
+}
+
+/**
+ * Adds all *.bin files of @param folder, frame id is the number at the end of the file name.
+*/
+STATUS_t Probe::addDirectory(const char* folder)
+{
+    std::error_code error;
+    std::vector<std::filesystem::path> paths;
+    for(const auto& entry : std::filesystem::directory_iterator(folder, error)) {
+        if(entry.is_regular_file(error) && entry.path().extension() == ".bin") {
+            paths.push_back(entry.path());
+        }
+    }
+    if(error) {
+        return BASE_CANNOT_OPEN_INPUT_FILE;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for(const auto& path : paths) {
+        std::string stem   = path.stem().string();
+        std::size_t digits = stem.size();
+        while(digits > 0 && stem[digits - 1] >= '0' && stem[digits - 1] <= '9') {
+            digits--;
+        }
+        std::uint64_t frameId = digits < stem.size() ? std::stoull(stem.substr(digits)) : m_sources.size();
+        m_sources.push_back({(std::uint32_t)m_files.size(), 0, 0, frameId});
+        m_files.push_back(path.string());
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Adds all frames of archive @param fileName. Only the archive index is read here.
+*/
+STATUS_t Probe::addArchive(const char* fileName)
+{
+    ArchiveReader archive;
+    RETURN_ON_FAILURE(archive.open(fileName))
+    const std::uint32_t file = m_files.size();
+    m_files.push_back(fileName);
+    for(std::size_t i = 0; i < archive.getFrameCount(); i++) {
+        const archiveEntry_t& entry = archive.getEntry(i);
+        m_sources.push_back({file, entry.offset, entry.size, entry.frameId});
+    }
+    return BASE_SUCCESS;
+}
+
+/**
+ * Reads headers of all added sources on @param threads threads (0 = hardware concurrency). Entries are sorted by
+ * timestamp; sources without a valid header are counted in getFailed().
+*/
+STATUS_t Probe::run(std::size_t threads)
+{
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, (m_sources.size() + PROBE_CHUNK - 1) / PROBE_CHUNK);
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::vector<probeEntry_t>> entries(threads);
+    std::vector<std::size_t> failed(threads, 0);
+    std::vector<std::thread> pool;
+    for(std::size_t t = 0; t < threads; t++) {
+        pool.emplace_back(&Probe::worker, this, &next, &entries[t], &failed[t]);
+    }
+    for(auto& thread : pool) {
+        thread.join();
+    }
+
+    m_entries.clear();
+    m_entries.reserve(m_sources.size());
+    m_failed = 0;
+    for(std::size_t t = 0; t < threads; t++) {
+        m_entries.insert(m_entries.end(), entries[t].begin(), entries[t].end());
+        m_failed += failed[t];
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](const probeEntry_t& a, const probeEntry_t& b) {
+        if(a.timestamp != b.timestamp) {
+            return a.timestamp < b.timestamp;
+        }
+        return a.file != b.file ? a.file < b.file : a.offset < b.offset;
+    });
+    return BASE_SUCCESS;
+}
+
+/**
+ * Takes chunks of sources until none are left. Descriptor of the last file is kept open, so frames of an archive
+ * share one.
+*/
+void Probe::worker(std::atomic<std::size_t>* pNext, std::vector<probeEntry_t>* pEntries, std::size_t* pFailed) const
+{
+    std::uint8_t fixed[OMLS_HEADER_V2_SIZE];
+    std::vector<std::uint8_t> extended;   // header with extensions
+    int fd                 = -1;
+    std::uint32_t openFile = 0;
+
+    for(std::size_t begin = pNext->fetch_add(PROBE_CHUNK); begin < m_sources.size();
+        begin             = pNext->fetch_add(PROBE_CHUNK)) {
+        const std::size_t end = std::min(begin + PROBE_CHUNK, m_sources.size());
+        for(std::size_t i = begin; i < end; i++) {
+            const source_t& source = m_sources[i];
+            if(fd < 0 || openFile != source.file) {
+                if(fd >= 0) {
+                    closeFile(fd);
+                }
+                fd       = openRead(m_files[source.file].c_str());
+                openFile = source.file;
+                if(fd < 0) {
+                    (*pFailed)++;
+                    continue;
+                }
+            }
+
+            std::uint64_t size = source.size ? source.size : fileSize(fd);
+            long long bytes    = readAt(fd, fixed, std::min<std::uint64_t>(sizeof(fixed), size), source.offset);
+            headerData_t header;
+            STATUS_t status = BASE_ERROR_HEADER_DATA_INVALID;
+            if(bytes > 0) {
+                status = Reader::getHeader(fixed, bytes, header);
+            }
+
+            if(status && bytes == OMLS_HEADER_V2_SIZE
+               && memcmp(fixed, OMLS_HEADER_MAGIC, OMLS_HEADER_MAGIC_SIZE) == 0) {
+                std::uint16_t headerLength;   // header has extensions, read it whole
+                memcpy(&headerLength, &fixed[10], sizeof(headerLength));
+                if(headerLength <= OMLS_HEADER_V2_SIZE || headerLength > size) {
+                    (*pFailed)++;
+                    continue;
+                }
+                extended.resize(headerLength);
+                if(readAt(fd, extended.data(), headerLength, source.offset) == headerLength) {
+                    status = Reader::getHeader(extended.data(), headerLength, header);
+                }
+            }
+            if(status) {
+                (*pFailed)++;
+                continue;
+            }
+
+            probeEntry_t entry{};
+            entry.timestamp = header.timestamp;
+            entry.frameId   = source.frameId;
+            entry.roi       = header.roi;
+            entry.offset    = source.offset;
+            entry.size      = size;
+            entry.width     = header.width;
+            entry.height    = header.height;
+            entry.flags     = header.flags;
+            entry.file      = source.file;
+            entry.version   = header.version;
+            entry.bpp       = header.bpp;
+            entry.lossyBits = header.lossyBits;
+            pEntries->push_back(entry);
+        }
+    }
+    if(fd >= 0) {
+        closeFile(fd);
+    }
+}
+
+const std::vector<probeEntry_t>& Probe::getEntries() const
+{
+    return m_entries;
+}
+
+const std::vector<std::string>& Probe::getFiles() const
+{
+    return m_files;
+}
+
+std::size_t Probe::getFailed() const
+{
+    return m_failed;
+}
+
+/**
+ * Writes timeline as CSV, one frame per line.
+*/
+STATUS_t Probe::writeCsv(const char* fileName) const
+{
+    FILE* pFile = fopen(fileName, "w");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    fprintf(pFile, "timestamp,frame_id,width,height,bpp,lossy_bits,version,flags,roi,offset,size,file\n");
+    for(const probeEntry_t& entry : m_entries) {
+        fprintf(pFile,
+                "%llu,%llu,%u,%u,%u,%u,%u,0x%X,0x%016llX,%llu,%llu,%s\n",
+                (unsigned long long)entry.timestamp,
+                (unsigned long long)entry.frameId,
+                entry.width,
+                entry.height,
+                entry.bpp,
+                entry.lossyBits,
+                entry.version,
+                entry.flags,
+                (unsigned long long)entry.roi,
+                (unsigned long long)entry.offset,
+                (unsigned long long)entry.size,
+                m_files[entry.file].c_str());
+    }
+    return fclose(pFile) ? BASE_CANNOT_OPEN_OUTPUT_FILE : BASE_SUCCESS;
+}
+
+/**
+ * Writes timeline as binary index, see probeEntry_t.
+*/
+STATUS_t Probe::writeBinary(const char* fileName) const
+{
+    FILE* pFile = fopen(fileName, "wb");
+    if(!pFile) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    std::uint64_t count = m_entries.size();
+    bool written        = fwrite(OMLS_PROBE_INDEX_MAGIC, OMLS_PROBE_INDEX_MAGIC_SIZE, 1, pFile) == 1
+                  && fwrite(&count, sizeof(count), 1, pFile) == 1
+                  && fwrite(m_entries.data(), sizeof(probeEntry_t), count, pFile) == count;
+    if(fclose(pFile) || !written) {
+        return BASE_CANNOT_OPEN_OUTPUT_FILE;
+    }
+    return BASE_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "DecoderBase.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define OMLS_PROBE_INDEX_MAGIC "\x89OMLSTIX"
+#define OMLS_PROBE_INDEX_MAGIC_SIZE 8
+
+/*
+* Header summary of one compressed frame. Binary timeline index is magic "\x89OMLSTIX", entry count (u64) and
+* the entries as laid out here, sorted by timestamp. All fields little-endian.
+*/
+struct probeEntry_t {
+    std::uint64_t timestamp;
+    std::uint64_t frameId;   // archive frame id, or trailing number of the file name
+    std::uint64_t roi;
+    std::uint64_t offset;   // of the frame within its file, 0 for a file per frame
+    std::uint64_t size;   // compressed bytes
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t flags;   // OMLS_FLAG_*
+    std::uint32_t file;   // index into Probe::getFiles()
+    std::uint16_t version;
+    std::uint8_t bpp;
+    std::uint8_t lossyBits;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(probeEntry_t) == 64, "probeEntry_t must match the index layout");
+
+/*
+* Builds a timeline of a recording from frame headers only. Sources are compressed files of a directory or frames
+* of an archive; headers are read with positioned reads on a pool of threads, bitstreams are never touched.
+*/
+class Probe
+{
+  private:
+    struct source_t {
+        std::uint32_t file;
+        std::uint64_t offset;
+        std::uint64_t size;   // 0 when not known yet (file per frame)
+        std::uint64_t frameId;
+    };
+    std::vector<std::string> m_files;
+    std::vector<source_t> m_sources;
+    std::vector<probeEntry_t> m_entries;
+    std::size_t m_failed = 0;
+
+    void worker(std::atomic<std::size_t>* pNext, std::vector<probeEntry_t>* pEntries, std::size_t* pFailed) const;
+
+  public:
+    STATUS_t addDirectory(const char* folder);
+    STATUS_t addArchive(const char* fileName);
+    STATUS_t run(std::size_t threads = 0);
+
+    const std::vector<probeEntry_t>& getEntries() const;
+    const std::vector<std::string>& getFiles() const;
+    std::size_t getFailed() const;
+
+    STATUS_t writeCsv(const char* fileName) const;
+    STATUS_t writeBinary(const char* fileName) const;
+};
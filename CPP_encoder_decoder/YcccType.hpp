@@ -0,0 +1,28 @@
+#pragma once
+
+#include "globalDefines.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/*
+* Signed intermediate type of YCCC and dpcm values. Y is the sum of the 4 samples of a quad (bpp + 2 bits) and its
+* dpcm is signed with one more bit, so up to OMLS_YCCC16_MAX_BPP both fit int16_t, 14 and 16 bpp need int32_t.
+* Coding cores are instantiated for both types and one is picked per frame, 8 to 12 bpp keep their int16_t code.
+*/
+
+inline bool isSupportedBpp(std::size_t bpp)
+{
+    return bpp >= 8 && bpp <= OMLS_MAX_BPP && bpp % 2 == 0;
+}
+
+/**
+ * Calls @param f with a value of the YCCC type of @param bpp, f is instantiated once for every type.
+*/
+template<typename F>
+inline decltype(auto) withYcccType(std::size_t bpp, F&& f)
+{
+    if(bpp > OMLS_YCCC16_MAX_BPP) {
+        return f(std::int32_t{});
+    }
+    return f(std::int16_t{});
+}
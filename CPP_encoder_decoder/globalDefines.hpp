@@ -1,6 +1,8 @@
 #pragma once
 
+#ifndef OMLS_NO_DUMP_VERIFICATION /* Defined by builds that must not write dump files, e.g. setup.py */
 #define DUMP_VERIFICATION
+#endif
 
 // #define k_MIN 2
 // #define k_MAX 11 // no need for higher value
@@ -12,4 +14,23 @@
 #define C_MAX_UNARY_LENGTH_FULL (2040 + 1) /* Unary length when compressor switches to binary coding of positive value*/
 #define C_MAX_UNARY_LENGTH (8) /* Unary length when compressor switches to binary coding of positive value*/
 
-#define RAW_HEADER_SIZE 16 /* Size of initial raw image size. Timestamp + ROI */
\ No newline at end of file
+#define OMLS_MAX_BPP 16 /* Deepest supported samples, bpp is even from 8 up to it */
+#define OMLS_YCCC16_MAX_BPP 12 /* Deepest bpp whose YCCC and dpcm values fit int16_t, deeper ones use int32_t */
+#define OMLS_SIZE_MULTIPLE 16 /* Frame width and height must be multiples of it, the decoder rejects other sizes */
+
+#define RAW_HEADER_SIZE 16 /* Size of initial raw image size. Timestamp + ROI */
+#define BITSTREAM_PAD_ALIGNMENT 16 /* Default size multiple compressed output is padded to with zeros */
+
+/* Compression info flags, stored in the reserved byte of the compression info header word. */
+#define OMLS_FLAG_LSB_FIRST 0x01 /* Bitstream packed LSB first within little-endian 64-bit words (default MSB first within bytes) */
+#define OMLS_FLAG_CHANNEL_PLANAR \
+    0x02 /* Channels coded one after another, each byte aligned, offsets in OMLS_EXT_CHANNEL_OFFSETS (header v2 only) */
+#define OMLS_FLAG_CFA_SHIFT 2
+#define OMLS_FLAG_CFA_MASK 0x0C /* CFA pattern of the quads, cfaPattern in Cfa.hpp, 0 is GBRG */
+#define OMLS_FLAGS_SUPPORTED (OMLS_FLAG_LSB_FIRST | OMLS_FLAG_CHANNEL_PLANAR | OMLS_FLAG_CFA_MASK)
+
+#define OMLS_INPUT_GUARD_BYTES \
+    64 /* Zero bytes appended after imported bitstream, so readers may load past the end without bounds checks */
+
+// #define OMLS_IO_URING /* Submit FrameWriter buffers through io_uring (Linux, link with -luring), otherwise pwrite */
+// #define OMLS_STB_IMAGE /* Read PNG images in IngestImage through stb_image.h (put it on the include path) */
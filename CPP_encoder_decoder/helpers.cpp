@@ -275,35 +275,45 @@ pImage Helpers::read_image(const char* input, std::size_t header_bytes, size_t w
  * other channels            by 9 bit   signed integer
  * Matlab test 1.1
  */
-pImageYCCC Helpers::bayer_to_YCCC(const Image* img, std::size_t lossyBits)
+pImageYCCC Helpers::bayer_to_YCCC(const Image* img, std::size_t lossyBits, cfaPattern cfa)
+{
+    return bayer_to_YCCC(img->getView(), lossyBits, cfa);
+}
+
+/**
+ * Transform Bayer RGB window @param view (may be part of a larger frame, read in place) to YCCC color space.
+ * Quads are read in CFA pattern @param cfa.
+ */
+pImageYCCC Helpers::bayer_to_YCCC(const BayerView& view, std::size_t lossyBits, cfaPattern cfa)
 {
 
-    auto const width       = img->getWidth();
-    auto const height      = img->getHeight();
-    auto const imageData   = img->getDataView();
+    auto const width       = view.width;
+    auto const height      = view.height;
     pImageYCCC p_imgYCCC   = make_imageYCCC(width / 2, height / 2);
     sQuadChannelCS* p_full = p_imgYCCC->getFullChannels();
 
-    for(std::size_t i = 0; i < height / 2; i++) {
-        for(std::size_t j = 0; j < width / 2; j++) {
-            std::size_t idx   = i * width / 2 + j;
-            std::size_t idxGB = 2 * i * width + 2 * j;
-            std::size_t idxB  = 2 * i * width + 2 * j + 1;
-            std::size_t idxR  = (2 * i + 1) * width + 2 * j;
-            std::size_t idxGR = (2 * i + 1) * width + 2 * j + 1;
-
-            Helpers::transformColorGB(
-               imageData[idxGB],   //
-               imageData[idxB],   //
-               imageData[idxR],   //
-               imageData[idxGR],   //
-               &(p_full->Y[idx]),   //
-               &(p_full->Cd[idx]),   //
-               &(p_full->Cm[idx]),   //
-               &(p_full->Co[idx]),
-               lossyBits);   //
+    withCfaQuad(cfa, [&](auto quad) {
+        for(std::size_t i = 0; i < height / 2; i++) {
+            const std::uint16_t* upper = view.row(2 * i);
+            const std::uint16_t* lower = view.row(2 * i + 1);
+            for(std::size_t j = 0; j < width / 2; j++) {
+                std::size_t idx = i * width / 2 + j;
+                std::uint16_t gb, b, r, gr;
+                quad.gather(upper + 2 * j, lower + 2 * j, gb, b, r, gr);
+
+                Helpers::transformColorGB(
+                   gb,   //
+                   b,   //
+                   r,   //
+                   gr,   //
+                   &(p_full->Y[idx]),   //
+                   &(p_full->Cd[idx]),   //
+                   &(p_full->Cm[idx]),   //
+                   &(p_full->Co[idx]),
+                   lossyBits);   //
+            }
         }
-    }
+    });
 #ifdef TEST_OUT
     // clang-format off
             std::cout << '\n' << "------ Test 1.1.2 --[0:3]-------" << '\n';
@@ -354,6 +364,29 @@ int Helpers::transformColorGB(
     return 0;
 }
 
+/**
+ * transformColorGB for samples over OMLS_YCCC16_MAX_BPP bits, whose Y does not fit int16_t.
+ */
+int Helpers::transformColorGB(
+   const std::uint16_t gb,
+   const std::uint16_t b,
+   const std::uint16_t r,
+   const std::uint16_t gr,
+   std::int32_t* y_o,
+   std::int32_t* cd_o,
+   std::int32_t* cm_o,
+   std::int32_t* co_o,
+   std::size_t lossyBits)
+{
+    // clang-format off
+    *y_o  = (1 * gr +  1 * r +  1 * b +  1 * gb) >> lossyBits;
+    *cd_o = (1 * gr +  0 * r +  0 * b + -1 * gb) >> lossyBits;
+    *cm_o = (1 * gr + -1 * r +  0 * b +  0 * gb) >> lossyBits;
+    *co_o = (0 * gr +  1 * r + -1 * b +  0 * gb) >> lossyBits;
+    // clang-format on
+    return 0;
+}
+
 /**
  * Determine whether system is little-endian. Important because values larger than 1 byte
  * are written to files in little-endian order.
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "Cfa.hpp"
 #include "Image.hpp"
 #include "ImageYCCC.hpp"
 #include "globalDefines.hpp"
@@ -11,7 +12,8 @@ class Helpers
   public:
     static pImage read_image(const char* input, std::size_t header_bytes, size_t width, size_t height);
 
-    static pImageYCCC bayer_to_YCCC(const Image* img, std::size_t lossyBits);
+    static pImageYCCC bayer_to_YCCC(const Image* img, std::size_t lossyBits, cfaPattern cfa = cfaPattern::gbrg);
+    static pImageYCCC bayer_to_YCCC(const BayerView& view, std::size_t lossyBits, cfaPattern cfa = cfaPattern::gbrg);
 
     static int transformColorGB(
        const std::uint16_t gb,   //
@@ -23,6 +25,16 @@ class Helpers
        std::int16_t* cm_o,   //
        std::int16_t* co_o,
        std::size_t lossyBits);
+    static int transformColorGB(
+       const std::uint16_t gb,   //
+       const std::uint16_t b,   //
+       const std::uint16_t r,   //
+       const std::uint16_t gr,   //
+       std::int32_t* y_o,   //
+       std::int32_t* cd_o,   //
+       std::int32_t* cm_o,   //
+       std::int32_t* co_o,
+       std::size_t lossyBits);
 
     static bool isLittleEndian();
 
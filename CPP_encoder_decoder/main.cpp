@@ -1,28 +1,76 @@
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <chrono>
+#include <csignal>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
+#include "Archive.hpp"
+#include "Daemon.hpp"
 #include "Decoder.hpp"
+#include "DecoderSession.hpp"
 #include "Encoder.hpp"
+#include "FrameQueue.hpp"
+#include "FrameRing.hpp"
+#include "FrameWriter.hpp"
 #include "Image.hpp"
 #include "ImageYCCC.hpp"
+#include "Ingest.hpp"
+#include "LineScan.hpp"
+#include "Manifest.hpp"
+#include "Probe.hpp"
 #include "helpers.hpp"
 #include "main.hpp"
 
-
 // example command:
 // main.exe -i C:/DATA/Repos/OMLS_Masters_SW/images/lite_dataset -o C:/DATA/Repos/OMLS_Masters_SW/images/lite_dataset -s 0 -e 9 -l 0 -b 16 -f img_ -r 8 -d -c
 
 int main(int argc, char* argv[])
 {
+    if(argc > 1 && std::strcmp(argv[1], "probe") == 0) {
+        return runProbe(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "bench-write") == 0) {
+        return runBenchWrite(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "ring-encode") == 0) {
+        return runRingEncode(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "daemon") == 0) {
+        return runDaemon(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "encode") == 0) {
+        return runEncodeStream(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "decode") == 0) {
+        return runDecodeStream(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "ingest") == 0) {
+        return runIngest(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "line-encode") == 0) {
+        return runLineEncode(argc - 2, argv + 2);
+    }
+    if(argc > 1 && std::strcmp(argv[1], "line-decode") == 0) {
+        return runLineDecode(argc - 2, argv + 2);
+    }
 
     Params params = parseArguments(argc, argv);
 
@@ -75,8 +123,29 @@ int main(int argc, char* argv[])
            &A_init,
            params.lossyBits,
            &widthHeight,
-           16);
-        if(params.decompress) {
+           16,
+           params.lsb_first,
+           params.header_version,
+           params.planar,
+           params.window,
+           params.archive,
+           params.incremental,
+           params.hash_inputs,
+           params.direct_write,
+           params.pad_alignment,
+           params.cfa_pattern);
+        if(params.decompress && params.session) {
+            decompressImageRangeSession(
+               params.fileName,
+               params.folder_out,
+               params.folder_out,
+               params.imgIdx_min,
+               params.imgIdx_max,
+               16,
+               params.session_output,
+               params.crop_flip ? &params.layout : nullptr,
+               params.archive);
+        } else if(params.decompress) {
             decompressImageRangeAGOR(
                params.fileName,
                params.folder_out,
@@ -93,6 +162,17 @@ int main(int argc, char* argv[])
                16,
                params.use_gpu);
         }
+    } else if(params.decompress && params.session) {
+        decompressImageRangeSession(
+           params.fileName,
+           params.folder_in,
+           params.folder_out,
+           params.imgIdx_min,
+           params.imgIdx_max,
+           params.header_bytes,
+           params.session_output,
+           params.crop_flip ? &params.layout : nullptr,
+           params.archive);
     } else if(params.decompress) {
         for(std::size_t imgIdx = params.imgIdx_min; imgIdx <= params.imgIdx_max; imgIdx++) {
             widthHeight.push_back(params.width);
@@ -123,6 +203,18 @@ int main(int argc, char* argv[])
     std::cout << "Program finished" << std::endl;
 }
 
+/**
+ * Path of input image @param imgIdx: <folder_in>/<fileName>NN.bin, or the same in bayerCFA_GB subfolder
+ * if it is not there.
+*/
+static void inputImagePath(char* path, const char* folder_in, const char* fileName, std::size_t imgIdx)
+{
+    sprintf(path, "%s/%s%02zu.bin", folder_in, fileName, imgIdx);
+    if(!std::filesystem::exists(path)) {
+        sprintf(path, "%s/bayerCFA_GB/%s%02zu.bin", folder_in, fileName, imgIdx);
+    }
+}
+
 /**
  * Compresses BayerCFA binary files with name img_xx.bin from base folder "folder"
  * 
@@ -139,7 +231,17 @@ void compressImageRangeAGOR(
    std::vector<std::uint32_t>* A_init,
    std::size_t lossyBits,
    std::vector<std::size_t>* imageSizes,
-   std::size_t headerBytes)
+   std::size_t headerBytes,
+   bool lsbFirst,
+   std::uint16_t headerVersion,
+   bool planar,
+   const std::size_t* window,
+   const char* archive,
+   bool incremental,
+   bool hashInputs,
+   bool directWrite,
+   std::size_t padAlignment,
+   cfaPattern cfa)
 {
     std::cout << "\nAGOR compression with Q max width: " << unsigned(unaryMaxWidth) << std::endl;
     char path[200];
@@ -155,14 +257,96 @@ void compressImageRangeAGOR(
         throw std::runtime_error(msg);
     }
 
-    for(std::size_t imgIdx = imgIdx_min; imgIdx <= imgIdx_max; imgIdx++) {
+    // Incremental batch: frames whose input and codec parameters match the manifest and whose output exists are
+    // skipped. Frames are recorded as soon as their output is complete, archive frames once the index is written
+    // and direct written frames once all writes are done.
+    Manifest manifest;
+    std::vector<manifestEntry_t> current;
+    std::vector<std::uint8_t> upToDate;
+    std::vector<manifestEntry_t> pending;
+    if(incremental) {
+        sprintf(path, "%s/compressed/manifest.csv", folder_out);
+        if(DecoderBase::handleReturnValue(manifest.open(path))) {
+            char msg[200];
+            std::sprintf(msg, "Cannot open manifest: %s", path);
+            throw std::runtime_error(msg);
+        }
+        char codec[200];
+        snprintf(codec,
+                 sizeof(codec),
+                 "bpp=%u;lossy=%zu;unary=%zu;N=%u;A=%u;lsb=%d;version=%u;planar=%d;window=%zu:%zu:%zu:%zu",
+                 bpp,
+                 lossyBits,
+                 unaryMaxWidth,
+                 N->data()[0],
+                 A_init->data()[0],
+                 lsbFirst,
+                 headerVersion,
+                 planar,
+                 window ? window[0] : 0,
+                 window ? window[1] : 0,
+                 window && window[2] ? window[2] : 0,
+                 window && window[2] ? window[3] : 0);
+        std::string params = std::string(codec) + ";out=" + (archive ? archive : fileName);
+        if(cfa != cfaPattern::gbrg) {   // GBRG manifests written before the pattern existed stay valid
+            params += std::string(";cfa=") + cfaPatternName(cfa);
+        }
+        if(padAlignment != BITSTREAM_PAD_ALIGNMENT) {   // as cfa, default keeps older manifests valid
+            params += ";pad=" + std::to_string(padAlignment);
+        }
+        std::vector<std::string> inputs;
+        for(std::size_t imgIdx = imgIdx_min; imgIdx <= imgIdx_max; imgIdx++) {
+            inputImagePath(path, folder_in, fileName, imgIdx);
+            inputs.push_back(path);
+        }
+        manifest.scan(inputs, params, hashInputs, current, upToDate);
 
-        sprintf(path, "%s/%s%02zu.bin", folder_in, fileName, imgIdx);
-        cout << "Check if exist: " << path << endl;
-        // check if file exists
-        if(!std::filesystem::exists(path)) {
-            sprintf(path, "%s/bayerCFA_GB/%s%02zu.bin", folder_in, fileName, imgIdx);
+        ArchiveReader stored;
+        bool archiveValid = false;
+        if(archive) {
+            sprintf(path, "%s/compressed/%s", folder_out, archive);
+            archiveValid = stored.open(path) == BASE_SUCCESS;
+        }
+        std::size_t skipped = 0;
+        for(std::size_t imgIdx = imgIdx_min; imgIdx <= imgIdx_max; imgIdx++) {
+            std::uint8_t& done = upToDate[imgIdx - imgIdx_min];
+            if(done && archive) {
+                std::size_t index;
+                done = archiveValid && stored.findFrameId(imgIdx, index) == BASE_SUCCESS;
+            } else if(done) {
+                sprintf(path, "%s/compressed/%s%02zu.bin", folder_out, fileName, imgIdx);
+                done = std::filesystem::exists(path);
+            }
+            skipped += done;
         }
+        cout << "Incremental: " << skipped << " of " << inputs.size() << " frames up to date" << endl;
+    }
+
+    // All frames go to one archive, each is encoded to memory first
+    ArchiveWriter archiveWriter;
+    std::ostringstream frameStream;
+    if(archive) {
+        sprintf(path, "%s/compressed/%s", folder_out, archive);
+        if(DecoderBase::handleReturnValue(archiveWriter.open(path))) {
+            char msg[200];
+            std::sprintf(msg, "Cannot open archive: %s", path);
+            throw std::runtime_error(msg);
+        }
+        cout << "Archive: " << path << ", frames already stored: " << archiveWriter.getFrameCount() << endl;
+    }
+
+    // Recording: frames written from aligned buffers bypassing page cache, buffers reused by all frames. Writes of
+    // a frame are still in flight while the next one is encoded, all are waited for after the last frame.
+    FrameWriter frameWriter;
+    std::ostream frameWriterStream(&frameWriter);
+
+    for(std::size_t imgIdx = imgIdx_min; imgIdx <= imgIdx_max; imgIdx++) {
+        if(incremental && upToDate[imgIdx - imgIdx_min]) {
+            cout << "Up to date, skipped: " << current[imgIdx - imgIdx_min].input << endl;
+            continue;
+        }
+
+        inputImagePath(path, folder_in, fileName, imgIdx);
         if(!std::filesystem::exists(path)) {
             std::cerr << "Did you put binary files into bayerCFA_GB folder? File does not exist: " << path << std::endl;
         }
@@ -198,6 +382,14 @@ void compressImageRangeAGOR(
         cout << "Read raw image binary, width: " << pImg->getWidth() << ", height: " << pImg->getHeight() << '\n';
         cout << "Original file size: " << unsigned(pImg->getDataView().size()) << " Bytes" << endl;
 
+        // Encoders read the window in place, no copy of the frame
+        BayerView view = pImg->getView();
+        if(window && window[2]) {
+            view = view.window(window[0], window[1], window[2], window[3]);
+            cout << "Sensor window: x: " << view.offsetX << ", y: " << view.offsetY << ", width: " << view.width
+                 << ", height: " << view.height << '\n';
+        }
+
 #ifdef DUMP_VERIFICATION
         sprintf(path, "%s/dump/%s%02zu_16pp.txt", folder_out, fileName, imgIdx);
         Helpers::dump16pp(path, pImg.get());
@@ -207,39 +399,97 @@ void compressImageRangeAGOR(
 
         // AGOR
         sprintf(path, "%s/compressed/%s%02zu.bin", folder_out, fileName, imgIdx);
-        std::cout << "Output file: " << path << std::endl;
+        if(archive) {
+            frameStream.str("");
+            std::cout << "Output archive frame: " << imgIdx << std::endl;
+        } else {
+            std::cout << "Output file: " << path << std::endl;
+        }
+        std::size_t fileSize = 0;
+        std::ostream* pOut   = nullptr;
+        if(archive) {
+            pOut = &frameStream;
+        } else if(directWrite) {
+            if(DecoderBase::handleReturnValue(frameWriter.open(path))) {
+                char msg[200];
+                std::sprintf(msg, "Cannot open specified file: %s", path);
+                throw std::runtime_error(msg);
+            }
+            pOut = &frameWriterStream;
+        }
 
         // ACTUAL COMPRESSION
-        Encoder enc{
-           pImg.get(),
-           pImg->getWidth(),
-           pImg->getHeight(),
-           folder_out,
-           imgIdx,
-           A_init->data()[0],
-           N->data()[0],
-           lossyBits,
-           unaryMaxWidth,
-           bpp,
-           24,
-           fileName};
-
-        std::unique_ptr<std::vector<std::size_t>> fileSize;
-        if(unaryMaxWidth == (2040 + 1)) {
-            fileSize = enc.encodeUsingMethod(Encoder::method::parallel_standard);
+        if(planar) {
+            // Archival: channels one after another, encoded on 4 threads
+            auto pImg_YCCC = Helpers::bayer_to_YCCC(view, lossyBits, cfa);
+            Encoder enc{pImg_YCCC.get(), folder_out, imgIdx, lossyBits, 24, bpp, fileName};
+            enc.setRoiOffset(view.offsetX, view.offsetY);
+            enc.setOutputStream(pOut);
+            enc.setPadAlignment(padAlignment);
+            enc.setBitOrderLSBFirst(lsbFirst);
+            enc.setCfaPattern(cfa);
+            enc.setHeaderVersion(headerVersion);
+            auto channelSizes = enc.encodeUsingMethod(Encoder::method::singleSeedInTwos);
+
+            cout << "Planar encoder: "
+                 << "Y ch: " << unsigned(channelSizes->at(0)) << " bytes, Cd ch: " << unsigned(channelSizes->at(1))
+                 << " bytes, Cm ch: " << unsigned(channelSizes->at(2)) << " bytes, Co ch: "
+                 << unsigned(channelSizes->at(3)) << " bytes, file size: " << unsigned(enc.getFileSize()) << " bytes"
+                 << endl;
+            fileSize = enc.getFileSize();
         } else {
-            fileSize = enc.encodeUsingMethod(Encoder::method::parallel_limited);
-        }
-        // DONE
+            Encoder enc{
+               view,
+               folder_out,
+               imgIdx,
+               A_init->data()[0],
+               N->data()[0],
+               lossyBits,
+               unaryMaxWidth,
+               bpp,
+               24,
+               fileName};
+            enc.setOutputStream(pOut);
+            enc.setPadAlignment(padAlignment);
+            enc.setBitOrderLSBFirst(lsbFirst);
+            enc.setCfaPattern(cfa);
+            enc.setHeaderVersion(headerVersion);
+
+            std::unique_ptr<std::vector<std::size_t>> fileSizes;
+            if(unaryMaxWidth == (2040 + 1)) {
+                fileSizes = enc.encodeUsingMethod(Encoder::method::parallel_standard);
+            } else {
+                fileSizes = enc.encodeUsingMethod(Encoder::method::parallel_limited);
+            }
+            // DONE
 
-        cout << "Parallel encoder: "
-             << "N/A: " << unsigned(N->data()[0]) << "/" << unsigned(A_init->data()[0])
-             << ", max Q width: " << unsigned(unaryMaxWidth) << ", file size: " << unsigned(fileSize->data()[0])
-             << " bytes" << endl;
+            cout << "Parallel encoder: "
+                 << "N/A: " << unsigned(N->data()[0]) << "/" << unsigned(A_init->data()[0])
+                 << ", max Q width: " << unsigned(unaryMaxWidth) << ", file size: " << unsigned(fileSizes->data()[0])
+                 << " bytes" << endl;
+            fileSize = enc.getFileSize();
+        }
 
+        if(pOut == &frameWriterStream && !frameWriterStream) {
+            throw std::runtime_error("Cannot write compressed frame.");
+        }
+        if(archive) {
+            auto data = frameStream.view();
+            if(DecoderBase::handleReturnValue(
+                  archiveWriter.append(imgIdx, (const std::uint8_t*)data.data(), data.size()))) {
+                throw std::runtime_error("Cannot append frame to archive.");
+            }
+        }
+        if(incremental && (archive || directWrite)) {   // complete once index is written or writes are done
+            pending.push_back(current[imgIdx - imgIdx_min]);
+        } else if(incremental && DecoderBase::handleReturnValue(manifest.record(current[imgIdx - imgIdx_min]))) {
+            throw std::runtime_error("Cannot write manifest.");
+        }
 #ifdef DUMP_VERIFICATION
-        translateBinaryToASCII_hex(path);
-        translateBinaryToASCII_bin(path);
+        if(!archive && !directWrite) {   // direct written file may still be in flight
+            translateBinaryToASCII_hex(path);
+            translateBinaryToASCII_bin(path);
+        }
 #endif
         //  auto current_time = std::chrono::system_clock::now();
         // wf_report << std::ctime(&current_time) << " : img_" << unsigned(imgIdx)
@@ -252,10 +502,21 @@ void compressImageRangeAGOR(
         strftime(msg, sizeof(msg), "%a %b %m %Y %H:%M:%S", p);
 
         wf_report << msg << " , " << fileName << unsigned(imgIdx) << ".png , " << unsigned(lossyBits)
-                  << " lossy bits, AGOR , " << unsigned(enc.getFileSize()) << " ,bytes"
+                  << " lossy bits, " << (planar ? "planar" : "AGOR") << " , " << unsigned(fileSize) << " ,bytes"
                   << ",max unary length," << unsigned(unaryMaxWidth) << std::endl;
     }
     wf_report.close();
+    if(DecoderBase::handleReturnValue(frameWriter.close())) {
+        throw std::runtime_error("Cannot write compressed frame.");
+    }
+    if(DecoderBase::handleReturnValue(archiveWriter.close())) {
+        throw std::runtime_error("Cannot write archive index.");
+    }
+    for(const manifestEntry_t& entry : pending) {
+        if(DecoderBase::handleReturnValue(manifest.record(entry))) {
+            throw std::runtime_error("Cannot write manifest.");
+        }
+    }
 }
 void compressImageRangeIdeal(
    const char* fileName,
@@ -318,7 +579,7 @@ void compressImageRangeIdeal(
         cout << "Output file: " << path << endl;
 
         // ACTUAL COMPRESSION IDEAL
-        Encoder enc{pImg_YCCC.get(), folder_out, imgIdx, lossyBits, headerBytes};
+        Encoder enc{pImg_YCCC.get(), folder_out, imgIdx, lossyBits, headerBytes, bpp, fileName};
         p_fileSize = enc.encodeUsingMethod(Encoder::method::ideal);
         // DONE
 
@@ -444,6 +705,143 @@ void decompressImageRangeAGOR(
     }
 }
 
+/**
+ * Decompresses range of images with a single DecoderSession. Buffers are reused between frames, so only
+ * frames larger than all previous ones allocate. Reads parallel and channel planar streams.
+ * @param output selects BayerCFA, luma preview (written as <name>_preview.bin) or RGB (written as <name>_rgb.bin).
+ * If @param pLayout is not nullptr, BayerCFA image is decoded with its crop and flips instead (data and pitch unused).
+ * If @param archive is not nullptr, frames are read from that archive by frame id instead of a file per frame.
+*/
+void decompressImageRangeSession(
+   const char* fileName,
+   const char* folder_in,
+   const char* folder_out,
+   std::size_t imgIdx_min,
+   std::size_t imgIdx_max,
+   std::size_t headerBytes,
+   DecoderSession::output output,
+   const outputDescriptor_t* pLayout,
+   const char* archive)
+{
+    std::cout << "\nAGOR session decompression" << std::endl;
+    char path[200];
+    DecoderSession session;
+    session.setOutput(output);
+    std::vector<std::uint8_t> frame;   // cropped and flipped BayerCFA image when pLayout is set
+
+    ArchiveReader archiveReader;
+    std::vector<std::uint8_t> packed;   // compressed frame read from the archive
+    if(archive) {
+        sprintf(path, "%s/compressed/%s", folder_in, archive);
+        if(DecoderBase::handleReturnValue(archiveReader.open(path))) {
+            std::cout << "Cannot open archive: " << path << std::endl;
+            return;
+        }
+        std::cout << "Archive: " << path << ", frames: " << archiveReader.getFrameCount() << std::endl;
+    }
+
+    const char* suffix = "";
+    if(output == DecoderSession::output::preview8 || output == DecoderSession::output::preview16) {
+        suffix = "_preview";
+    } else if(output != DecoderSession::output::bayer) {
+        suffix = "_rgb";
+    }
+
+    for(std::size_t imgIdx = imgIdx_min; imgIdx <= imgIdx_max; imgIdx++) {
+        sprintf(path, "%s/compressed/%s%02zu.bin", folder_in, fileName, imgIdx);
+#ifdef TIMING_EN
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+#endif
+        STATUS_t status = BASE_SUCCESS;
+        if(archive) {
+            sprintf(path, "%s/compressed/%s#%zu", folder_in, archive, imgIdx);
+            std::size_t index = 0;
+            status            = archiveReader.findFrameId(imgIdx, index);
+            if(!status) {
+                status = archiveReader.readFrame(index, packed);
+            }
+        }
+        if(status) {
+            // frame not found in archive
+        } else if(pLayout) {
+            status = archive ? session.load(packed.data(), packed.size()) : session.loadFile(path);
+            if(!status) {
+                const headerData_t& headerData = session.getHeader();
+                outputDescriptor_t layout      = *pLayout;
+                std::size_t sampleSize         = headerData.bpp == 8 ? 1 : 2;
+                std::size_t width              = layout.cropWidth ? layout.cropWidth : headerData.width;
+                std::size_t height             = layout.cropHeight ? layout.cropHeight : headerData.height;
+                if(frame.size() < width * height * sampleSize) {
+                    frame.resize(width * height * sampleSize);
+                }
+                layout.data   = frame.data();
+                layout.pitch  = width * sampleSize;
+                layout.format = sampleSize == 1 ? outputDescriptor_t::pixelFormat::u8
+                                                : outputDescriptor_t::pixelFormat::u16;
+                status        = session.decodeInto(layout);
+            }
+        } else {
+            status = archive ? session.decode(packed.data(), packed.size()) : session.decodeFile(path);
+        }
+#ifdef TIMING_EN
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "Session decoding time = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "[ms]" << std::endl;
+#endif
+        if(status) {
+            DecoderBase::handleReturnValue(status);
+            std::cout << "Decoding of " << path << " unsuccessful." << std::endl;
+            continue;
+        }
+
+        const headerData_t& headerData = session.getHeader();
+        std::uint64_t header           = 0;
+        if(headerBytes == 24) {
+            header |= (std::uint64_t)headerData.reserved << 56;
+            header |= (std::uint64_t)headerData.lossyBits << 48;
+            header |= (std::uint64_t)headerData.bpp << 40;
+            header |= (std::uint64_t)headerData.unaryMaxWidth << 32;
+            header |= (std::uint64_t)headerData.height << 16;
+            header |= (std::uint64_t)headerData.width << 0;
+        }
+
+        if(output != DecoderSession::output::bayer || pLayout) {
+            header = 0;   // compression info header describes full BayerCFA image
+        }
+        sprintf(path, "%s/decompressed/%s%02zu%s.bin", folder_out, fileName, imgIdx, suffix);
+        auto out8bit  = session.getOutput8bit();
+        auto out16bit = session.getOutput16bit();
+        if(pLayout) {
+            const headerData_t& headerData = session.getHeader();
+            std::size_t width              = pLayout->cropWidth ? pLayout->cropWidth : headerData.width;
+            std::size_t height             = pLayout->cropHeight ? pLayout->cropHeight : headerData.height;
+            std::size_t sampleSize         = headerData.bpp == 8 ? 1 : 2;
+            std::uint64_t roi              = headerData.roi;
+            if(roi && pLayout->cropWidth) {   // sensor ROI of the cropped rectangle
+                std::uint64_t offset_x = ((roi & 0xFFFF) + pLayout->cropX) & 0xFFFF;
+                std::uint64_t offset_y = ((roi >> 16 & 0xFFFF) + pLayout->cropY) & 0xFFFF;
+                roi = (height & 0xFFFF) << 48 | (width & 0xFFFF) << 32 | offset_y << 16 | offset_x;
+            }
+            status = DecoderBase::exportImage(
+               path, frame.data(), width * height * sampleSize, header, roi, headerData.timestamp);
+        } else if(!out8bit.empty()) {
+            status = DecoderBase::exportImage(
+               path, (std::uint8_t*)out8bit.data(), out8bit.size_bytes(), header, headerData.roi, headerData.timestamp);
+        } else {
+            status = DecoderBase::exportImage(
+               path,
+               (std::uint8_t*)out16bit.data(),
+               out16bit.size_bytes(),
+               header,
+               headerData.roi,
+               headerData.timestamp);
+        }
+        if(status) {
+            DecoderBase::handleReturnValue(status);
+        }
+    }
+}
+
 std::uint64_t getCurrentTimeMicros()
 {
     auto now      = std::chrono::system_clock::now();
@@ -600,6 +998,22 @@ void printHelp()
 {
     std::cout << "NOTE: Consider using python scripts to run this executable. \n"
               << "Usage:\n"
+              << "probe <directory|archive>... [-o index.csv|index.bin] [-t threads] (timeline from headers only)\n"
+              << "bench-write <file> [-n frames] [-s frame_bytes] (write latency of std::ofstream vs FrameWriter)\n"
+              << "ring-encode <raw_ring> <compressed_ring> [-k slots] [-z slot_bytes] [-o dump_location] "
+                 "[-l lossy_bits] [-u unary_max_width] [-L] (compress frames between shared memory rings)\n"
+              << "encode <raw_stream|-> <compressed_stream|-> [-l lossy_bits] [-u unary_max_width] [-L] "
+                 "[-o dump_location] (frame streams, - is stdin/stdout, see readFrameStream)\n"
+              << "decode <compressed_stream|-> <raw_stream|->\n"
+              << "line-encode <raw_rows|-> <line_stream|-> -w width -r bpp [-n segment_rows] [-l lossy_bits] "
+                 "[-u unary_max_width] [-L] [-B cfa_pattern] [-o dump_location] (open-ended line-scan strip of "
+                 "16-bit rows, see LineScan.hpp)\n"
+              << "line-decode <line_stream|-> <raw_rows|-> [-s first_segment] (starts at first segment boundary "
+                 "found)\n"
+              << "ingest <output_location> <image>... [-r bpp] [-t threads] [-l lossy_bits] [-u unary_max_width] [-L] "
+                 "(compress PPM/PGM images directly, mosaicked to BayerCFA GB; PNG if built with OMLS_STB_IMAGE)\n"
+              << "daemon <camera_config> [-s stats_socket] [-o dump_location] (compress several cameras until "
+                 "their inputs end or SIGINT/SIGTERM, see Daemon::parseConfig)\n"
               << "-i input_location (where bayerCFA_GB folder is)\n"
               << "-o output_location\n"
               << "-s min_index\n"
@@ -611,12 +1025,935 @@ void printHelp()
               << "[-l lossy_bits, default 0] \n"
               << "[-u unary_max_width]\n"
               << "[-b header_bytes (for input file, default 16 (if not specified or set to 0, specify image width and "
-                 "height); compressed file always has 24 bytes)\n]"
+                 "height))\n]"
               << "[-x width -y height] (necesarry only if header == 0)"
-              << "[-r bpp] (resolution in bits per pixel, default 8)\n"
+              << "[-r bpp] (resolution in bits per pixel: 8, 10, 12, 14 or 16, default 8)\n"
+              << "[-L] (add to pack compressed bitstream LSB first, faster decoding)\n"
+              << "[-P] (add for channel planar archival format, channels encoded on 4 threads)\n"
+              << "[-V header_version] (of compressed file, default 2; 1 for legacy 24-byte header. Decoder detects it)\n"
+              << "[-S] (add to decompress all images with one reusable decoder session, no per-frame allocations)\n"
+              << "[-Y preview_bits] (8 or 16; decompress only half resolution luma preview, implies -S)\n"
+              << "[-R rgb_mode] (half, bilinear or edge; decompress demosaiced interleaved RGB, implies -S)\n"
+              << "[-C x,y,width,height] (decompress only this even aligned BayerCFA rectangle, parsing stops after "
+                 "its last row, implies -S)\n"
+              << "[-F flip] (h, v or rot180; flip decompressed BayerCFA image, implies -S)\n"
+              << "[-A archive] (compress all frames into this archive in compressed folder, appending if it exists; "
+                 "decompress frames from it by index, implies -S)\n"
+              << "[-I] (incremental compress: skip frames whose input, parameters and output are unchanged since "
+                 "last run, see compressed/manifest.csv)\n"
+              << "[-H] (as -I, also compare hash of input contents)\n"
+              << "[-W x,y,width,height] (compress only this even aligned window of each frame, width and height "
+                 "multiples of 16, read in place; offsets stored in ROI header)\n"
+              << "[-D] (write compressed files through aligned buffers with O_DIRECT, io_uring if built with "
+                 "OMLS_IO_URING)\n"
+              << "[-a bytes] (pad compressed files with zeros to a multiple of bytes, default 16)\n"
+              << "[-B cfa_pattern] (GBRG, RGGB, BGGR or GRBG; CFA pattern of input frames, stored in the header, "
+                 "default GBRG)\n"
               << std::endl;
 }
 
+/**
+ * probe <directory|archive>... [-o index.csv|index.bin] [-t threads]
+ * Reads only headers of compressed frames and writes a timeline sorted by timestamp, as CSV or binary index
+ * (any other extension than .csv).
+*/
+int runProbe(int argc, char* argv[])
+{
+    const char* output  = "timeline.csv";
+    std::size_t threads = 0;
+    Probe probe;
+
+    for(int i = 0; i < argc; i++) {
+        if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if(std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        } else {
+            STATUS_t status = std::filesystem::is_directory(argv[i]) ? probe.addDirectory(argv[i])
+                                                                      : probe.addArchive(argv[i]);
+            if(status) {
+                DecoderBase::handleReturnValue(status);
+                std::cerr << "Cannot probe: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    if(probe.getFiles().empty()) {
+        std::cout << "Usage: probe <directory|archive>... [-o index.csv|index.bin] [-t threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    probe.run(threads);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Probed " << probe.getEntries().size() << " frames (" << probe.getFailed() << " without valid header) in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[us]" << std::endl;
+
+    const bool csv  = std::filesystem::path(output).extension() == ".csv";
+    STATUS_t status = csv ? probe.writeCsv(output) : probe.writeBinary(output);
+    if(status) {
+        DecoderBase::handleReturnValue(status);
+        return EXIT_FAILURE;
+    }
+    std::cout << "Timeline written to " << output << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Prints median, 99th percentile and worst of per-frame write @param latencies [us] and throughput of
+ * @param bytes written in @param totalMicros.
+*/
+static void printWriteLatency(
+   const char* name,
+   std::vector<std::uint64_t>& latencies,
+   std::uint64_t bytes,
+   std::uint64_t totalMicros)
+{
+    std::sort(latencies.begin(), latencies.end());
+    const std::size_t n = latencies.size();
+    std::cout << name << ": p50 " << latencies[n / 2] << "[us], p99 " << latencies[std::min(n - 1, n * 99 / 100)]
+              << "[us], max " << latencies[n - 1] << "[us], " << bytes / std::max<std::uint64_t>(totalMicros, 1)
+              << " MB/s" << std::endl;
+}
+
+/**
+ * bench-write <file> [-n frames] [-s frame_bytes]
+ * Records synthetic compressed frames to @param file with std::ofstream (the default output path), then with
+ * FrameWriter, and compares per-frame write latency. Close time is part of throughput.
+*/
+int runBenchWrite(int argc, char* argv[])
+{
+    if(argc < 1) {
+        std::cout << "Usage: bench-write <file> [-n frames] [-s frame_bytes]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* fileName  = argv[0];
+    std::size_t frames    = 200;
+    std::size_t frameSize = 1 << 21;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(std::strcmp(argv[i], "-n") == 0) {
+            frames = std::stoul(argv[i + 1]);
+        } else if(std::strcmp(argv[i], "-s") == 0) {
+            frameSize = std::stoul(argv[i + 1]);
+        }
+    }
+    if(frames == 0 || frameSize == 0) {
+        std::cerr << "Frames and frame size must not be 0." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<char> frame(frameSize);
+    for(std::size_t i = 0; i < frameSize; i++) {
+        frame[i] = (char)(i * 2654435761u >> 13);
+    }
+    std::vector<std::uint64_t> latencies(frames);
+    const std::uint64_t bytes = (std::uint64_t)frames * frameSize;
+
+    std::ofstream wf(fileName, std::ios::out | std::ios::binary);
+    if(!wf) {
+        std::cerr << "Cannot open specified file: " << fileName << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::uint64_t begin = getCurrentTimeMicros();
+    for(std::size_t i = 0; i < frames; i++) {
+        std::uint64_t start = getCurrentTimeMicros();
+        wf.write(frame.data(), frameSize);
+        latencies[i] = getCurrentTimeMicros() - start;
+    }
+    wf.close();
+    printWriteLatency("std::ofstream", latencies, bytes, getCurrentTimeMicros() - begin);
+
+    FrameWriter writer;
+    if(DecoderBase::handleReturnValue(writer.open(fileName))) {
+        return EXIT_FAILURE;
+    }
+    const char* backends[] = {"FrameWriter (buffered)", "FrameWriter (O_DIRECT)", "FrameWriter (io_uring)"};
+    begin = getCurrentTimeMicros();
+    for(std::size_t i = 0; i < frames; i++) {
+        std::uint64_t start = getCurrentTimeMicros();
+        if(DecoderBase::handleReturnValue(writer.write(frame.data(), frameSize))) {
+            return EXIT_FAILURE;
+        }
+        latencies[i] = getCurrentTimeMicros() - start;
+    }
+    if(DecoderBase::handleReturnValue(writer.close())) {
+        return EXIT_FAILURE;
+    }
+    printWriteLatency(backends[(int)writer.getBackend()], latencies, bytes, getCurrentTimeMicros() - begin);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * ring-encode <raw_ring> <compressed_ring> [-k slots] [-z slot_bytes] [-o dump_location] [-l lossy_bits]
+ * [-u unary_max_width] [-L]
+ * Compresses frames published by a capture process in shared memory ring raw_ring (see FrameRing) until it is
+ * finished. Raw slots are encoded in place and compressed frames are written straight into slots of ring
+ * compressed_ring, created here, for a recorder or network process. Frames not fitting a slot are dropped.
+*/
+int runRingEncode(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cout << "Usage: ring-encode <raw_ring> <compressed_ring> [-k slots] [-z slot_bytes] [-o dump_location] "
+                     "[-l lossy_bits] [-u unary_max_width] [-L]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* rawName        = argv[0];
+    const char* compressedName = argv[1];
+    const char* folder         = ".";
+    std::uint32_t slots        = 8;
+    std::uint64_t slotBytes    = 0;
+    std::size_t lossyBits      = 0;
+    std::size_t unaryMaxWidth  = C_MAX_UNARY_LENGTH;
+    bool lsbFirst              = false;
+    for(int i = 2; i < argc; i++) {
+        if(std::strcmp(argv[i], "-L") == 0) {
+            lsbFirst = true;
+        } else if(i + 1 >= argc) {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        } else if(std::strcmp(argv[i], "-k") == 0) {
+            slots = std::stoul(argv[++i]);
+        } else if(std::strcmp(argv[i], "-z") == 0) {
+            slotBytes = std::stoull(argv[++i]);
+        } else if(std::strcmp(argv[i], "-o") == 0) {
+            folder = argv[++i];
+        } else if(std::strcmp(argv[i], "-l") == 0) {
+            lossyBits = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-u") == 0) {
+            unaryMaxWidth = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    FrameRing raw;
+    STATUS_t status = raw.open(rawName);
+    if(status) {
+        DecoderBase::handleReturnValue(status);
+        std::cerr << "Cannot open raw ring: " << rawName << std::endl;
+        return EXIT_FAILURE;
+    }
+    createMissingDirectories(folder);
+    FrameRing compressed;
+    if(slotBytes == 0) {
+        slotBytes = raw.getSlotSize() + OMLS_HEADER_V2_SIZE + 4096;   // incompressible frame still fits
+    }
+    status = compressed.create(compressedName, slots, slotBytes);
+    if(status) {
+        DecoderBase::handleReturnValue(status);
+        std::cerr << "Cannot create compressed ring: " << compressedName << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Encoding frames from ring " << rawName << " to ring " << compressedName << " (" << slots << " x "
+              << slotBytes << " bytes)" << std::endl;
+
+    std::size_t frames = 0, dropped = 0;
+    std::uint64_t bytesIn = 0, bytesOut = 0;
+    const std::uint64_t begin = getCurrentTimeMicros();
+    for(;;) {
+        const frameSlot_t* pRaw = raw.beginRead();
+        if(!pRaw) {
+            if(raw.isFinished()) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        frameSlot_t* pOut = compressed.beginWrite();
+        if(!pOut) {
+            std::this_thread::yield();   // consumer is behind, raw slot is kept until there is room
+            continue;
+        }
+
+        BayerView view;
+        view.data   = reinterpret_cast<const std::uint16_t*>(pRaw->payload());
+        view.pitch  = pRaw->pitch;
+        view.width  = pRaw->width;
+        view.height = pRaw->height;
+        if(!isValidRawSlot(*pRaw, raw.getSlotSize())) {
+            std::cerr << "Invalid raw frame " << pRaw->frameId << ", dropped." << std::endl;
+            dropped++;
+            raw.endRead();
+            continue;
+        }
+
+        FrameSlotBuffer slotBuffer(pOut, compressed.getSlotSize());
+        std::ostream slotStream(&slotBuffer);
+        Encoder enc{view, folder, pRaw->frameId % 100, 32, 8, lossyBits, unaryMaxWidth, pRaw->bpp, 24, "ring_"};
+        enc.setOutputStream(&slotStream);
+        enc.setBitOrderLSBFirst(lsbFirst);
+        enc.setTimestamp(pRaw->timestamp / 1000);   // slot timestamps are in us
+        enc.setDumpVerification(false);
+        enc.encodeUsingMethod(
+           unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                    : Encoder::method::parallel_limited);
+
+        if(slotStream) {
+            pOut->size      = slotBuffer.size();
+            pOut->frameId   = pRaw->frameId;
+            pOut->timestamp = pRaw->timestamp;
+            pOut->width     = pRaw->width;
+            pOut->height    = pRaw->height;
+            pOut->pitch     = 0;
+            pOut->bpp       = pRaw->bpp;
+            compressed.endWrite();
+            frames++;
+            bytesIn += (std::uint64_t)view.width * view.height * (pRaw->bpp > 8 ? 2 : 1);
+            bytesOut += pOut->size;
+        } else {
+            std::cerr << "Compressed frame " << pRaw->frameId << " does not fit a slot, dropped." << std::endl;
+            dropped++;
+        }
+        raw.endRead();
+    }
+    compressed.finish();
+
+    const std::uint64_t micros = std::max<std::uint64_t>(getCurrentTimeMicros() - begin, 1);
+    std::cout << "Encoded " << frames << " frames (" << dropped << " dropped), " << bytesIn << " -> " << bytesOut
+              << " bytes in " << micros << "[us], " << frames * 1000000 / micros << " fps" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#define STREAM_BUFFER_BYTES (1 << 20) /* stdio buffer of frame streams, so reads and writes are large */
+#define STREAM_MAX_FRAME_BYTES (1ULL << 30) /* Largest frame accepted from a frame stream */
+
+/**
+ * Opens frame stream @param name for reading, - is stdin.
+*/
+static FILE* openStreamInput(const char* name)
+{
+    FILE* pFile = std::strcmp(name, "-") == 0 ? stdin : fopen(name, "rb");
+#ifdef _WIN32
+    if(pFile == stdin) {
+        _setmode(_fileno(stdin), _O_BINARY);
+    }
+#endif
+    if(pFile) {
+        setvbuf(pFile, nullptr, _IOFBF, STREAM_BUFFER_BYTES);
+    }
+    return pFile;
+}
+
+/**
+ * Opens frame stream @param name for writing, - is stdout. Standard output is then redirected to stderr, so
+ * progress messages of encoder and decoder stay out of the stream.
+*/
+static FILE* openStreamOutput(const char* name)
+{
+    FILE* pFile;
+    if(std::strcmp(name, "-") != 0) {
+        pFile = fopen(name, "wb");
+    } else {
+        std::cout.flush();
+        fflush(stdout);
+#ifdef _WIN32
+        int fd = _dup(_fileno(stdout));
+        _dup2(_fileno(stderr), _fileno(stdout));
+        _setmode(fd, _O_BINARY);
+        pFile = fd >= 0 ? _fdopen(fd, "wb") : nullptr;
+#else
+        int fd = dup(fileno(stdout));
+        dup2(fileno(stderr), fileno(stdout));
+        pFile = fd >= 0 ? fdopen(fd, "wb") : nullptr;
+#endif
+    }
+    if(pFile) {
+        setvbuf(pFile, nullptr, _IOFBF, STREAM_BUFFER_BYTES);
+    }
+    return pFile;
+}
+
+/**
+ * Input thread of the stream modes. A frame stream is a sequence of frameSlot_t descriptors, each followed by its
+ * payload: raw frames of pitch std::uint16_t samples per row, or complete compressed streams (pitch 0), the same
+ * as FrameRing slots. Frames of @param pIn are queued in @param pQueue until the stream ends, so the next frame is
+ * read while the current one is coded. Stops early when @param pFailed is set.
+*/
+static void readFrameStream(FILE* pIn, FrameQueue* pQueue, bool raw, std::atomic<bool>* pFailed)
+{
+    std::atomic<std::uint64_t> dropped{0};
+    frameSlot_t slot;
+    while(fread(&slot, sizeof(slot), 1, pIn) == 1) {
+        if(raw ? !isValidRawSlot(slot, STREAM_MAX_FRAME_BYTES) : slot.size == 0 || slot.size > STREAM_MAX_FRAME_BYTES) {
+            std::cerr << "Invalid frame descriptor in stream." << std::endl;
+            *pFailed = true;
+            break;
+        }
+        int index = pQueue->acquire(dropPolicy::block, *pFailed, dropped);
+        if(index < 0) {
+            break;
+        }
+        queuedFrame_t& frame = pQueue->frame(index);
+        frame.slot           = slot;
+        frame.payload.resize(slot.size);
+        if(fread(frame.payload.data(), 1, slot.size, pIn) != slot.size) {
+            std::cerr << "Frame stream ends within a frame." << std::endl;
+            pQueue->release(index);
+            *pFailed = true;
+            break;
+        }
+        pQueue->publish(index);
+    }
+    if(ferror(pIn)) {
+        *pFailed = true;
+    }
+    pQueue->close();
+}
+
+/**
+ * Writes frame @param slot, its size set to @param size, followed by @param size bytes of @param data.
+*/
+static bool writeFrameStream(FILE* pOut, frameSlot_t slot, const void* data, std::size_t size)
+{
+    slot.size = size;
+    return fwrite(&slot, sizeof(slot), 1, pOut) == 1 && fwrite(data, 1, size, pOut) == size;
+}
+
+/**
+ * encode <raw_stream|-> <compressed_stream|-> [-l lossy_bits] [-u unary_max_width] [-L] [-o dump_location]
+ * Compresses a raw frame stream to a compressed frame stream, see readFrameStream(). Frame id, timestamp and
+ * size of each frame are kept in its descriptor.
+*/
+int runEncodeStream(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: encode <raw_stream|-> <compressed_stream|-> [-l lossy_bits] [-u unary_max_width] [-L] "
+                     "[-o dump_location]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* folder        = ".";
+    std::size_t lossyBits     = 0;
+    std::size_t unaryMaxWidth = C_MAX_UNARY_LENGTH;
+    bool lsbFirst             = false;
+    for(int i = 2; i < argc; i++) {
+        if(std::strcmp(argv[i], "-L") == 0) {
+            lsbFirst = true;
+        } else if(std::strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            lossyBits = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            unaryMaxWidth = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            folder = argv[++i];
+        } else {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE* pIn  = openStreamInput(argv[0]);
+    FILE* pOut = openStreamOutput(argv[1]);
+    if(!pIn || !pOut) {
+        std::cerr << "Cannot open frame stream: " << (pIn ? argv[1] : argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+    createMissingDirectories(folder);
+
+    FrameQueue queue(2);
+    std::atomic<bool> failed{false};
+    std::thread reader(readFrameStream, pIn, &queue, true, &failed);
+
+    std::ostringstream frameStream;
+    std::size_t frames     = 0;
+    std::uint64_t bytesIn  = 0;
+    std::uint64_t bytesOut = 0;
+    std::uint64_t begin    = getCurrentTimeMicros();
+    for(int index = queue.pop(); index >= 0; index = queue.pop()) {
+        queuedFrame_t& frame = queue.frame(index);
+        frameSlot_t slot     = frame.slot;
+        BayerView view;
+        view.data   = reinterpret_cast<const std::uint16_t*>(frame.payload.data());
+        view.pitch  = slot.pitch;
+        view.width  = slot.width;
+        view.height = slot.height;
+
+        frameStream.str("");
+        try {
+            Encoder enc{view, folder, slot.frameId % 100, 32, 8, lossyBits, unaryMaxWidth, slot.bpp, 24, "stream_"};
+            enc.setOutputStream(&frameStream);
+            enc.setBitOrderLSBFirst(lsbFirst);
+            enc.setTimestamp(slot.timestamp / 1000);   // slot timestamps are in us
+            enc.setDumpVerification(false);
+            enc.setVerbose(false);   // compressed stream may go to stdout
+            enc.encodeUsingMethod(
+               unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                        : Encoder::method::parallel_limited);
+        } catch(const std::exception& e) {
+            std::cerr << "Frame " << slot.frameId << ": " << e.what() << std::endl;
+            failed = true;
+        }
+        queue.release(index);   // next frame may be read into it while this one is written
+        if(failed) {
+            break;
+        }
+
+        auto data  = frameStream.view();
+        slot.pitch = 0;
+        if(!writeFrameStream(pOut, slot, data.data(), data.size())) {
+            std::cerr << "Cannot write compressed frame stream." << std::endl;
+            failed = true;
+            break;
+        }
+        frames++;
+        bytesIn += (std::uint64_t)view.width * view.height * (slot.bpp > 8 ? 2 : 1);
+        bytesOut += data.size();
+    }
+    reader.join();
+    if(fflush(pOut)) {
+        failed = true;
+    }
+
+    std::cerr << "Encoded " << frames << " frames, " << bytesIn << " -> " << bytesOut << " bytes in "
+              << getCurrentTimeMicros() - begin << "[us]" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * decode <compressed_stream|-> <raw_stream|->
+ * Decompresses a compressed frame stream to a raw frame stream with 16-bit samples and pitch equal to width, the
+ * input format of encode, see readFrameStream(). Frames are decoded by one reused DecoderSession.
+*/
+int runDecodeStream(int argc, char* argv[])
+{
+    if(argc != 2) {
+        std::cerr << "Usage: decode <compressed_stream|-> <raw_stream|->" << std::endl;
+        return EXIT_FAILURE;
+    }
+    FILE* pIn  = openStreamInput(argv[0]);
+    FILE* pOut = openStreamOutput(argv[1]);
+    if(!pIn || !pOut) {
+        std::cerr << "Cannot open frame stream: " << (pIn ? argv[1] : argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    FrameQueue queue(2);
+    std::atomic<bool> failed{false};
+    std::thread reader(readFrameStream, pIn, &queue, false, &failed);
+
+    DecoderSession session;
+    std::vector<std::uint16_t> samples;
+    std::size_t frames  = 0;
+    std::uint64_t begin = getCurrentTimeMicros();
+    for(int index = queue.pop(); index >= 0; index = queue.pop()) {
+        queuedFrame_t& frame = queue.frame(index);
+        frameSlot_t slot     = frame.slot;
+        STATUS_t status      = session.decode(frame.payload.data(), frame.payload.size());
+        queue.release(index);   // next frame may be read into it while this one is written
+        if(status) {
+            DecoderBase::handleReturnValue(status);
+            std::cerr << "Frame " << slot.frameId << " cannot be decoded." << std::endl;
+            failed = true;
+            break;
+        }
+
+        const headerData_t& header = session.getHeader();
+        slot.width                 = header.width;
+        slot.height                = header.height;
+        slot.pitch                 = header.width;
+        slot.bpp                   = header.bpp;
+
+        std::span<const std::uint16_t> output = session.getOutput16bit();
+        if(output.empty()) {
+            auto output8bit = session.getOutput8bit();
+            samples.assign(output8bit.begin(), output8bit.end());
+            output = samples;
+        }
+        if(!writeFrameStream(pOut, slot, output.data(), output.size_bytes())) {
+            std::cerr << "Cannot write raw frame stream." << std::endl;
+            failed = true;
+            break;
+        }
+        frames++;
+    }
+    reader.join();
+    if(fflush(pOut)) {
+        failed = true;
+    }
+
+    std::cerr << "Decoded " << frames << " frames in " << getCurrentTimeMicros() - begin << "[us]" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Input thread of line-encode. Reads rows of @param width 16-bit samples from @param pIn into frames of
+ * @param segmentRows rows each, the last frame holds the rows left when the strip ends.
+*/
+static void readRowStream(
+   FILE* pIn,
+   FrameQueue* pQueue,
+   std::size_t width,
+   std::size_t segmentRows,
+   std::atomic<bool>* pFailed)
+{
+    std::atomic<std::uint64_t> dropped{0};
+    const std::size_t rowBytes = width * sizeof(std::uint16_t);
+    for(std::uint64_t segment = 0; !feof(pIn) && !ferror(pIn); segment++) {
+        int index = pQueue->acquire(dropPolicy::block, *pFailed, dropped);
+        if(index < 0) {
+            break;
+        }
+        queuedFrame_t& frame = pQueue->frame(index);
+        frame.payload.resize(segmentRows * rowBytes);
+        std::size_t bytes = fread(frame.payload.data(), 1, frame.payload.size(), pIn);
+        if(bytes % rowBytes || bytes == 0) {
+            if(bytes % rowBytes) {
+                std::cerr << "Line-scan strip ends within a row." << std::endl;
+                *pFailed = true;
+            }
+            pQueue->release(index);
+            break;
+        }
+        frame.slot.frameId   = segment;
+        frame.slot.timestamp = getCurrentTimeMicros();
+        frame.slot.width     = width;
+        frame.slot.height    = bytes / rowBytes;
+        frame.slot.pitch     = width;
+        pQueue->publish(index);
+    }
+    if(ferror(pIn)) {
+        *pFailed = true;
+    }
+    pQueue->close();
+}
+
+/**
+ * line-encode <raw_rows|-> <line_stream|-> -w width -r bpp [-n segment_rows] [-l lossy_bits] [-u unary_max_width]
+ *    [-L] [-B cfa_pattern] [-o dump_location]
+ * Compresses an open-ended strip, rows of width 16-bit samples without any headers, to a line-scan stream (see
+ * LineScan.hpp) until the input ends. At most two segments of rows are held, whatever the strip length.
+*/
+int runLineEncode(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: line-encode <raw_rows|-> <line_stream|-> -w width -r bpp [-n segment_rows] "
+                     "[-l lossy_bits] [-u unary_max_width] [-L] [-B cfa_pattern] [-o dump_location]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* folder        = ".";
+    std::size_t width         = 0;
+    std::size_t bpp           = 0;
+    std::size_t segmentRows   = OMLS_LINE_SEGMENT_ROWS;
+    std::size_t lossyBits     = 0;
+    std::size_t unaryMaxWidth = C_MAX_UNARY_LENGTH;
+    bool lsbFirst             = false;
+    cfaPattern cfa            = cfaPattern::gbrg;
+    for(int i = 2; i < argc; i++) {
+        if(std::strcmp(argv[i], "-L") == 0) {
+            lsbFirst = true;
+        } else if(std::strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            width = std::stoul(argv[++i]);
+        } else if(std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            bpp = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            segmentRows = std::stoul(argv[++i]);
+        } else if(std::strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            lossyBits = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            unaryMaxWidth = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+            if(!parseCfaPattern(argv[++i], cfa)) {
+                std::cerr << "Invalid CFA pattern: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            folder = argv[++i];
+        } else {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(width == 0 || width % 2 || width > UINT32_MAX || !isSupportedBpp(bpp)) {
+        std::cerr << "Width must be even and bpp 8, 10, 12, 14 or 16." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if(segmentRows == 0 || segmentRows % 16 || segmentRows * width * sizeof(std::uint16_t) > STREAM_MAX_FRAME_BYTES) {
+        std::cerr << "Segment rows must be a multiple of 16, segment at most " << STREAM_MAX_FRAME_BYTES << " bytes."
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    FILE* pIn  = openStreamInput(argv[0]);
+    FILE* pOut = openStreamOutput(argv[1]);
+    if(!pIn || !pOut) {
+        std::cerr << "Cannot open line-scan stream: " << (pIn ? argv[1] : argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+    createMissingDirectories(folder);
+
+    FrameQueue queue(2);
+    std::atomic<bool> failed{false};
+    std::thread reader(readRowStream, pIn, &queue, width, segmentRows, &failed);
+
+    LineScanEncoder encoder(width, (std::uint8_t)bpp, lossyBits, unaryMaxWidth, folder);
+    encoder.setBitOrderLSBFirst(lsbFirst);
+    encoder.setCfaPattern(cfa);
+    std::uint64_t bytesOut = 0;
+    std::uint64_t begin    = getCurrentTimeMicros();
+    for(int index = queue.pop(); index >= 0; index = queue.pop()) {
+        queuedFrame_t& frame = queue.frame(index);
+        std::size_t bytes    = 0;
+        STATUS_t status;
+        try {
+            status = encoder.encode(
+               reinterpret_cast<const std::uint16_t*>(frame.payload.data()),
+               width,
+               frame.slot.height,
+               frame.slot.timestamp,
+               pOut,
+               bytes);
+        } catch(const std::exception& e) {
+            std::cerr << "Segment " << frame.slot.frameId << ": " << e.what() << std::endl;
+            status = BASE_ERROR;
+        }
+        queue.release(index);
+        if(status) {
+            DecoderBase::handleReturnValue(status);
+            failed = true;
+            break;
+        }
+        bytesOut += bytes;
+    }
+    reader.join();
+    if(fflush(pOut)) {
+        failed = true;
+    }
+
+    std::cerr << "Encoded " << encoder.getRowCount() << " rows in " << encoder.getSegmentCount() << " segments, "
+              << encoder.getRowCount() * width * (bpp > 8 ? 2 : 1) << " -> " << bytesOut << " bytes in "
+              << getCurrentTimeMicros() - begin << "[us]" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * line-decode <line_stream|-> <raw_rows|-> [-s first_segment]
+ * Decompresses a line-scan stream to rows of 16-bit samples, the input of line-encode. Input may begin anywhere
+ * within a stream: decoding starts at the first segment boundary found, or at segment first_segment.
+*/
+int runLineDecode(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: line-decode <line_stream|-> <raw_rows|-> [-s first_segment]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::uint64_t firstSegment = 0;
+    for(int i = 2; i < argc; i++) {
+        if(std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            firstSegment = std::stoull(argv[++i]);
+        } else {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    FILE* pIn  = openStreamInput(argv[0]);
+    FILE* pOut = openStreamOutput(argv[1]);
+    if(!pIn || !pOut) {
+        std::cerr << "Cannot open line-scan stream: " << (pIn ? argv[1] : argv[0]) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    LineScanDecoder decoder;
+    if(decoder.sync(pIn)) {
+        std::cerr << "No line-scan segment found in " << argv[0] << std::endl;
+        return EXIT_FAILURE;
+    }
+    STATUS_t status;
+    std::uint64_t rows   = 0;
+    std::size_t segments = 0;
+    std::uint64_t begin  = getCurrentTimeMicros();
+    bool first           = true;
+    while((status = decoder.read(pIn)) == BASE_SUCCESS) {
+        const lineSegment_t& segment = decoder.getSegment();
+        if(segment.index < firstSegment) {
+            continue;   // read, not decoded
+        }
+        if(first) {
+            std::cerr << "Decoding from segment " << segment.index << ", strip row " << segment.firstRow << std::endl;
+            first = false;
+        }
+        if((status = decoder.decode()) != BASE_SUCCESS) {
+            break;
+        }
+        const std::size_t samples = (std::size_t)segment.width * segment.rows;
+        if(fwrite(decoder.getRows(), sizeof(std::uint16_t), samples, pOut) != samples) {
+            status = BASE_CANNOT_OPEN_OUTPUT_FILE;
+            break;
+        }
+        rows += segment.rows;
+        segments++;
+    }
+    const bool failed = (status != BASE_ERROR_ALL_BYTES_ALREADY_READ) | (fflush(pOut) != 0);
+    if(status != BASE_ERROR_ALL_BYTES_ALREADY_READ) {
+        DecoderBase::handleReturnValue(status);
+    }
+
+    std::cerr << "Decoded " << rows << " rows in " << segments << " segments in " << getCurrentTimeMicros() - begin
+              << "[us]" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static Daemon* g_pDaemon = nullptr;
+
+static void stopDaemon(int)
+{
+    g_pDaemon->stop();
+}
+
+/**
+ * daemon <camera_config> [-s stats_socket] [-o dump_location]
+ * Compresses frames of all cameras in camera_config in one long running process, see Daemon. Counters of all
+ * cameras are printed at the end and served on stats_socket meanwhile.
+*/
+int runDaemon(int argc, char* argv[])
+{
+    if(argc < 1) {
+        std::cout << "Usage: daemon <camera_config> [-s stats_socket] [-o dump_location]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* statsSocket = nullptr;
+    const char* folder      = ".";
+    for(int i = 1; i < argc; i++) {
+        if(std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            statsSocket = argv[++i];
+        } else if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            folder = argv[++i];
+        } else {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<cameraConfig_t> cameras;
+    STATUS_t status = Daemon::parseConfig(argv[0], cameras);
+    if(status || cameras.empty()) {
+        DecoderBase::handleReturnValue(status);
+        std::cerr << "No cameras configured in " << argv[0] << std::endl;
+        return EXIT_FAILURE;
+    }
+    createMissingDirectories(folder);
+
+    Daemon daemon;
+    for(const cameraConfig_t& camera : cameras) {
+        daemon.addCamera(camera);
+        std::cout << "Camera " << camera.name << ": " << camera.input << " -> " << camera.output << std::endl;
+    }
+    g_pDaemon = &daemon;
+    std::signal(SIGINT, stopDaemon);
+    std::signal(SIGTERM, stopDaemon);
+    status = daemon.run(statsSocket, folder);
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    g_pDaemon = nullptr;
+
+    std::cout << daemon.report();
+    return status ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * ingest <output_location> <image>... [-r bpp] [-t threads] [-l lossy_bits] [-u unary_max_width] [-L]
+ * Compresses PPM/PGM (PNG if built with OMLS_STB_IMAGE) images directly, without bayerCFA_GB .bin files: each image
+ * is mosaicked to BayerCFA GB while it is read (see IngestImage) and written to compressed/<name>.bin.
+ * Images are processed on threads threads (default one per core), each reusing its image buffers.
+*/
+int runIngest(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: ingest <output_location> <image>... [-r bpp] [-t threads] [-l lossy_bits] "
+                     "[-u unary_max_width] [-L]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const char* folder        = argv[0];
+    std::uint8_t bpp          = 0;
+    std::size_t threads       = 0;
+    std::size_t lossyBits     = 0;
+    std::size_t unaryMaxWidth = C_MAX_UNARY_LENGTH;
+    bool lsbFirst             = false;
+    std::vector<std::string> images;
+    for(int i = 1; i < argc; i++) {
+        if(std::strcmp(argv[i], "-L") == 0) {
+            lsbFirst = true;
+        } else if(std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            bpp = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            lossyBits = std::stoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            unaryMaxWidth = std::stoi(argv[++i]);
+        } else if(argv[i][0] == '-') {
+            std::cerr << "Invalid flag: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        } else {
+            images.push_back(argv[i]);
+        }
+    }
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    createMissingDirectories(folder);
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, images.size());
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> failed{0};
+    std::atomic<std::uint64_t> bytesIn{0};
+    std::atomic<std::uint64_t> bytesOut{0};
+    std::uint64_t begin = getCurrentTimeMicros();
+    auto worker         = [&]() {
+        IngestImage image;
+        for(std::size_t i = next++; i < images.size(); i = next++) {
+            STATUS_t status = image.read(images[i].c_str(), bpp);
+            if(status) {
+                DecoderBase::handleReturnValue(status);
+                std::cerr << "Cannot read image " << images[i] << std::endl;
+                failed++;
+                continue;
+            }
+            const std::string name = std::filesystem::path(images[i]).stem().string();
+            const std::string path = std::string(folder) + "/compressed/" + name + ".bin";
+            std::ofstream wf(path, std::ios::out | std::ios::binary);
+            try {
+                if(!wf) {
+                    throw std::runtime_error("Cannot open specified file: " + path);
+                }
+                BayerView view = image.getView();
+                Encoder enc{view, folder, 0, 32, 8, lossyBits, unaryMaxWidth, image.getBpp(), 24, name.c_str()};
+                enc.setOutputStream(&wf);
+                enc.setBitOrderLSBFirst(lsbFirst);
+                enc.setDumpVerification(false);
+                enc.setVerbose(false);   // workers encode concurrently
+                enc.encodeUsingMethod(
+                   unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                            : Encoder::method::parallel_limited);
+                wf.close();
+                if(!wf) {
+                    throw std::runtime_error("Cannot write " + path);
+                }
+                bytesIn += view.width * view.height * (image.getBpp() > 8 ? 2 : 1);
+                bytesOut += enc.getFileSize();
+            } catch(const std::exception& e) {
+                std::cerr << images[i] << ": " << e.what() << std::endl;
+                failed++;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for(std::size_t t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for(auto& thread : pool) {
+        thread.join();
+    }
+
+    std::cout << "Ingested " << images.size() - failed << " of " << images.size() << " images on " << threads
+              << " threads, " << bytesIn << " -> " << bytesOut << " bytes in " << getCurrentTimeMicros() - begin
+              << "[us]" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 Params parseArguments(int argc, char* argv[])
 {
     Params params;
@@ -636,6 +1973,20 @@ Params parseArguments(int argc, char* argv[])
     params.header_bytes   = 16;
     params.bpp            = 8;
     params.use_gpu        = false;
+    params.lsb_first      = false;
+    params.header_version = OMLS_HEADER_VERSION;
+    params.planar         = false;
+    params.session        = false;
+    params.session_output = DecoderSession::output::bayer;
+    params.layout         = outputDescriptor_t{};
+    params.crop_flip      = false;
+    params.window[2]      = 0;
+    params.archive        = nullptr;
+    params.incremental    = false;
+    params.hash_inputs    = false;
+    params.direct_write   = false;
+    params.pad_alignment  = BITSTREAM_PAD_ALIGNMENT;
+    params.cfa_pattern    = cfaPattern::gbrg;
 
     if(argc == 1) {
         std::cout << "No arguments supplied." << std::endl;
@@ -694,6 +2045,108 @@ Params parseArguments(int argc, char* argv[])
                 params.bpp = std::stoi(argv[i + 1]);
             } else if(std::strcmp(flag, "-g") == 0) {
                 params.use_gpu = true;
+            } else if(std::strcmp(flag, "-L") == 0) {
+                params.lsb_first = true;
+                i--;   // single parameter
+            } else if(std::strcmp(flag, "-P") == 0) {
+                params.planar = true;
+                i--;   // single parameter
+            } else if(std::strcmp(flag, "-S") == 0) {
+                params.session = true;
+                i--;   // single parameter
+            } else if(std::strcmp(flag, "-Y") == 0) {
+                int previewBits = std::stoi(argv[i + 1]);
+                if(previewBits != 8 && previewBits != 16) {
+                    std::cerr << "Preview bits must be 8 or 16." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                params.session_output =
+                   previewBits == 8 ? DecoderSession::output::preview8 : DecoderSession::output::preview16;
+                params.session = true;
+            } else if(std::strcmp(flag, "-R") == 0) {
+                if(std::strcmp(argv[i + 1], "half") == 0) {
+                    params.session_output = DecoderSession::output::rgbHalf;
+                } else if(std::strcmp(argv[i + 1], "bilinear") == 0) {
+                    params.session_output = DecoderSession::output::rgbBilinear;
+                } else if(std::strcmp(argv[i + 1], "edge") == 0) {
+                    params.session_output = DecoderSession::output::rgbEdgeAware;
+                } else {
+                    std::cerr << "Invalid RGB mode: " << argv[i + 1] << std::endl;
+                    printHelp();
+                    exit(EXIT_FAILURE);
+                }
+                params.session = true;
+            } else if(std::strcmp(flag, "-C") == 0) {
+                if(sscanf(argv[i + 1],
+                          "%zu,%zu,%zu,%zu",
+                          &params.layout.cropX,
+                          &params.layout.cropY,
+                          &params.layout.cropWidth,
+                          &params.layout.cropHeight) != 4) {
+                    std::cerr << "Invalid crop rectangle: " << argv[i + 1] << std::endl;
+                    printHelp();
+                    exit(EXIT_FAILURE);
+                }
+                params.crop_flip = true;
+                params.session   = true;
+            } else if(std::strcmp(flag, "-I") == 0) {
+                params.incremental = true;
+                i--;
+            } else if(std::strcmp(flag, "-H") == 0) {
+                params.incremental = true;
+                params.hash_inputs = true;
+                i--;
+            } else if(std::strcmp(flag, "-D") == 0) {
+                params.direct_write = true;
+                i--;
+            } else if(std::strcmp(flag, "-a") == 0) {
+                params.pad_alignment = std::stoul(argv[i + 1]);
+                if(params.pad_alignment == 0) {
+                    std::cerr << "Pad alignment must not be 0." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            } else if(std::strcmp(flag, "-A") == 0) {
+                params.archive = argv[i + 1];
+                params.session = true;
+            } else if(std::strcmp(flag, "-W") == 0) {
+                if(sscanf(argv[i + 1],
+                          "%zu,%zu,%zu,%zu",
+                          &params.window[0],
+                          &params.window[1],
+                          &params.window[2],
+                          &params.window[3]) != 4) {
+                    std::cerr << "Invalid sensor window: " << argv[i + 1] << std::endl;
+                    printHelp();
+                    exit(EXIT_FAILURE);
+                }
+                if(params.window[2] % OMLS_SIZE_MULTIPLE || params.window[3] % OMLS_SIZE_MULTIPLE) {
+                    std::cerr << "Sensor window width and height must be multiples of " << OMLS_SIZE_MULTIPLE << ": "
+                              << argv[i + 1] << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            } else if(std::strcmp(flag, "-F") == 0) {
+                if(std::strcmp(argv[i + 1], "h") == 0) {
+                    params.layout.flipHorizontal = true;
+                } else if(std::strcmp(argv[i + 1], "v") == 0) {
+                    params.layout.flipVertical = true;
+                } else if(std::strcmp(argv[i + 1], "rot180") == 0) {
+                    params.layout.flipHorizontal = true;
+                    params.layout.flipVertical   = true;
+                } else {
+                    std::cerr << "Invalid flip: " << argv[i + 1] << std::endl;
+                    printHelp();
+                    exit(EXIT_FAILURE);
+                }
+                params.crop_flip = true;
+                params.session   = true;
+            } else if(std::strcmp(flag, "-B") == 0) {
+                if(!parseCfaPattern(argv[i + 1], params.cfa_pattern)) {
+                    std::cerr << "Invalid CFA pattern: " << argv[i + 1] << std::endl;
+                    printHelp();
+                    exit(EXIT_FAILURE);
+                }
+            } else if(std::strcmp(flag, "-V") == 0) {
+                params.header_version = std::stoi(argv[i + 1]);
             } else {
                 std::cerr << "Invalid flag: " << flag << std::endl;
                 printHelp();
@@ -722,6 +2175,12 @@ Params parseArguments(int argc, char* argv[])
         exit(EXIT_FAILURE);
     }
 
+    if(params.planar && params.header_version < 2) {
+        std::cerr << "Channel planar format requires header version 2 (channel offsets are stored in the header)."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     if(params.header_bytes == 0) {
         if(params.width == 0 || params.height == 0) {
             std::cerr << "Missing width and height info. Specify width and height by -x and -y flags, respectively"
@@ -773,6 +2232,17 @@ Params parseArguments(int argc, char* argv[])
     std::cout << "      bits per pixel: " << params.bpp << std::endl;
     std::cout << "       compress flag: " << (params.compress ? "true" : "false") << std::endl;
     std::cout << "     decompress flag: " << (params.decompress ? "true" : "false") << std::endl;
+    std::cout << "           bit order: " << (params.lsb_first ? "LSB first" : "MSB first") << std::endl;
+    std::cout << "      header version: " << params.header_version << std::endl;
+    std::cout << "      channel planar: " << (params.planar ? "true" : "false") << std::endl;
+    std::cout << "     decoder session: " << (params.session ? "true" : "false") << std::endl;
+    std::cout << "      session output: " << unsigned(params.session_output) << std::endl;
+    if(params.crop_flip) {
+        std::cout << "                crop: " << params.layout.cropX << "," << params.layout.cropY << ","
+                  << params.layout.cropWidth << "," << params.layout.cropHeight << std::endl;
+        std::cout << "                flip: " << (params.layout.flipHorizontal ? "h" : "")
+                  << (params.layout.flipVertical ? "v" : "") << std::endl;
+    }
     std::cout << " ideal compress flag: " << (params.ideal_compress ? "true" : "false") << std::endl;
     std::cout << "        header_bytes: " << params.header_bytes << std::endl;
     if(params.header_bytes == 0) {
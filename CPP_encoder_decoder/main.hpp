@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "DecoderSession.hpp"
 #include <cstdint>
 
 // https://stackoverflow.com/questions/8526598/how-does-stdforward-work
@@ -21,10 +22,33 @@ struct Params {
     bool decompress;
     bool ideal_compress;
     bool use_gpu;
+    bool lsb_first;
+    std::uint16_t header_version;
+    bool planar;
+    bool session;
+    DecoderSession::output session_output;
+    outputDescriptor_t layout;   // crop and flips of session decoding (-C, -F)
+    bool crop_flip;
+    std::size_t window[4];   // sensor window x, y, width, height compressed from each frame (-W), width 0 = whole
+    const char* archive;   // archive in compressed folder used instead of a file per frame (-A)
+    bool incremental;   // skip frames that are up to date in the manifest (-I)
+    bool hash_inputs;   // also compare input contents (-H)
+    bool direct_write;   // write compressed frames through FrameWriter, O_DIRECT where possible (-D)
+    std::size_t pad_alignment;   // compressed files padded to a multiple of this (-a)
+    cfaPattern cfa_pattern;   // CFA pattern of input frames (-B)
 };
 
 void printHelp();
 Params parseArguments(int argc, char* argv[]);
+int runProbe(int argc, char* argv[]);
+int runBenchWrite(int argc, char* argv[]);
+int runRingEncode(int argc, char* argv[]);
+int runDaemon(int argc, char* argv[]);
+int runEncodeStream(int argc, char* argv[]);
+int runDecodeStream(int argc, char* argv[]);
+int runIngest(int argc, char* argv[]);
+int runLineEncode(int argc, char* argv[]);
+int runLineDecode(int argc, char* argv[]);
 
 std::uint64_t getCurrentTimeMicros();
 
@@ -43,7 +67,17 @@ void compressImageRangeAGOR(
    std::vector<std::uint32_t>* A_init,
    std::size_t lossyBits,
    std::vector<std::size_t>* imageSizes,
-   std::size_t headerBytes);
+   std::size_t headerBytes,
+   bool lsbFirst,
+   std::uint16_t headerVersion,
+   bool planar,
+   const std::size_t* window = nullptr,
+   const char* archive       = nullptr,
+   bool incremental          = false,
+   bool hashInputs           = false,
+   bool directWrite          = false,
+   std::size_t padAlignment  = BITSTREAM_PAD_ALIGNMENT,
+   cfaPattern cfa            = cfaPattern::gbrg);
 void compressImageRangeIdeal(
    const char* fileName,
    const char* folder_in,
@@ -70,6 +104,17 @@ void decompressImageRangeAGOR(
    std::size_t headerBytes,
    bool use_gpu);
 
+void decompressImageRangeSession(
+   const char* fileName,
+   const char* folder_in,
+   const char* folder_out,
+   std::size_t imgIdx_min,
+   std::size_t imgIdx_max,
+   std::size_t headerBytes,
+   DecoderSession::output output,
+   const outputDescriptor_t* pLayout,
+   const char* archive = nullptr);
+
 void runTests();
 void createMissingDirectories(const char* folder_out);
 void translateBinaryToASCII_hex(char* fileNameIn);
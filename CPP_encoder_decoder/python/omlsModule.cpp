@@ -0,0 +1,509 @@
+/*
+* Python extension module omls, built by setup.py. Frames are passed through the buffer protocol: encode() reads 2D
+* uint16 arrays in place (any row stride) and writes straight into the returned bytes object, decode() writes
+* straight into the returned numpy array. The GIL is released while frames are coded, batch functions code a list of
+* frames on a pool of threads.
+*/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "DecoderSession.hpp"
+#include "Encoder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ENCODE_OUTPUT_SLACK 64 /* Bytes reserved for header, last bitstream word and padding of encode() output */
+
+/*
+* Owns a buffer acquired from a Python object, released with the GIL held when it goes out of scope.
+*/
+struct pyBuffer_t {
+    Py_buffer view{};
+    bool acquired = false;
+
+    pyBuffer_t() = default;
+    pyBuffer_t(const pyBuffer_t&) = delete;
+    pyBuffer_t(pyBuffer_t&& other) noexcept
+       : view(other.view)
+       , acquired(other.acquired)
+    {
+        other.acquired = false;
+    }
+    ~pyBuffer_t()
+    {
+        if(acquired) {
+            PyBuffer_Release(&view);
+        }
+    }
+
+    bool get(PyObject* pObject, int flags)
+    {
+        acquired = PyObject_GetBuffer(pObject, &view, flags) == 0;
+        return acquired;
+    }
+};
+
+struct encodeParams_t {
+    unsigned int bpp           = 0;   // 0: 8 for uint8 frames
+    unsigned int lossyBits     = 0;
+    unsigned int unaryMaxWidth = C_MAX_UNARY_LENGTH;
+    bool lsbFirst              = false;
+    cfaPattern cfa             = cfaPattern::gbrg;
+};
+
+/*
+* Put area over the storage of a bytes object, overflow fails the stream.
+*/
+class bytesBuffer_t : public std::streambuf
+{
+  public:
+    bytesBuffer_t(char* pData, std::size_t capacity)
+    {
+        setp(pData, pData + capacity);
+    }
+    std::size_t size() const
+    {
+        return pptr() - pbase();
+    }
+};
+
+/*
+* One frame to encode: a view of the caller's uint16 samples, or of samples widened from uint8 into own storage.
+* Compressed frame is written to pOutput, or to overflow if it does not fit, see encodeCapacity().
+*/
+struct encodeJob_t {
+    BayerView view;
+    std::uint8_t bpp = 8;
+    std::vector<std::uint16_t> widened;
+    PyObject* pOutput = nullptr;   // bytes object, released with the GIL held unless handed over
+    std::size_t size  = 0;
+    std::string overflow;
+    std::string error;
+
+    encodeJob_t() = default;
+    encodeJob_t(const encodeJob_t&) = delete;
+    ~encodeJob_t()
+    {
+        Py_XDECREF(pOutput);
+    }
+};
+
+struct decodeJob_t {
+    const std::uint8_t* data = nullptr;
+    std::size_t size         = 0;
+    outputDescriptor_t out{};
+    STATUS_t status = BASE_SUCCESS;
+};
+
+static PyObject* g_pNumpyEmpty = nullptr;
+
+/**
+ * Bytes allocated for the output of @param job: every sample codes to at most unaryMaxWidth + bpp + 3 bits, the
+ * unary part is counted up to bpp bits. Only frames coded with a longer unary limit may not fit.
+*/
+static std::size_t encodeCapacity(const encodeJob_t& job, const encodeParams_t& params)
+{
+    const std::size_t unary = std::min<std::size_t>(params.unaryMaxWidth, job.bpp);
+    const std::size_t bits  = job.view.width * job.view.height * (unary + job.bpp + 3);
+    return (bits + 7) / 8 + OMLS_HEADER_V2_SIZE + ENCODE_OUTPUT_SLACK;
+}
+
+/**
+ * Checks @param buffer is a 2D uint8 or uint16 frame the decoder can read and contiguous rows, points @param job to
+ * its samples and allocates its output. Sets a Python exception and returns false otherwise.
+*/
+static bool prepareEncodeJob(const Py_buffer& buffer, const encodeParams_t& params, encodeJob_t& job)
+{
+    const char* format = buffer.format ? buffer.format : "B";
+    if(format[0] == '<' || format[0] == '=' || format[0] == '@') {
+        format++;
+    }
+    const bool is8bit  = buffer.itemsize == 1 && format[0] == 'B';
+    const bool is16bit = buffer.itemsize == 2 && format[0] == 'H';
+    if(buffer.ndim != 2 || (!is8bit && !is16bit) || format[1] != '\0') {
+        PyErr_SetString(PyExc_TypeError, "frame must be a 2D uint8 or uint16 array");
+        return false;
+    }
+    const Py_ssize_t height = buffer.shape[0];
+    const Py_ssize_t width  = buffer.shape[1];
+    const Py_ssize_t pitch  = buffer.strides[0];
+    if(width <= 0 || height <= 0 || width % OMLS_SIZE_MULTIPLE || height % OMLS_SIZE_MULTIPLE) {
+        PyErr_SetString(PyExc_ValueError, "frame width and height must be non-zero multiples of 16");
+        return false;
+    }
+    if(buffer.strides[1] != buffer.itemsize || pitch < width * buffer.itemsize || pitch % buffer.itemsize) {
+        PyErr_SetString(PyExc_ValueError, "frame rows must be contiguous and must not overlap");
+        return false;
+    }
+    if(is16bit && !params.bpp) {
+        PyErr_SetString(PyExc_ValueError, "bpp is required for uint16 frames");
+        return false;
+    }
+    job.bpp         = params.bpp ? params.bpp : 8;
+    job.view.width  = width;
+    job.view.height = height;
+    job.pOutput     = PyBytes_FromStringAndSize(nullptr, encodeCapacity(job, params));
+    if(!job.pOutput) {
+        return false;
+    }
+    if(is16bit) {
+        job.view.data  = static_cast<const std::uint16_t*>(buffer.buf);
+        job.view.pitch = pitch / sizeof(std::uint16_t);
+        return true;
+    }
+    job.widened.resize(width * height);
+    for(Py_ssize_t y = 0; y < height; y++) {
+        const std::uint8_t* pRow = static_cast<const std::uint8_t*>(buffer.buf) + y * pitch;
+        std::copy(pRow, pRow + width, job.widened.begin() + y * width);
+    }
+    job.view.data  = job.widened.data();
+    job.view.pitch = width;
+    return true;
+}
+
+/**
+ * Encodes @param job into @param pOut.
+*/
+static void encodeFrame(encodeJob_t& job, const encodeParams_t& params, std::ostream* pOut)
+{
+    Encoder enc{job.view, ".", 0, 32, 8, params.lossyBits, params.unaryMaxWidth, job.bpp, 24, "python_"};
+    enc.setOutputStream(pOut);
+    enc.setBitOrderLSBFirst(params.lsbFirst);
+    enc.setCfaPattern(params.cfa);
+    enc.setVerbose(false);   // jobs of encode_batch run concurrently
+    enc.setDumpVerification(false);
+    enc.encodeUsingMethod(
+       params.unaryMaxWidth == C_MAX_UNARY_LENGTH_FULL ? Encoder::method::parallel_standard
+                                                       : Encoder::method::parallel_limited);
+}
+
+/**
+ * Encodes @param job into its bytes object, a frame that does not fit is encoded again into job.overflow. Runs
+ * without the GIL, errors are kept in job.error.
+*/
+static void runEncodeJob(encodeJob_t& job, const encodeParams_t& params)
+{
+    try {
+        bytesBuffer_t buffer(PyBytes_AS_STRING(job.pOutput), PyBytes_GET_SIZE(job.pOutput));
+        std::ostream stream(&buffer);
+        encodeFrame(job, params, &stream);
+        if(stream) {
+            job.size = buffer.size();
+            return;
+        }
+        std::ostringstream overflow;
+        encodeFrame(job, params, &overflow);
+        job.overflow = overflow.str();
+    } catch(const std::exception& e) {
+        job.error = e.what();
+    }
+}
+
+/**
+ * Hands the encoded bytes object of @param job over to the caller, trimmed to the compressed size. Needs the GIL.
+*/
+static PyObject* takeEncodeOutput(encodeJob_t& job)
+{
+    if(!job.overflow.empty()) {
+        return PyBytes_FromStringAndSize(job.overflow.data(), job.overflow.size());
+    }
+    PyObject* pBytes = job.pOutput;
+    job.pOutput      = nullptr;
+    if(_PyBytes_Resize(&pBytes, job.size)) {   // shrinks in place, frees the object on failure
+        return nullptr;
+    }
+    return pBytes;
+}
+
+/**
+ * Decodes @param job into the caller's array. Runs without the GIL, every thread reuses its own session buffers.
+*/
+static void runDecodeJob(decodeJob_t& job)
+{
+    static thread_local DecoderSession session;
+    job.status = session.load(job.data, job.size);
+    if(job.status == BASE_SUCCESS) {
+        job.status = session.decodeInto(job.out);
+    }
+}
+
+/**
+ * Runs @param job for indices 0 .. @param count - 1 on @param threads threads (0: one per core).
+*/
+template<typename F>
+static void runPool(std::size_t count, std::size_t threads, F job)
+{
+    if(!threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, count);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for(std::size_t i = next++; i < count; i = next++) {
+            job(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for(std::size_t i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& t : pool) {
+        t.join();
+    }
+}
+
+/**
+ * Parses header of @param buffer and creates the numpy array it decodes into, (height, width) uint8 for 8 bpp
+ * streams, uint16 otherwise. Fills @param job, the array stays referenced by @param output.
+*/
+static PyObject* prepareDecodeJob(const Py_buffer& buffer, pyBuffer_t& output, decodeJob_t& job)
+{
+    headerData_t header;
+    job.data = static_cast<const std::uint8_t*>(buffer.buf);
+    job.size = buffer.len;
+    if(Reader::getHeader(job.data, job.size, header) != BASE_SUCCESS) {
+        PyErr_SetString(PyExc_ValueError, "not an OMLS stream");
+        return nullptr;
+    }
+    const bool is8bit = header.bpp <= 8;
+    PyObject* pArray  = PyObject_CallFunction(
+       g_pNumpyEmpty, "((II)s)", (unsigned int)header.height, (unsigned int)header.width, is8bit ? "uint8" : "uint16");
+    if(!pArray) {
+        return nullptr;
+    }
+    if(!output.get(pArray, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS)) {
+        Py_DECREF(pArray);
+        return nullptr;
+    }
+    job.out.data   = output.view.buf;
+    job.out.pitch  = (std::size_t)header.width * (is8bit ? 1 : 2);
+    job.out.format = is8bit ? outputDescriptor_t::pixelFormat::u8 : outputDescriptor_t::pixelFormat::u16;
+    return pArray;
+}
+
+static bool parseEncodeParams(PyObject* pKwargs, encodeParams_t& params, Py_ssize_t* pThreads)
+{
+    static const char* keywords[] = {"bpp", "lossy_bits", "unary_max_width", "lsb_first", "cfa", nullptr};
+    static const char* batchKeywords[] = {
+       "bpp", "lossy_bits", "unary_max_width", "lsb_first", "cfa", "threads", nullptr};
+    PyObject* pEmpty = PyTuple_New(0);
+    int lsbFirst     = 0;
+    const char* cfa  = "GBRG";
+    bool ok          = PyArg_ParseTupleAndKeywords(
+       pEmpty,
+       pKwargs,
+       pThreads ? "|$IIIpsn" : "|$IIIps",
+       const_cast<char**>(pThreads ? batchKeywords : keywords),
+       &params.bpp,
+       &params.lossyBits,
+       &params.unaryMaxWidth,
+       &lsbFirst,
+       &cfa,
+       pThreads);
+    Py_DECREF(pEmpty);
+    params.lsbFirst = lsbFirst;
+    if(ok && (params.bpp > 16 || params.unaryMaxWidth == 0)) {
+        PyErr_SetString(PyExc_ValueError, "invalid bpp or unary_max_width");
+        ok = false;
+    }
+    if(ok && !parseCfaPattern(cfa, params.cfa)) {
+        PyErr_SetString(PyExc_ValueError, "cfa must be GBRG, RGGB, BGGR or GRBG");
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * encode(frame, *, bpp=0, lossy_bits=0, unary_max_width=8, lsb_first=False, cfa='GBRG') -> bytes
+*/
+static PyObject* omlsEncode(PyObject*, PyObject* pArgs, PyObject* pKwargs)
+{
+    PyObject* pFrame;
+    encodeParams_t params;
+    if(!PyArg_ParseTuple(pArgs, "O", &pFrame) || !parseEncodeParams(pKwargs, params, nullptr)) {
+        return nullptr;
+    }
+    pyBuffer_t input;
+    encodeJob_t job;
+    if(!input.get(pFrame, PyBUF_STRIDES | PyBUF_FORMAT) || !prepareEncodeJob(input.view, params, job)) {
+        return nullptr;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    runEncodeJob(job, params);
+    Py_END_ALLOW_THREADS
+
+    if(!job.error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, job.error.c_str());
+        return nullptr;
+    }
+    return takeEncodeOutput(job);
+}
+
+/**
+ * decode(data) -> numpy.ndarray
+*/
+static PyObject* omlsDecode(PyObject*, PyObject* pData)
+{
+    pyBuffer_t input;
+    pyBuffer_t output;
+    decodeJob_t job;
+    if(!input.get(pData, PyBUF_SIMPLE)) {
+        return nullptr;
+    }
+    PyObject* pArray = prepareDecodeJob(input.view, output, job);
+    if(!pArray) {
+        return nullptr;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    runDecodeJob(job);
+    Py_END_ALLOW_THREADS
+
+    if(job.status != BASE_SUCCESS) {
+        Py_DECREF(pArray);
+        return PyErr_Format(PyExc_ValueError, "OMLS stream cannot be decoded, status %d", (int)job.status);
+    }
+    return pArray;
+}
+
+/**
+ * encode_batch(frames, *, bpp=0, lossy_bits=0, unary_max_width=8, lsb_first=False, cfa='GBRG', threads=0)
+ *    -> list of bytes
+*/
+static PyObject* omlsEncodeBatch(PyObject*, PyObject* pArgs, PyObject* pKwargs)
+{
+    PyObject* pFrames;
+    encodeParams_t params;
+    Py_ssize_t threads = 0;
+    if(!PyArg_ParseTuple(pArgs, "O", &pFrames) || !parseEncodeParams(pKwargs, params, &threads)) {
+        return nullptr;
+    }
+    PyObject* pSequence = PySequence_Fast(pFrames, "frames must be a sequence");
+    if(!pSequence) {
+        return nullptr;
+    }
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(pSequence);
+    std::vector<pyBuffer_t> inputs(count);
+    std::vector<encodeJob_t> jobs(count);
+    for(Py_ssize_t i = 0; i < count; i++) {
+        if(!inputs[i].get(PySequence_Fast_GET_ITEM(pSequence, i), PyBUF_STRIDES | PyBUF_FORMAT)
+           || !prepareEncodeJob(inputs[i].view, params, jobs[i])) {
+            Py_DECREF(pSequence);
+            return nullptr;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    runPool(count, threads < 0 ? 0 : threads, [&](std::size_t i) { runEncodeJob(jobs[i], params); });
+    Py_END_ALLOW_THREADS
+
+    PyObject* pResult = PyList_New(count);
+    for(Py_ssize_t i = 0; pResult && i < count; i++) {
+        PyObject* pBytes = nullptr;
+        if(!jobs[i].error.empty()) {
+            PyErr_Format(PyExc_RuntimeError, "frame %zd: %s", i, jobs[i].error.c_str());
+        } else {
+            pBytes = takeEncodeOutput(jobs[i]);
+        }
+        if(!pBytes) {
+            Py_CLEAR(pResult);
+            break;
+        }
+        PyList_SET_ITEM(pResult, i, pBytes);
+    }
+    Py_DECREF(pSequence);
+    return pResult;
+}
+
+/**
+ * decode_batch(data, *, threads=0) -> list of numpy.ndarray
+*/
+static PyObject* omlsDecodeBatch(PyObject*, PyObject* pArgs, PyObject* pKwargs)
+{
+    static const char* keywords[] = {"data", "threads", nullptr};
+    PyObject* pData;
+    Py_ssize_t threads = 0;
+    if(!PyArg_ParseTupleAndKeywords(pArgs, pKwargs, "O|$n", const_cast<char**>(keywords), &pData, &threads)) {
+        return nullptr;
+    }
+    PyObject* pSequence = PySequence_Fast(pData, "data must be a sequence");
+    if(!pSequence) {
+        return nullptr;
+    }
+    const Py_ssize_t count = PySequence_Fast_GET_SIZE(pSequence);
+    std::vector<pyBuffer_t> inputs(count);
+    std::vector<pyBuffer_t> outputs(count);
+    std::vector<decodeJob_t> jobs(count);
+    PyObject* pResult = PyList_New(count);
+    for(Py_ssize_t i = 0; pResult && i < count; i++) {
+        PyObject* pArray = nullptr;
+        if(inputs[i].get(PySequence_Fast_GET_ITEM(pSequence, i), PyBUF_SIMPLE)) {
+            pArray = prepareDecodeJob(inputs[i].view, outputs[i], jobs[i]);
+        }
+        if(!pArray) {
+            Py_CLEAR(pResult);
+            break;
+        }
+        PyList_SET_ITEM(pResult, i, pArray);
+    }
+    if(!pResult) {
+        Py_DECREF(pSequence);
+        return nullptr;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    runPool(count, threads < 0 ? 0 : threads, [&](std::size_t i) { runDecodeJob(jobs[i]); });
+    Py_END_ALLOW_THREADS
+
+    Py_DECREF(pSequence);
+    for(Py_ssize_t i = 0; i < count; i++) {
+        if(jobs[i].status != BASE_SUCCESS) {
+            Py_DECREF(pResult);
+            return PyErr_Format(
+               PyExc_ValueError, "frame %zd: OMLS stream cannot be decoded, status %d", i, (int)jobs[i].status);
+        }
+    }
+    return pResult;
+}
+
+static PyMethodDef omlsMethods[] = {
+   {"encode",
+    (PyCFunction)(void (*)(void))omlsEncode,
+    METH_VARARGS | METH_KEYWORDS,
+    "encode(frame, *, bpp=0, lossy_bits=0, unary_max_width=8, lsb_first=False, cfa='GBRG') -> bytes\n"
+    "Compresses 2D uint8 or uint16 BayerCFA frame, width and height multiples of 16. bpp is required for uint16 "
+    "frames."},
+   {"decode", omlsDecode, METH_O, "decode(data) -> numpy.ndarray\nDecompresses one OMLS stream."},
+   {"encode_batch",
+    (PyCFunction)(void (*)(void))omlsEncodeBatch,
+    METH_VARARGS | METH_KEYWORDS,
+    "encode_batch(frames, *, bpp=0, lossy_bits=0, unary_max_width=8, lsb_first=False, cfa='GBRG', threads=0) "
+    "-> list\n"
+    "Compresses frames on threads threads, 0: one per core."},
+   {"decode_batch",
+    (PyCFunction)(void (*)(void))omlsDecodeBatch,
+    METH_VARARGS | METH_KEYWORDS,
+    "decode_batch(data, *, threads=0) -> list\nDecompresses OMLS streams on threads threads, 0: one per core."},
+   {nullptr, nullptr, 0, nullptr}};
+
+static PyModuleDef omlsModule = {
+   PyModuleDef_HEAD_INIT, "omls", "Lossless BayerCFA compression (OMLS).", -1, omlsMethods};
+
+PyMODINIT_FUNC PyInit_omls()
+{
+    PyObject* pNumpy = PyImport_ImportModule("numpy");
+    if(!pNumpy) {
+        return nullptr;
+    }
+    g_pNumpyEmpty = PyObject_GetAttrString(pNumpy, "empty");
+    Py_DECREF(pNumpy);
+    if(!g_pNumpyEmpty) {
+        return nullptr;
+    }
+    return PyModule_Create(&omlsModule);
+}
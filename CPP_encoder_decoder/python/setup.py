@@ -0,0 +1,39 @@
+import os
+import sys
+from setuptools import setup, Extension
+
+# Builds Python extension module omls (omlsModule.cpp) from codec sources in the parent folder.
+# Run `python setup.py build_ext --inplace` in this folder. numpy is needed at runtime only, decode() returns arrays.
+
+codec_dir = ".."
+codec_sources = [
+    "Encoder.cpp",
+    "ImageYCCC.cpp",
+    "Image.cpp",
+    "Channels.cpp",
+    "helpers.cpp",
+    "DecoderBase.cpp",
+    "DecoderSession.cpp",
+]
+sources = ["omlsModule.cpp"] + [os.path.join(codec_dir, source) for source in codec_sources]
+
+if sys.platform == "win32" and "mingw" not in sys.version.lower():
+    compile_args = ["/std:c++20", "/O2"]
+else:
+    compile_args = ["-std=c++20", "-O2"]
+
+setup(
+    name="omls",
+    version="1.0",
+    description="Lossless BayerCFA compression (OMLS)",
+    ext_modules=[
+        Extension(
+            "omls",
+            sources=sources,
+            include_dirs=[codec_dir],
+            define_macros=[("OMLS_NO_DUMP_VERIFICATION", None)],
+            extra_compile_args=compile_args,
+        )
+    ],
+    install_requires=["numpy"],
+)
@@ -0,0 +1,212 @@
+/*
+* Checks that DecoderSession decodes a stream of frames without heap allocation once it has seen the largest
+* frame, or once reserve() was called. Every operator new of the process is counted; frames are encoded first,
+* then decoded in a warm-up round and a steady-state loop, which must not allocate. Parallel and channel planar
+* frames are decoded in every output mode and with decodeInto() to a cropped and flipped caller buffer. Decoded
+* frames are compared with the originals.
+*/
+#include "DecoderSession.hpp"
+#include "testFrames.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
+static std::atomic<std::size_t> g_allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    g_allocationCount++;
+    if(void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    g_allocationCount++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if(void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+static bool matches(const DecoderSession& session, const frame_t& frame)
+{
+    for(std::size_t i = 0; i < frame.samples.size(); i++) {
+        std::uint16_t value = frame.bpp == 8 ? session.getOutput8bit()[i] : session.getOutput16bit()[i];
+        if(value != frame.samples[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks @param out, filled by decodeInto() with 16-bit samples, against the crop and flips of @param frame.
+*/
+static bool matchesCrop(const outputDescriptor_t& out, const frame_t& frame)
+{
+    for(std::size_t y = 0; y < out.cropHeight; y++) {
+        const std::uint16_t* row = (const std::uint16_t*)((const std::uint8_t*)out.data + y * out.pitch);
+        for(std::size_t x = 0; x < out.cropWidth; x++) {
+            std::size_t srcX = out.cropX + (out.flipHorizontal ? out.cropWidth - 1 - x : x);
+            std::size_t srcY = out.cropY + (out.flipVertical ? out.cropHeight - 1 - y : y);
+            if(row[x] != frame.samples[srcY * frame.width + srcX]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Counts heap allocations of one decode of @param frame to session output, 0 if decoding failed.
+*/
+static std::size_t decodeCounted(DecoderSession& session, const frame_t& frame, STATUS_t& status)
+{
+    std::size_t allocationsBefore = g_allocationCount;
+    status = session.decode((const std::uint8_t*)frame.compressed.data(), frame.compressed.size());
+    return g_allocationCount - allocationsBefore;
+}
+
+int main()
+{
+    const std::string folderOut = (std::filesystem::temp_directory_path() / "omls_allocation_test").string();
+    std::filesystem::create_directories(folderOut);
+
+    std::vector<frame_t> frames;
+    frames.push_back(makeFrame(128, 64, 12, 1));
+    frames.push_back(makeFrame(256, 128, 8, 2));   // largest frame
+    frames.push_back(makeFrame(64, 32, 10, 3));
+    frames.push_back(makeFrame(256, 128, 12, 4));
+    frames.push_back(makeFrame(96, 48, 10, 5));
+    frames.push_back(makeFrame(192, 96, 8, 6));
+    frames[2].lsbFirst = true;
+    frames[3].lsbFirst = true;
+    frames[4].planar   = true;
+    frames[5].planar   = true;
+    frames[5].lsbFirst = true;
+    std::size_t maxFileSize = 0;
+    for(frame_t& frame : frames) {
+        if(!encodeFrame(frame, folderOut.c_str())) {
+            std::printf("FAIL: encoding produced no output\n");
+            return 1;
+        }
+        maxFileSize = std::max(maxFileSize, frame.compressed.size());
+    }
+
+    const DecoderSession::output outputs[] = {
+       DecoderSession::output::bayer,
+       DecoderSession::output::preview8,
+       DecoderSession::output::preview16,
+       DecoderSession::output::rgbHalf,
+       DecoderSession::output::rgbBilinear,
+       DecoderSession::output::rgbEdgeAware};
+    DecoderSession session;
+
+    for(std::size_t round = 0; round < 4; round++) {   // round 0 is warm-up
+        for(DecoderSession::output out : outputs) {
+            session.setOutput(out);
+            for(const frame_t& frame : frames) {
+                STATUS_t status;
+                std::size_t allocations = decodeCounted(session, frame, status);
+                if(status) {
+                    std::printf("FAIL: decoding returned %u\n", (unsigned)status);
+                    return 1;
+                }
+                if(out == DecoderSession::output::bayer && !matches(session, frame)) {
+                    std::printf(
+                       "FAIL: %zu x %zu %u bpp frame decoded incorrectly\n", frame.width, frame.height, frame.bpp);
+                    g_failures++;
+                }
+                if(round > 0 && allocations) {
+                    std::printf(
+                       "FAIL: %zu heap allocations decoding %zu x %zu %u bpp frame in round %zu\n",
+                       allocations,
+                       frame.width,
+                       frame.height,
+                       frame.bpp,
+                       round);
+                    g_failures++;
+                }
+            }
+        }
+    }
+
+    // Caller buffer: cropped, flipped, rows padded to full frame width
+    std::vector<std::uint16_t> cropBuffer(256 * 128);
+    for(const frame_t& frame : frames) {
+        for(unsigned flips = 0; flips < 4; flips++) {
+            outputDescriptor_t out{
+               cropBuffer.data(), frame.width * sizeof(std::uint16_t), outputDescriptor_t::pixelFormat::u16};
+            out.cropX          = 6;
+            out.cropY          = 4;
+            out.cropWidth      = frame.width - 16;
+            out.cropHeight     = frame.height - 10;
+            out.flipHorizontal = flips & 1;
+            out.flipVertical   = flips & 2;
+            STATUS_t status = session.load((const std::uint8_t*)frame.compressed.data(), frame.compressed.size());
+            check(status == BASE_SUCCESS, "frame does not load");
+            std::size_t allocationsBefore = g_allocationCount;
+            check(session.decodeInto(out) == BASE_SUCCESS, "decodeInto() failed");
+            check(g_allocationCount == allocationsBefore, "decodeInto() allocates");
+            check(matchesCrop(out, frame), "decodeInto() output differs from cropped and flipped frame");
+        }
+    }
+
+    // Fresh session: reserve() must be enough for the first frame in every output mode
+    for(DecoderSession::output out : outputs) {
+        DecoderSession reserved;
+        reserved.reserve(maxFileSize, 256, 128);
+        reserved.setOutput(out);
+        for(const frame_t& frame : frames) {
+            STATUS_t status;
+            std::size_t allocations = decodeCounted(reserved, frame, status);
+            check(status == BASE_SUCCESS, "decoding after reserve() failed");
+            if(allocations) {
+                std::printf(
+                   "FAIL: %zu heap allocations decoding %zu x %zu %u bpp frame after reserve() in output mode %d\n",
+                   allocations,
+                   frame.width,
+                   frame.height,
+                   frame.bpp,
+                   (int)out);
+                g_failures++;
+            }
+        }
+    }
+
+    std::filesystem::remove_all(folderOut);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: no heap allocations in steady-state decoding\n");
+    return 0;
+}
@@ -0,0 +1,85 @@
+/*
+* Checks that an archive survives a writer that never closes it. Frames are appended to a closed archive, the
+* file is copied while the writer is still open and the copy is cut in the middle of the last frame, as after
+* a crash. The copy must still open, give back every complete frame, and accept new frames.
+*/
+#include "Archive.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Checks that archive @param fileName holds exactly @param frames, frame i with frame id i.
+*/
+static void checkArchive(const std::string& fileName, const std::vector<std::string>& frames)
+{
+    ArchiveReader reader;
+    if(reader.open(fileName.c_str())) {
+        check(false, "archive does not open");
+        return;
+    }
+    check(reader.getFrameCount() == frames.size(), "wrong number of frames in archive");
+    std::vector<std::uint8_t> data;
+    for(std::size_t i = 0; i < frames.size() && i < reader.getFrameCount(); i++) {
+        std::size_t index = 0;
+        check(reader.findFrameId(i, index) == BASE_SUCCESS, "frame id not found");
+        check(reader.readFrame(index, data) == BASE_SUCCESS, "frame cannot be read");
+        check(std::string(data.begin(), data.end()) == frames[i], "frame read back differs");
+    }
+}
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    const fs::path folderOut  = fs::temp_directory_path() / "omls_archive_test";
+    const std::string archive = (folderOut / "frames.omlsa").string();
+    const std::string crashed = (folderOut / "crashed.omlsa").string();
+    fs::remove_all(folderOut);
+    fs::create_directories(folderOut);
+
+    std::vector<std::string> frames;
+    for(unsigned i = 0; i < 6; i++) {
+        frame_t frame = makeFrame(64 + 16 * i, 32, 10, i + 1);
+        check(encodeFrame(frame, folderOut.string().c_str()), "encoding produced no output");
+        frames.push_back(frame.compressed);
+    }
+
+    ArchiveWriter writer;
+    check(writer.open(archive.c_str()) == BASE_SUCCESS, "new archive cannot be created");
+    for(std::size_t i = 0; i < 3; i++) {
+        writer.append(i, (const std::uint8_t*)frames[i].data(), frames[i].size());
+    }
+    check(writer.close() == BASE_SUCCESS, "archive cannot be closed");
+    checkArchive(archive, {frames.begin(), frames.begin() + 3});
+
+    // Second session: copy taken while frames 3 and 4 are appended but the index is not written yet
+    check(writer.open(archive.c_str()) == BASE_SUCCESS, "closed archive cannot be reopened");
+    check(writer.getFrameCount() == 3, "reopened archive lost frames");
+    for(std::size_t i = 3; i < 5; i++) {
+        writer.append(i, (const std::uint8_t*)frames[i].data(), frames[i].size());
+    }
+    fs::copy_file(archive, crashed);
+    fs::resize_file(crashed, fs::file_size(crashed) - frames[4].size() / 2);   // crash in the middle of frame 4
+    check(writer.close() == BASE_SUCCESS, "archive cannot be closed");
+    checkArchive(archive, {frames.begin(), frames.begin() + 5});
+
+    // Crashed copy keeps frames 0 to 3, and continues with frame 4 appended again and frame 5
+    checkArchive(crashed, {frames.begin(), frames.begin() + 4});
+    check(writer.open(crashed.c_str()) == BASE_SUCCESS, "crashed archive cannot be reopened");
+    check(writer.getFrameCount() == 4, "crashed archive lost complete frames");
+    for(std::size_t i = 4; i < 6; i++) {
+        writer.append(i, (const std::uint8_t*)frames[i].data(), frames[i].size());
+    }
+    check(writer.close() == BASE_SUCCESS, "crashed archive cannot be closed");
+    checkArchive(crashed, frames);
+
+    fs::remove_all(folderOut);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: archive recovered after interrupted append\n");
+    return 0;
+}
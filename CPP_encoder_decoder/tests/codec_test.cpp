@@ -0,0 +1,112 @@
+/*
+* Checks lossless round trips over the supported sample widths (8 to 16 bpp), all four CFA patterns, both bit
+* orders and the parallel and channel planar formats. Frames are decoded by DecoderSession and by Decoder, the
+* latter with and without intermediate planes.
+*/
+#include "Decoder.hpp"
+#include "DecoderSession.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Decodes @param frame with Decoder and compares the exported BayerCFA samples with the original ones.
+*/
+static bool decoderMatches(const frame_t& frame, bool keepIntermediate, const std::string& fileName)
+{
+    Decoder dec{(const std::uint8_t*)frame.compressed.data(), frame.compressed.size(), 32, 8};
+    dec.setKeepIntermediate(keepIntermediate);
+    dec.decodeParallel();
+    dec.exportBayerImage(fileName.c_str(), (std::uint64_t)0, (std::uint64_t)0, (std::uint64_t)0);
+
+    std::ifstream rf(fileName, std::ios::binary);
+    std::vector<std::uint8_t> data{std::istreambuf_iterator<char>(rf), std::istreambuf_iterator<char>()};
+    const std::size_t sampleSize = frame.bpp == 8 ? 1 : 2;
+    if(data.size() != frame.samples.size() * sampleSize) {
+        return false;
+    }
+    for(std::size_t i = 0; i < frame.samples.size(); i++) {
+        std::uint16_t value = sampleSize == 1 ? data[i] : data[2 * i] | data[2 * i + 1] << 8;
+        if(value != frame.samples[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    const fs::path folderOut     = fs::temp_directory_path() / "omls_codec_test";
+    const std::string exportName = (folderOut / "decoded.bin").string();
+    fs::create_directories(folderOut);
+
+    const std::uint8_t bpps[]   = {8, 10, 12, 14, 16};
+    const cfaPattern patterns[] = {cfaPattern::gbrg, cfaPattern::rggb, cfaPattern::bggr, cfaPattern::grbg};
+    DecoderSession session;
+    unsigned seed = 1;
+
+    for(std::uint8_t bpp : bpps) {
+        for(cfaPattern cfa : patterns) {
+            for(unsigned variant = 0; variant < 4; variant++) {
+                frame_t frame  = makeFrame(64, 48, bpp, seed++);
+                frame.cfa      = cfa;
+                frame.lsbFirst = variant & 1;
+                frame.planar   = variant & 2;
+                if(frame.planar && bpp > OMLS_YCCC16_MAX_BPP) {
+                    continue;   // channel planar coding is limited to 12 bpp
+                }
+                char what[100];
+                std::snprintf(
+                   what,
+                   sizeof what,
+                   "%u bpp, CFA %s, %s first, %s",
+                   bpp,
+                   cfaPatternName(cfa),
+                   frame.lsbFirst ? "LSB" : "MSB",
+                   frame.planar ? "planar" : "parallel");
+                if(!encodeFrame(frame, folderOut.string().c_str())) {
+                    std::printf("FAIL: %s: encoding produced no output\n", what);
+                    g_failures++;
+                    continue;
+                }
+
+                if(session.decode((const std::uint8_t*)frame.compressed.data(), frame.compressed.size())) {
+                    std::printf("FAIL: %s: DecoderSession cannot decode frame\n", what);
+                    g_failures++;
+                    continue;
+                }
+                const headerData_t& header = session.getHeader();
+                bool same = header.width == frame.width && header.height == frame.height && header.bpp == bpp
+                            && cfaPatternFromFlags(header.flags) == cfa;
+                for(std::size_t i = 0; same && i < frame.samples.size(); i++) {
+                    same = (bpp == 8 ? session.getOutput8bit()[i] : session.getOutput16bit()[i]) == frame.samples[i];
+                }
+                if(!same) {
+                    std::printf("FAIL: %s: DecoderSession output differs\n", what);
+                    g_failures++;
+                }
+
+                for(bool keepIntermediate : {false, true}) {
+                    if(!decoderMatches(frame, keepIntermediate, exportName)) {
+                        std::printf(
+                           "FAIL: %s: Decoder output differs%s\n", what, keepIntermediate ? " (intermediate)" : "");
+                        g_failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    fs::remove_all(folderOut);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: lossless round trips for all sample widths, CFA patterns and formats\n");
+    return 0;
+}
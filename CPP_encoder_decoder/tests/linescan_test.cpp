@@ -0,0 +1,81 @@
+/*
+* Checks that a line-scan strip survives encoding and decoding segment by segment. Strip width and the rows of
+* the last segment are not multiples of 16, so segments are padded. A reader joining the stream in the middle of
+* a segment must find the next segment boundary.
+*/
+#include "LineScan.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    const fs::path folderOut = fs::temp_directory_path() / "omls_linescan_test";
+    fs::create_directories(folderOut);
+
+    const std::size_t width           = 100;
+    const std::size_t segmentRows[]   = {48, 40, 13};
+    const std::size_t height          = 48 + 40 + 13;
+    const frame_t strip               = makeFrame(width, height, 12, 7);
+    const std::uint64_t timestampBase = 1700000000000000;
+
+    FILE* pStream = std::tmpfile();
+    if(!pStream) {
+        std::printf("FAIL: cannot create temporary file\n");
+        return 1;
+    }
+    LineScanEncoder encoder{width, 12, 0, C_MAX_UNARY_LENGTH, folderOut.string().c_str()};
+    encoder.setCfaPattern(cfaPattern::rggb);
+    std::size_t firstRow          = 0;
+    std::size_t firstSegmentBytes = 0;
+    for(std::size_t rows : segmentRows) {
+        std::size_t bytes = 0;
+        STATUS_t status   = encoder.encode(
+           &strip.samples[firstRow * width], width, rows, timestampBase + firstRow, pStream, bytes);
+        check(status == BASE_SUCCESS, "segment cannot be encoded");
+        firstSegmentBytes = firstSegmentBytes ? firstSegmentBytes : bytes;
+        firstRow += rows;
+    }
+    check(encoder.getSegmentCount() == 3, "wrong segment count");
+    check(encoder.getRowCount() == height, "wrong row count");
+
+    // Whole stream
+    std::rewind(pStream);
+    LineScanDecoder decoder;
+    std::size_t segments = 0;
+    firstRow             = 0;
+    while(segments < 3 && decoder.read(pStream) == BASE_SUCCESS) {
+        const lineSegment_t& segment = decoder.getSegment();
+        check(decoder.decode() == BASE_SUCCESS, "segment cannot be decoded");
+        check(segment.index == segments && segment.firstRow == firstRow, "segment out of order");
+        check(segment.width == width && segment.rows == segmentRows[segments], "wrong segment size");
+        check(segment.timestamp == timestampBase + firstRow, "wrong segment timestamp");
+        bool same = true;
+        for(std::size_t i = 0; same && i < segment.rows * width; i++) {
+            same = decoder.getRows()[i] == strip.samples[firstRow * width + i];
+        }
+        check(same, "decoded rows differ");
+        firstRow += segment.rows;
+        segments++;
+    }
+    check(segments == 3 && firstRow == height, "segments lost");
+    check(decoder.read(pStream) == BASE_ERROR_ALL_BYTES_ALREADY_READ, "stream does not end cleanly");
+
+    // Joined in the middle of the first segment
+    std::fseek(pStream, (long)firstSegmentBytes / 2, SEEK_SET);
+    check(decoder.sync(pStream) == BASE_SUCCESS, "next segment not found");
+    check(decoder.read(pStream) == BASE_SUCCESS && decoder.decode() == BASE_SUCCESS, "synced segment not decoded");
+    check(decoder.getSegment().index == 1 && decoder.getSegment().firstRow == 48, "synced to wrong segment");
+
+    std::fclose(pStream);
+    fs::remove_all(folderOut);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: line-scan strip decoded by segments\n");
+    return 0;
+}
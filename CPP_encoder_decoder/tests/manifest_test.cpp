@@ -0,0 +1,85 @@
+/*
+* Checks that a batch manifest remembers finished inputs across sessions. An input is up to date only while its
+* size, contents and codec parameters are unchanged. Commas in input names and parameters are stored escaped,
+* and a line cut short by an interrupted batch is ignored.
+*/
+#include "Manifest.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static void writeFile(const std::string& fileName, const std::string& contents)
+{
+    std::ofstream wf(fileName, std::ios::binary | std::ios::trunc);
+    wf << contents;
+}
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    const fs::path folder       = fs::temp_directory_path() / "omls_manifest_test";
+    const std::string manifest  = (folder / "manifest.csv").string();
+    const std::string plain     = (folder / "img_00.bin").string();
+    const std::string commas    = (folder / "take 1,2%.bin").string();
+    const std::string params    = "bpp=12;out=a,b";
+    const std::string newParams = "bpp=10;out=a,b";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    writeFile(plain, "first frame");
+    writeFile(commas, "second frame");
+
+    manifestEntry_t entries[2];
+    for(std::size_t i = 0; i < 2; i++) {
+        check(Manifest::describe(i ? commas : plain, true, entries[i]) == BASE_SUCCESS, "input not described");
+        check(entries[i].hash != 0, "input not hashed");
+        entries[i].params = params;
+    }
+
+    {
+        Manifest first;
+        check(first.open(manifest.c_str()) == BASE_SUCCESS, "new manifest cannot be opened");
+        check(!first.isUpToDate(entries[0]), "input up to date in empty manifest");
+        check(first.record(entries[0]) == BASE_SUCCESS, "entry cannot be recorded");
+        check(first.record(entries[1]) == BASE_SUCCESS, "entry cannot be recorded");
+    }
+    {
+        std::ofstream wf(manifest, std::ios::binary | std::ios::app);
+        wf << "5,1,0,bpp=12,interrupted";   // no line end
+    }
+
+    Manifest second;
+    check(second.open(manifest.c_str()) == BASE_SUCCESS, "manifest cannot be reopened");
+    check(second.getEntryCount() == 2, "wrong number of entries read back");
+    check(second.isUpToDate(entries[0]), "finished input not up to date");
+    check(second.isUpToDate(entries[1]), "input with comma in name or parameters not up to date");
+
+    manifestEntry_t changed = entries[0];
+    changed.params          = newParams;
+    check(!second.isUpToDate(changed), "input up to date with other codec parameters");
+
+    writeFile(plain, "first frame");   // same contents, newer modification time
+    check(Manifest::describe(plain, true, changed) == BASE_SUCCESS, "input not described");
+    changed.params = params;
+    check(second.isUpToDate(changed), "rewritten input with same contents not up to date");
+    writeFile(plain, "other frame");   // same size, other contents
+    check(Manifest::describe(plain, true, changed) == BASE_SUCCESS, "input not described");
+    changed.params = params;
+    check(!second.isUpToDate(changed), "changed input up to date");
+
+    std::vector<manifestEntry_t> current;
+    std::vector<std::uint8_t> upToDate;
+    second.scan({plain, commas}, params, true, current, upToDate, 2);
+    check(upToDate.size() == 2 && !upToDate[0] && upToDate[1], "scan() disagrees with isUpToDate()");
+
+    second.close();
+    fs::remove_all(folder);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: manifest resumes batch\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+* Checks that a recording timeline is built from frame headers: frames of a directory and of an archive come out
+* sorted by timestamp with their frame ids, sizes and formats, and files that are not frames are counted as
+* failed. The binary index is checked against the entries.
+*/
+#include "Archive.hpp"
+#include "Probe.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    const fs::path folder        = fs::temp_directory_path() / "omls_probe_test";
+    const fs::path frameFolder   = folder / "compressed";
+    const std::string archive    = (folder / "frames.omlsa").string();
+    const std::string index      = (folder / "timeline.idx").string();
+    const std::uint64_t stamps[] = {1700000000300, 1700000000100, 1700000000400, 1700000000200};
+    fs::remove_all(folder);
+    fs::create_directories(frameFolder);
+
+    // Frames 0 and 1 as files, 2 and 3 in an archive; timestamps are not in frame order
+    std::vector<frame_t> frames;
+    ArchiveWriter writer;
+    check(writer.open(archive.c_str()) == BASE_SUCCESS, "archive cannot be created");
+    for(std::size_t i = 0; i < 4; i++) {
+        frame_t frame   = makeFrame(64 + 16 * i, 32, i < 2 ? 12 : 10, i + 1);
+        frame.planar    = i == 1;
+        frame.timestamp = stamps[i];
+        check(encodeFrame(frame, folder.string().c_str()), "encoding produced no output");
+        if(i < 2) {
+            char name[32];
+            std::snprintf(name, sizeof name, "img_%02zu.bin", 10 + i);
+            std::ofstream wf(frameFolder / name, std::ios::binary);
+            wf.write(frame.compressed.data(), frame.compressed.size());
+        } else {
+            writer.append(10 + i, (const std::uint8_t*)frame.compressed.data(), frame.compressed.size());
+        }
+        frames.push_back(frame);
+    }
+    check(writer.close() == BASE_SUCCESS, "archive cannot be closed");
+    std::ofstream(frameFolder / "notes.bin") << "not a frame";
+
+    Probe probe;
+    check(probe.addDirectory(frameFolder.string().c_str()) == BASE_SUCCESS, "directory cannot be added");
+    check(probe.addArchive(archive.c_str()) == BASE_SUCCESS, "archive cannot be added");
+    check(probe.run(2) == BASE_SUCCESS, "probe failed");
+    check(probe.getFailed() == 1, "file that is not a frame not counted as failed");
+
+    const std::vector<probeEntry_t>& entries = probe.getEntries();
+    check(entries.size() == 4, "wrong number of entries");
+    for(std::size_t i = 0; i < entries.size() && i < 4; i++) {
+        const probeEntry_t& entry = entries[i];
+        check(i == 0 || entries[i - 1].timestamp <= entry.timestamp, "entries not sorted by timestamp");
+        if(entry.frameId < 10 || entry.frameId > 13) {
+            check(false, "wrong frame id");
+            continue;
+        }
+        const frame_t& frame = frames[entry.frameId - 10];
+        check(entry.timestamp == frame.timestamp, "wrong timestamp");
+        check(entry.width == frame.width && entry.height == frame.height && entry.bpp == frame.bpp, "wrong format");
+        check(entry.size == frame.compressed.size(), "wrong compressed size");
+        check(!(entry.flags & OMLS_FLAG_CHANNEL_PLANAR) == !frame.planar, "wrong planar flag");
+        check((entry.frameId >= 12) == (probe.getFiles()[entry.file] == archive), "frame in wrong file");
+    }
+
+    check(probe.writeBinary(index.c_str()) == BASE_SUCCESS, "binary index cannot be written");
+    std::ifstream rf(index, std::ios::binary);
+    std::vector<char> data{std::istreambuf_iterator<char>(rf), std::istreambuf_iterator<char>()};
+    const std::size_t header = OMLS_PROBE_INDEX_MAGIC_SIZE + sizeof(std::uint64_t);
+    const std::size_t bytes  = entries.size() * sizeof(probeEntry_t);
+    check(data.size() == header + bytes, "wrong binary index size");
+    if(data.size() == header + bytes) {
+        check(std::memcmp(data.data(), OMLS_PROBE_INDEX_MAGIC, OMLS_PROBE_INDEX_MAGIC_SIZE) == 0, "wrong index magic");
+        check(std::memcmp(&data[header], entries.data(), bytes) == 0, "binary index differs from entries");
+    }
+
+    fs::remove_all(folder);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: timeline built from headers\n");
+    return 0;
+}
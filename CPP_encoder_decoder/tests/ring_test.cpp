@@ -0,0 +1,125 @@
+/*
+* Checks a frame ring between a producer and a consumer opened on the same shared memory: frames come out in
+* order, the producer is held back while the ring is full, compressed frames written through FrameSlotBuffer
+* decode, and raw slot descriptors are validated.
+*/
+#include "DecoderSession.hpp"
+#include "FrameRing.hpp"
+#include "testFrames.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+int main()
+{
+    const std::string folderOut = std::filesystem::temp_directory_path().string();
+    const char* name            = "omls_ring_test";
+    const std::uint32_t slots   = 3;
+    const frame_t frame         = makeFrame(64, 32, 10, 11);
+    const std::uint64_t rawSize = frame.samples.size() * sizeof(std::uint16_t);
+
+    FrameRing producer;
+    FrameRing consumer;
+    if(producer.create(name, slots, rawSize) || consumer.open(name)) {
+        std::printf("FAIL: ring cannot be created and opened\n");
+        FrameRing::remove(name);
+        return 1;
+    }
+    check(consumer.getSlotCount() == slots && consumer.getSlotSize() == rawSize, "consumer sees wrong ring layout");
+    check(consumer.beginRead() == nullptr, "new ring is not empty");
+
+    // Raw frames, one more than fits
+    std::size_t written = 0;
+    for(std::uint64_t id = 0; id < slots + 1; id++) {
+        frameSlot_t* pSlot = producer.beginWrite();
+        if(!pSlot) {
+            break;
+        }
+        pSlot->size      = rawSize;
+        pSlot->frameId   = id;
+        pSlot->timestamp = 1000 * id;
+        pSlot->width     = frame.width;
+        pSlot->height    = frame.height;
+        pSlot->pitch     = frame.width;
+        pSlot->bpp       = frame.bpp;
+        std::memcpy(pSlot->payload(), frame.samples.data(), rawSize);
+        producer.endWrite();
+        written++;
+    }
+    check(written == slots, "producer was not held back by a full ring");
+
+    for(std::uint64_t id = 0; id < slots; id++) {
+        const frameSlot_t* pSlot = consumer.beginRead();
+        if(!pSlot) {
+            check(false, "published frame is missing");
+            break;
+        }
+        check(pSlot->frameId == id && pSlot->timestamp == 1000 * id, "frames out of order");
+        check(isValidRawSlot(*pSlot, consumer.getSlotSize()), "valid raw slot rejected");
+        check(std::memcmp(pSlot->payload(), frame.samples.data(), rawSize) == 0, "raw payload differs");
+        consumer.endRead();
+    }
+    check(consumer.beginRead() == nullptr, "drained ring is not empty");
+
+    // Compressed frame written in place, then one that does not fit
+    frameSlot_t* pSlot = producer.beginWrite();
+    check(pSlot != nullptr, "drained ring is still full");
+    if(pSlot) {
+        frame_t compressed = frame;
+        check(encodeFrame(compressed, folderOut.c_str()), "encoding produced no output");
+        FrameSlotBuffer buffer{pSlot, producer.getSlotSize()};
+        std::ostream stream{&buffer};
+        stream.write(compressed.compressed.data(), compressed.compressed.size());
+        check(stream.good() && buffer.size() == compressed.compressed.size(), "compressed frame does not fit slot");
+        pSlot->size  = buffer.size();
+        pSlot->pitch = 0;
+        producer.endWrite();
+
+        FrameSlotBuffer small{producer.beginWrite(), 16};
+        std::ostream overflow{&small};
+        overflow.write(compressed.compressed.data(), compressed.compressed.size());
+        check(!overflow.good(), "overflowing slot buffer does not fail the stream");
+    }
+    producer.finish();
+    check(!consumer.isFinished(), "finished before all frames were read");
+
+    const frameSlot_t* pRead = consumer.beginRead();
+    check(pRead != nullptr, "compressed frame is missing");
+    if(pRead) {
+        DecoderSession session;
+        bool same = session.decode(pRead->payload(), pRead->size) == BASE_SUCCESS;
+        for(std::size_t i = 0; same && i < frame.samples.size(); i++) {
+            same = session.getOutput16bit()[i] == frame.samples[i];
+        }
+        check(same, "compressed frame from ring does not decode");
+        consumer.endRead();
+    }
+    check(consumer.isFinished(), "not finished after all frames were read");
+
+    // Raw descriptors a consumer must refuse
+    frameSlot_t slot{};
+    slot.width  = 64;
+    slot.height = 32;
+    slot.pitch  = 64;
+    slot.size   = 64 * 32 * sizeof(std::uint16_t);
+    check(isValidRawSlot(slot, slot.size), "valid descriptor rejected");
+    check(!isValidRawSlot(slot, slot.size - 1), "payload over slot size accepted");
+    slot.pitch = 60;
+    slot.size  = 60 * 32 * sizeof(std::uint16_t);
+    check(!isValidRawSlot(slot, 1 << 20), "pitch below width accepted");
+    slot.width = 40;
+    slot.pitch = 40;
+    slot.size  = 40 * 32 * sizeof(std::uint16_t);
+    check(!isValidRawSlot(slot, 1 << 20), "width not a multiple of 16 accepted");
+
+    consumer.close();
+    producer.close();
+    FrameRing::remove(name);
+    if(g_failures) {
+        return 1;
+    }
+    std::printf("PASS: frames passed through ring in order\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+* Test frames shared by the tests: synthetic BayerCFA samples, compressed in memory with the encoder settings
+* each test asks for, and a failure counter.
+*/
+#include "Cfa.hpp"
+#include "Encoder.hpp"
+#include "Image.hpp"
+#include "helpers.hpp"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if(!condition) {
+        std::printf("FAIL: %s\n", what);
+        g_failures++;
+    }
+}
+
+struct frame_t {
+    std::size_t width;
+    std::size_t height;
+    std::uint8_t bpp;
+    bool lsbFirst           = false;
+    bool planar             = false;   // channel planar format, up to 12 bpp
+    cfaPattern cfa          = cfaPattern::gbrg;
+    std::uint64_t timestamp = 0;   // header timestamp [ms], system time if 0
+    std::vector<std::uint16_t> samples;
+    std::string compressed;
+};
+
+/**
+ * @param width x @param height frame of @param bpp samples, a smooth gradient with some noise so that both short
+ * and escaped codes occur. Different for each @param seed.
+*/
+static frame_t makeFrame(std::size_t width, std::size_t height, std::uint8_t bpp, unsigned seed)
+{
+    frame_t frame{width, height, bpp};
+    frame.samples.resize(width * height);
+    const std::uint32_t maxValue = (1u << bpp) - 1;
+    for(std::size_t y = 0; y < height; y++) {
+        for(std::size_t x = 0; x < width; x++) {
+            seed                         = seed * 1103515245 + 12345;
+            std::uint64_t value          = (std::uint64_t)(x * 7 + y * 3) * maxValue / (7 * width + 3 * height);
+            value                        = value + (seed >> 16) % 32;
+            frame.samples[y * width + x] = value > maxValue ? maxValue : value;
+        }
+    }
+    return frame;
+}
+
+/**
+ * Compresses @param frame into frame.compressed. Dumps of DUMP_VERIFICATION builds go to @param folderOut.
+*/
+static bool encodeFrame(frame_t& frame, const char* folderOut)
+{
+    BayerView view{frame.samples.data(), frame.width, 0, 0, frame.width, frame.height};
+    std::ostringstream stream;
+    if(frame.planar) {
+        auto pImg_YCCC = Helpers::bayer_to_YCCC(view, 0, frame.cfa);
+        Encoder enc{pImg_YCCC.get(), folderOut, 0, 0, 24, frame.bpp, "test_"};
+        enc.setOutputStream(&stream);
+        enc.setDumpVerification(false);
+        enc.setVerbose(false);
+        enc.setBitOrderLSBFirst(frame.lsbFirst);
+        enc.setCfaPattern(frame.cfa);
+        enc.setTimestamp(frame.timestamp);
+        enc.encodeUsingMethod(Encoder::method::singleSeedInTwos);
+    } else {
+        Encoder enc{view, folderOut, 0, 32, 8, 0, C_MAX_UNARY_LENGTH, frame.bpp, 24, "test_"};
+        enc.setOutputStream(&stream);
+        enc.setDumpVerification(false);
+        enc.setVerbose(false);
+        enc.setBitOrderLSBFirst(frame.lsbFirst);
+        enc.setCfaPattern(frame.cfa);
+        enc.setTimestamp(frame.timestamp);
+        enc.encodeUsingMethod(Encoder::method::parallel_limited);
+    }
+    frame.compressed = stream.str();
+    return !frame.compressed.empty();
+}